@@ -14,7 +14,7 @@ namespace CVM
 	public:
 		explicit Compiler() {}
 
-		bool compile(InstStruct::GlobalInfo &globalinfo, const Runtime::PtrFuncMap &pfm, Runtime::FuncTable &functable);
+		bool compile(InstStruct::GlobalInfo &globalinfo, const Runtime::PtrFuncMap &pfm, const Runtime::IntrinsicMap &ifm, Runtime::FuncTable &functable);
 
 		Config::FuncIndexType getEntryID() {
 			return entry_index;
@@ -22,13 +22,14 @@ namespace CVM
 
 	private:
 		Runtime::Instruction* compile(const InstStruct::Instruction &inst, const FunctionInfo &info);
-		Runtime::InstFunction compile(const InstStruct::Function &func);
+		Runtime::InstFunction compile(Config::FuncIndexType id, const InstStruct::Function &func);
 		Config::FuncIndexType entry_index;
 	};
 
 	namespace Compile
 	{
 		Runtime::LocalEnvironment* CreateLoaclEnvironment(const Runtime::InstFunction &func, const TypeInfoMap &tim);
-		Runtime::GlobalEnvironment* CreateGlobalEnvironment(Config::RegisterIndexType dysize, const TypeInfoMap *tim, const LiteralDataPool *datasmap, const Runtime::FuncTable *functable, HashStringPool *hashStringPool);
+		Runtime::GlobalEnvironment* CreateGlobalEnvironment(Config::RegisterIndexType dysize, const std::vector<TypeIndex> &sttypelist, const TypeInfoMap *tim, const LiteralDataPool *datasmap, const Runtime::FuncTable *functable, HashStringPool *hashStringPool);
+		Runtime::ThreadEnvironment* CreateThreadEnvironment(const std::vector<TypeIndex> &sttypelist, const TypeInfoMap &tim);
 	}
 }
@@ -0,0 +1,27 @@
+// compress.h
+// * This file provides a small LZ77 block compressor (LZ4-like format)
+//   for the compressed literal data section.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace CVM
+{
+	namespace Compress
+	{
+		// The offset of a match is 16 bits, so a block is at most 64 KiB.
+		constexpr size_t MaxBlockSize = 64 * 1024;
+
+		// The max size of the compressed block.
+		inline size_t CompressBound(size_t size) {
+			return size + size / 255 + 16;
+		}
+
+		// Return the size of the compressed data written to dst (at least CompressBound(size)).
+		size_t CompressBlock(const uint8_t *src, size_t size, uint8_t *dst);
+
+		// Return false if src is corrupted or is not exactly dstsize bytes after decompressed.
+		bool DecompressBlock(const uint8_t *src, size_t srcsize, uint8_t *dst, size_t dstsize);
+	}
+}
@@ -53,5 +53,23 @@ namespace CVM
 		inline RegisterIndexType get_static_id(RegisterIndexType id, RegisterIndexType dysize, RegisterIndexType stsize) {
 			return id - 1;
 		}
+
+		// Scoped Register
+		//   The static registers of global (%g) and thread (%t) scope are declared in '.program',
+		//   the index of them is flagged by the high bits, so they're resolved by the index itself.
+
+		constexpr RegisterIndexType GlobalRegisterFlag = RegisterIndexType(1) << 31;
+		constexpr RegisterIndexType ThreadRegisterFlag = RegisterIndexType(1) << 30;
+		constexpr RegisterIndexType ScopedRegisterMask = GlobalRegisterFlag | ThreadRegisterFlag;
+
+		inline bool is_scoped(RegisterIndexType id) {
+			return (id & ScopedRegisterMask) != 0;
+		}
+		inline bool is_global(RegisterIndexType id) {
+			return (id & GlobalRegisterFlag) != 0;
+		}
+		inline RegisterIndexType get_scoped_id(RegisterIndexType id) {
+			return id & ~ScopedRegisterMask;
+		}
 	}
 }
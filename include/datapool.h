@@ -3,10 +3,14 @@
 #include <vector>
 #include <cassert>
 #include <memory>
+#include <mutex>
+#include <cstdio>
 #include "../prilib/include/lightlist.h"
 #include "../prilib/include/convert.h"
 #include "../prilib/include/explicittype.h"
 #include "config.h"
+#include "typeinfo.h"
+#include "pageprovider.h"
 #include "inststruct/filenamemap.h"
 
 namespace CVM
@@ -39,60 +43,178 @@ namespace CVM
 		return std::make_pair(FileID(converter.fileid), DataID(converter.dataid));
 	}
 
-	class LiteralDataPool
+	//--------------------------------------
+	// * LazyLiteral
+	//    The compressed data in LiteralDataPool,
+	//    decompressed on the first access (once, thread-safe).
+	//--------------------------------------
+	class LazyLiteral
 	{
-		class FlatLiteralDataPoolMap {
-		public:
-			using DataType = std::pair<MemoryIndex, MemorySize>;
+	public:
+		explicit LazyLiteral(const uint8_t *record, uint64_t recordsize, MemorySize size)
+			: _record(record), _recordsize(recordsize), _size(size) {}
+		LazyLiteral(const LazyLiteral &) = delete;
+		LazyLiteral& operator=(const LazyLiteral &) = delete;
 
-		public:
-			FlatLiteralDataPoolMap() = default;
-			FlatLiteralDataPoolMap(const FlatLiteralDataPoolMap &) = delete;
-			FlatLiteralDataPoolMap& operator=(const FlatLiteralDataPoolMap &) = delete;
+		const uint8_t* get() const {
+			std::call_once(_once, [this]() { decompress(); });
+			return _data.get();
+		}
+		MemorySize size() const {
+			return _size;
+		}
 
-			bool has(const FileDataID &filedataid) const {
-				return this->_data.find(filedataid) != this->_data.end();
-			}
-			bool insert(const FileDataID &filedataid, const DataType &data) {
-				if (!has(filedataid)) {
-					this->_data.insert({filedataid, data});
-					return true;
-				}
-				return false;
-			}
-			const DataType& operator[](const FileDataID &filedataid) const {
-				assert(has(filedataid));
-				return this->_data.at(filedataid);
-			}
+	private:
+		void decompress() const;
+
+		const uint8_t *_record;
+		uint64_t _recordsize;
+		MemorySize _size;
+		mutable std::once_flag _once;
+		mutable std::unique_ptr<uint8_t[]> _data;
+	};
 
-		private:
-			std::map<FileDataID, DataType> _data;
+	//--------------------------------------
+	// * LiteralDataPool
+	//    The pool is a self-contained section used in place,
+	//    either built in memory or mapped read-only from a file.
+	//    All the offsets are from the beginning of the section:
+	//      SectionHeader | data | SectionFile[filecount] | SectionEntry[entrycount]...
+	//      | SectionBlob[blobcount] | paths of blobs
+	//    The entries are flat arrays indexed by (dataid - 1), offset 0 means no data.
+	//    The entry of a blob (a file mapped by '.blob') has BlobFlag and the index of the blob as offset.
+	//    The entry of a compressed data has CompressedFlag and the offset of its record as offset:
+	//      uint64 blockcount | uint32 blocksize[blockcount] | blocks
+	//    Each block is CompressBlockSize bytes (except the last) before compressed,
+	//    a block whose size is not reduced is stored as is.
+	//--------------------------------------
+	class LiteralDataPool
+	{
+	public:
+		struct SectionHeader {
+			char magic[8];
+			uint32_t version;
+			uint32_t byteorder;
+			uint64_t datasize;
+			uint64_t filecount;
+			uint64_t fileoffset;
+			uint64_t totalsize;
+			uint64_t blobcount;
+			uint64_t bloboffset;
+		};
+		struct SectionFile {
+			uint64_t entryoffset;
+			uint64_t entrycount;
+		};
+		struct SectionEntry {
+			uint64_t offset;
+			uint64_t size;
 		};
+		struct SectionBlob {
+			uint64_t pathoffset;
+			uint64_t pathsize;
+			uint64_t size;
+		};
+
+		static constexpr char Magic[8] = { 'C', 'V', 'M', '-', 'L', 'D', 'S', '\0' };
+		static constexpr uint32_t Version = 1;
+		static constexpr uint32_t ByteOrder = 0x01020304;
+		static constexpr size_t DataOffset = sizeof(SectionHeader);
+		static constexpr uint64_t BlobFlag = uint64_t(1) << 63;
+		static constexpr uint64_t CompressedFlag = uint64_t(1) << 62;
+		static constexpr uint64_t CompressBlockSize = 64 * 1024;
+		// The data smaller than it is not compressed.
+		static constexpr uint64_t CompressMinSize = 256;
+
 	public:
-		explicit LiteralDataPool() : _dataPoolMap(new FlatLiteralDataPoolMap()) {}
+		explicit LiteralDataPool() = default;
 		LiteralDataPool(const LiteralDataPool &) = delete;
 		LiteralDataPool& operator=(const LiteralDataPool &) = delete;
 
 		// TODO: This function is temp.
 		std::pair<const uint8_t*, MemorySize> at(const FileDataID & filedataid) const {
-			const auto &result = (*_dataPoolMap)[filedataid];
-			return std::make_pair(_data.get(result.first.data), result.second);
+			auto ids = *filedataid;
+			return at(ids.first, ids.second);
+		}
+		std::pair<const uint8_t*, MemorySize> at(const FileID &fileid, const DataID &dataid) const {
+			assert(has(fileid, dataid));
+			const SectionEntry &entry = getEntry(fileid, dataid);
+			const uint8_t *data;
+			if (entry.offset & BlobFlag)
+				data = _blobs[entry.offset & ~BlobFlag]->data();
+			else if (entry.offset & CompressedFlag)
+				data = lazy(fileid, dataid)->get();
+			else
+				data = _base + entry.offset;
+			return std::make_pair(data, MemorySize(static_cast<MemorySize::Type>(entry.size)));
 		}
 
+		bool isCompressed(const FileID &fileid, const DataID &dataid) const {
+			assert(has(fileid, dataid));
+			return (getEntry(fileid, dataid).offset & CompressedFlag) != 0;
+		}
+		// Get the lazy literal of the compressed data, the entries of the same record share one.
+		const LazyLiteral* lazy(const FileID &fileid, const DataID &dataid) const;
+
 		bool has(const FileDataID &filedataid) const {
-			return _dataPoolMap->has(filedataid);
+			auto ids = *filedataid;
+			return has(ids.first, ids.second);
 		}
 		bool has(const FileID &fileid, const DataID &dataid) const {
-			return has((fileid, dataid));
+			if (_base == nullptr || fileid.data >= header().filecount)
+				return false;
+			const SectionFile &file = getFile(fileid);
+			if (dataid.data == 0 || dataid.data > file.entrycount)
+				return false;
+			const SectionEntry &entry = getEntry(fileid, dataid);
+			if (entry.offset & BlobFlag) {
+				uint64_t index = entry.offset & ~BlobFlag;
+				return index < _blobs.size() && entry.size == _blobs[index]->size();
+			}
+			if (entry.offset & CompressedFlag)
+				return checkRecord(entry.offset & ~CompressedFlag, entry.size);
+			return entry.offset >= DataOffset && entry.offset + entry.size <= DataOffset + header().datasize;
 		}
 
 		std::string toString() const {
-			return std::to_string(_data.size()) + ":" + PriLib::Convert::to_hex(_data.get(), _data.size());
+			size_t size = _base ? static_cast<size_t>(header().datasize) : 0;
+			return std::to_string(size) + ":" + PriLib::Convert::to_hex(_base ? _base + DataOffset : nullptr, size);
 		}
 
+		// Check the address is in the memory mapped read-only (the section loaded from a file, and the blobs).
+		bool isMapped(const void *address) const;
+		// Report the stores to the mapped memory as an error instead of a crash (SIGSEGV).
+		// The compiler rejects the stores through loadp pointers, but not through the pointers passed by call.
+		void guardMapped() const;
+
+		// Write the section to the file, the data not smaller than CompressMinSize is compressed if 'compress'.
+		bool save(const std::string &filename, bool compress = false) const;
+		// Map the section from the file read-only, and use it in place.
+		// The blobs are mapped from their paths, 'strictblob' requires them to be page-aligned and read-only.
+		bool load(const std::string &filename, bool strictblob = false);
+
 	private:
-		std::unique_ptr<FlatLiteralDataPoolMap> _dataPoolMap;
-		PriLib::lightlist<uint8_t> _data;
+		bool bind(const uint8_t *base, size_t size);
+		bool mapBlobs(bool strictblob);
+		bool checkRecord(uint64_t offset, uint64_t size) const;
+		bool saveCompressed(std::FILE *fp) const;
+
+		const SectionHeader& header() const {
+			return *reinterpret_cast<const SectionHeader*>(_base);
+		}
+		const SectionFile& getFile(const FileID &fileid) const {
+			return reinterpret_cast<const SectionFile*>(_base + header().fileoffset)[fileid.data];
+		}
+		const SectionEntry& getEntry(const FileID &fileid, const DataID &dataid) const {
+			return reinterpret_cast<const SectionEntry*>(_base + getFile(fileid).entryoffset)[dataid.data - 1];
+		}
+
+		PageProvider::PageBuffer _data;
+		PageProvider::MappedFile _file;
+		std::vector<std::unique_ptr<PageProvider::MappedFile>> _blobs;
+		const uint8_t *_base = nullptr;
+		mutable std::map<uint64_t, std::unique_ptr<LazyLiteral>> _lazys;
+		mutable std::mutex _lazymutex;
 		friend class LiteralDataPoolCreator;
 	};
 }
@@ -7,7 +7,8 @@
 
 namespace CVM::InstStruct
 {
-	using InstList = std::vector<Instruction*>; // TODO
+	// The instructions are owned by the InstArena of the file.
+	using InstList = std::vector<Instruction*>;
 	using LabelKeyTable = std::map<HashID, Config::LineCountType>;
 
 	struct Function
@@ -18,13 +19,6 @@ namespace CVM::InstStruct
 		explicit Function(Function &&func)
 			: info(std::move(func.info)), instdata(std::move(func.instdata)), labelkeytable(std::move(func.labelkeytable)) {}
 
-		~Function() {
-			// TODO
-			for (auto &p : instdata)
-				if (p)
-					delete p;
-		}
-
 		FunctionInfo info;
 		InstList instdata;
 		LabelKeyTable labelkeytable;
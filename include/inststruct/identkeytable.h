@@ -48,6 +48,12 @@ namespace CVM
 					f(pair.second, functable.at(pair.second));
 				}
 			}
+			template <typename _FTy>
+			void eachKey(_FTy f) const {
+				for (auto &pair : keytable) {
+					f(pair.first, pair.second);
+				}
+			}
 
 		private:
 			std::map<HashID, Config::FuncIndexType> keytable;
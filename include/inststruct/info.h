@@ -6,6 +6,7 @@
 #include "filenamemap.h"
 #include "identkeytable.h"
 #include <memory>
+#include <vector>
 
 namespace CVM
 {
@@ -23,11 +24,14 @@ namespace CVM
 			HashID entry;
 			HashStringPool hashStringPool;
 			DataRegisterMode dataRegisterMode = drm_multiply;
+			bool strictBlob = false;  // '.blob' requires the file to be page-aligned and read-only.
 			TypeInfoMap typeInfoMap;
 			std::unique_ptr<LiteralDataPoolCreator> literalDataPoolCreator;  // TODO: Remove from GlobalInfo
 			LiteralDataPool literalDataPool;
 			FileNameMap fileNameMap;
 			IdentKeyTable funcTable;
+			std::vector<TypeIndex> globalTypeList;  // The types of the static global registers (%g), by '.gvarb'.
+			std::vector<TypeIndex> threadTypeList;  // The types of the static thread registers (%t), by '.tvarb'.
 		};
 
 		struct FileContext {
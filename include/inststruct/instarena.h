@@ -0,0 +1,41 @@
+#pragma once
+#include <deque>
+#include <vector>
+#include <string_view>
+#include <unordered_set>
+#include "bignumber.h"
+#include "pageprovider.h"
+#include "instruction.h"
+#include "instpart.h"
+
+namespace CVM::InstStruct
+{
+	//--------------------------------------
+	// * InstArena
+	//    Holds the InstStruct of a file:
+	//    instructions, elements, interned strings (and arrays)
+	//    and the integers which are too large to be inline.
+	//    All of them are released together after compilation.
+	//--------------------------------------
+	class InstArena
+	{
+	public:
+		explicit InstArena() = default;
+		InstArena(const InstArena &) = delete;
+		InstArena& operator=(const InstArena &) = delete;
+
+		Instruction* newInstruction(InstCode instcode, const std::vector<Element> &data);
+		String::Type internString(std::string_view str);
+		ArrayData::Type internArray(const std::vector<uint8_t> &data);
+		const BigInteger* newBigInteger(BigInteger &&data);
+
+		void clear();
+
+	private:
+		std::string_view intern(const void *data, size_t size);
+
+		PageProvider::PageArena _arena;
+		std::unordered_set<std::string_view> _blobset;
+		std::deque<BigInteger> _bigintegers;
+	};
+}
@@ -2,10 +2,13 @@
 #include <cstdint>
 #include <cassert>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <bignumber.h>
 #include "config.h"
 #include "typeinfo.h"
 #include "register.h"
+#include "instruction.h"
 #include "instpart-enum.h"
 
 namespace CVM::InstStruct
@@ -21,11 +24,12 @@ namespace CVM::InstStruct
 		Type _data;
 	};
 
+	// The string is interned in InstArena.
 	struct String {
-		using Type = std::string;
+		using Type = std::string_view;
 		static constexpr ElementType elementType = ET_String;
 
-		explicit String(Type data) : _data(std::move(data)) {}
+		explicit String(Type data) : _data(data) {}
 		const Type& data() const { return _data; }
 
 	private:
@@ -54,40 +58,74 @@ namespace CVM::InstStruct
 		Type _data;
 	};
 
+	// The array is interned in InstArena.
 	struct ArrayData {
-		using Type = std::vector<uint8_t>;
+		using Type = ArrayView<uint8_t>;
 		static constexpr ElementType elementType = ET_ArrayData;
 
-		explicit ArrayData(Type data) : _data(std::move(data)) {}
+		explicit ArrayData(Type data) : _data(data) {}
 		const Type& data() const { return _data; }
 
 	private:
 		Type _data;
 	};
 
+	// The integer whose magnitude fits in 64 bits is stored inline,
+	// otherwise it is stored as BigInteger in InstArena.
 	struct IntegerData {
-		using Type = CVM::BigInteger;
 		static constexpr ElementType elementType = ET_IntegerData;
 
-		explicit IntegerData(Type data, bool has_signed_prefix)
-			: _data(std::move(data)), _has_signed_prefix(has_signed_prefix) {}
-		const Type& data() const { return _data; }
+		explicit IntegerData(uint64_t magnitude, bool negative, bool has_signed_prefix)
+			: _magnitude(magnitude), _negative(negative && magnitude != 0), _has_signed_prefix(has_signed_prefix) {}
+		explicit IntegerData(const BigInteger *large, bool has_signed_prefix)
+			: _large(large), _negative(large->is_negative()), _has_signed_prefix(has_signed_prefix) {}
 
 		bool has_signed_prefix() const { return _has_signed_prefix; }
 		bool is_negative() const {
-			return _has_signed_prefix && _data.is_negative();
+			return _has_signed_prefix && _negative;
+		}
+		bool is_inline() const { return _large == nullptr; }
+		// Get the inline integer, return false if it's too large.
+		bool get_inline(uint64_t &magnitude, bool &negative) const {
+			if (_large)
+				return false;
+			magnitude = _magnitude;
+			negative = _negative;
+			return true;
 		}
 
+		// Same as BigInteger
+		size_t size() const;
+		std::string toString(int base = 10) const;
+		std::string toStringUnsigned(int base = 10) const;
+		bool toBuffer(void *buffer, size_t memsize) const;
+		bool toBufferLSB(void *buffer, size_t memsize) const;
+		bool toBufferLSB(void *buffer, size_t memsize, bool &is_large) const;
+
 	private:
-		Type _data;
+		uint64_t _magnitude = 0;
+		const BigInteger *_large = nullptr;
+		bool _negative;
 		bool _has_signed_prefix;  // If write signed ('+' or '-') prefix
 	};
 
+	// The decimal number with '.' (e.g. 1.5, -2.0e-3).
+	struct FloatData {
+		using Type = double;
+		static constexpr ElementType elementType = ET_FloatData;
+
+		explicit FloatData(Type data) : _data(data) {}
+		const Type& data() const { return _data; }
+
+	private:
+		Type _data;
+	};
+
+	// Element is trivially copyable, so that it can be stored in InstArena.
 	struct Element {
 		explicit Element() = default;
-		explicit Element(Element &&elt) : _type(elt._type), _data(std::move(elt._data)) {}
 
-#define InstPart(key) explicit Element(key data) : _type(ET_##key), _data(std::move(data)) {}
+#define InstPart(key) explicit Element(key data) : _type(ET_##key), _data(data) {}
 #include "instpart.def"
 
 		template <typename T>
@@ -107,6 +145,9 @@ namespace CVM::InstStruct
 		void*
 		> _data;
 	};
+
+	static_assert(std::is_trivially_copyable<Element>::value, "Element must be trivially copyable.");
+	static_assert(std::is_trivially_destructible<Element>::value, "Element must be trivially destructible.");
 }
 
 
@@ -1,15 +1,36 @@
 #pragma once
+#include <cstddef>
 #include "instcode.h"
 
 namespace CVM::InstStruct
 {
 	struct Element;
 
+	// ArrayView : A view of the array stored in InstArena.
+	template <typename T>
+	struct ArrayView {
+		explicit ArrayView() = default;
+		explicit ArrayView(const T *data, size_t size) : _data(data), _size(size) {}
+
+		const T* data() const { return _data; }
+		size_t size() const { return _size; }
+		bool empty() const { return _size == 0; }
+		const T* begin() const { return _data; }
+		const T* end() const { return _data + _size; }
+		const T& operator[](size_t index) const { return _data[index]; }
+
+	private:
+		const T *_data = nullptr;
+		size_t _size = 0;
+	};
+
+	using ElementList = ArrayView<Element>;
+
 	struct Instruction final {
-		explicit Instruction(InstCode ic, std::vector<Element> data)
-			: instcode(ic), data(std::move(data)) {}
+		explicit Instruction(InstCode ic, ElementList data)
+			: instcode(ic), data(data) {}
 
 		InstCode instcode;
-		std::vector<Element> data;
+		ElementList data;
 	};
 }
@@ -202,10 +202,19 @@ namespace CVM
 			bool isPrivateDataRegister() const {
 				return is_rt_data(this->registerType) && (this->scopeType == rst_local);
 			}
+			bool isScopedDataRegister() const {
+				return is_rt_data(this->registerType) && (this->scopeType == rst_global || this->scopeType == rst_thread);
+			}
 
+			// The index of the scoped data register is flagged by its scope (Config::GlobalRegisterFlag, Config::ThreadRegisterFlag).
 			RegisterIndex::Type index() const {
-				assert(isPrivateDataRegister());
-				return std::get<DataRegisterBase>(this->data).registerIndex.data;
+				assert(isPrivateDataRegister() || isScopedDataRegister());
+				RegisterIndex::Type index = std::get<DataRegisterBase>(this->data).registerIndex.data;
+				if (this->scopeType == rst_global)
+					return index | Config::GlobalRegisterFlag;
+				if (this->scopeType == rst_thread)
+					return index | Config::ThreadRegisterFlag;
+				return index;
 			}
 		};
 	}
@@ -0,0 +1,241 @@
+// pageprovider.h
+// * This file provides the pages for the large regions of CVM
+//   (literal pool, frame memory and code buffer).
+
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace CVM
+{
+	namespace PageProvider
+	{
+		enum PageMode
+		{
+			pm_normal,   // Normal pages.
+			pm_madvise,  // Transparent huge pages by madvise(MADV_HUGEPAGE).
+			pm_hugetlb,  // Huge pages by MAP_HUGETLB, fall back to pm_madvise.
+		};
+
+		constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+		struct Pages
+		{
+			void *data = nullptr;
+			size_t size = 0;
+			PageMode mode = pm_normal;
+		};
+
+		size_t GetPageSize();
+
+		void SetMode(PageMode mode);
+		PageMode GetMode();
+		bool ParseMode(const char *str, PageMode &mode);
+
+		// The memory is cleared, and the size is rounded up to the page size.
+		Pages Allocate(size_t size);
+		void Release(const Pages &pages);
+
+		// Stats for '--stats'.
+		void BeginStats();
+		void PrintStats();
+
+		//--------------------------------------
+		// * PageBuffer
+		//    A fixed-size buffer owned in pages.
+		//--------------------------------------
+		class PageBuffer
+		{
+		public:
+			PageBuffer() = default;
+			PageBuffer(const PageBuffer &) = delete;
+			PageBuffer& operator=(const PageBuffer &) = delete;
+			PageBuffer(PageBuffer &&other) noexcept
+				: _pages(other._pages), _size(other._size) {
+				other._pages = Pages();
+				other._size = 0;
+			}
+			PageBuffer& operator=(PageBuffer &&other) noexcept {
+				if (this != &other) {
+					Release(_pages);
+					_pages = other._pages;
+					_size = other._size;
+					other._pages = Pages();
+					other._size = 0;
+				}
+				return *this;
+			}
+
+			~PageBuffer() {
+				Release(_pages);
+			}
+
+			void allocate(size_t size) {
+				Release(_pages);
+				_pages = Allocate(size);
+				_size = size;
+			}
+
+			// Resize and keep the data, the pages are reallocated (doubled)
+			// only if the capacity is not enough.
+			void resize(size_t size) {
+				if (size > _pages.size) {
+					Pages pages = Allocate(size > _pages.size * 2 ? size : _pages.size * 2);
+					if (_size != 0)
+						std::memcpy(pages.data, _pages.data, _size);
+					Release(_pages);
+					_pages = pages;
+				}
+				_size = size;
+			}
+
+			uint8_t* get(size_t index = 0) {
+				return static_cast<uint8_t*>(_pages.data) + index;
+			}
+			const uint8_t* get(size_t index = 0) const {
+				return static_cast<const uint8_t*>(_pages.data) + index;
+			}
+			size_t size() const {
+				return _size;
+			}
+
+		private:
+			Pages _pages;
+			size_t _size = 0;
+		};
+
+		//--------------------------------------
+		// * MappedFile
+		//    A file mapped read-only, the pages are shared
+		//    by all the processes mapping the same file.
+		//--------------------------------------
+		class MappedFile
+		{
+		public:
+			MappedFile() = default;
+			MappedFile(const MappedFile &) = delete;
+			MappedFile& operator=(const MappedFile &) = delete;
+
+			~MappedFile() {
+				close();
+			}
+
+			bool open(const char *filename);
+			void close();
+
+			const uint8_t* data() const {
+				return static_cast<const uint8_t*>(_data);
+			}
+			size_t size() const {
+				return _size;
+			}
+			bool contains(const void *address) const {
+				const uint8_t *p = static_cast<const uint8_t*>(address);
+				return _data != nullptr && p >= data() && p < data() + _size;
+			}
+			// The size is a multiple of the page size, and nobody has the permission to write.
+			bool isPageAlignedReadOnly() const {
+				return !_writable && _size % GetPageSize() == 0;
+			}
+
+		private:
+			void *_data = nullptr;
+			size_t _size = 0;
+			bool _writable = true;
+		};
+
+		//--------------------------------------
+		// * PageArena
+		//    Bump allocator over chunks of pages.
+		//    'free' must be called in LIFO order, and frees all memory after it.
+		//--------------------------------------
+		class PageArena
+		{
+		public:
+			explicit PageArena(size_t chunksize = HugePageSize)
+				: _chunksize(chunksize) {}
+			PageArena(const PageArena &) = delete;
+			PageArena& operator=(const PageArena &) = delete;
+
+			~PageArena() {
+				clear();
+			}
+
+			void* alloc(size_t size, size_t align = 16) {
+				size = (size + align - 1) / align * align;
+				while (true) {
+					if (_current < _chunks.size()) {
+						Chunk &chunk = _chunks[_current];
+						size_t top = (chunk.top + align - 1) / align * align;
+						if (top + size <= chunk.pages.size) {
+							void *result = static_cast<uint8_t*>(chunk.pages.data) + top;
+							chunk.top = top + size;
+							return result;
+						}
+						if (_current + 1 < _chunks.size() && _chunks[_current + 1].pages.size >= size) {
+							++_current;
+							continue;
+						}
+					}
+					Chunk chunk;
+					chunk.pages = Allocate(size > _chunksize ? size : _chunksize);
+					if (_chunks.empty()) {
+						_chunks.push_back(chunk);
+						_current = 0;
+					}
+					else {
+						_chunks.insert(_chunks.begin() + _current + 1, chunk);
+						++_current;
+					}
+				}
+			}
+
+			void free(void *ptr) {
+				uint8_t *p = static_cast<uint8_t*>(ptr);
+				for (size_t i = _current + 1; i-- > 0 && i < _chunks.size();) {
+					Chunk &chunk = _chunks[i];
+					uint8_t *base = static_cast<uint8_t*>(chunk.pages.data);
+					if (base <= p && p <= base + chunk.top) {
+						chunk.top = static_cast<size_t>(p - base);
+						for (size_t j = i + 1; j <= _current; ++j)
+							_chunks[j].top = 0;
+						_current = i;
+						return;
+					}
+				}
+				assert(false && "PageArena::free must be called in LIFO order.");
+			}
+
+			// Call f(begin, end) for each range of the allocated memory.
+			template <typename F>
+			void forEachUsed(F f) const {
+				for (size_t i = 0; i <= _current && i < _chunks.size(); ++i) {
+					const uint8_t *base = static_cast<const uint8_t*>(_chunks[i].pages.data);
+					f(base, base + _chunks[i].top);
+				}
+			}
+
+			// Release all the chunks.
+			void clear() {
+				for (auto &chunk : _chunks)
+					Release(chunk.pages);
+				_chunks.clear();
+				_current = 0;
+			}
+
+		private:
+			struct Chunk
+			{
+				Pages pages;
+				size_t top = 0;
+			};
+
+			size_t _chunksize;
+			size_t _current = 0;
+			std::vector<Chunk> _chunks;
+		};
+	}
+}
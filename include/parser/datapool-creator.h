@@ -1,7 +1,11 @@
 #pragma once
 #include "datapool.h"
 #include <mutex>
+#include <string>
+#include <cstring>
 #include <optional>
+#include <string_view>
+#include <unordered_map>
 #include "../prilib/include/memory.h"
 #include "../prilib/include/convert.h"
 
@@ -10,7 +14,8 @@ namespace CVM
 	class LiteralDataPoolMap
 	{
 	public:
-		using DataType = std::pair<MemorySize, const uint8_t*>;
+		// The size and the offset in the arena of LiteralDataPoolCreator.
+		using DataType = std::pair<MemorySize, MemoryIndex>;
 
 	public:
 		explicit LiteralDataPoolMap() {}
@@ -47,75 +52,149 @@ namespace CVM
 		std::vector<std::optional<DataType>> _data;
 	};
 
+	//--------------------------------------
+	// * LiteralDataPoolCreator
+	//    The literals are written directly into one growing arena,
+	//    the same contents are stored once and shared by the DataIDs.
+	//    The arena is laid out as the section of LiteralDataPool.
+	//--------------------------------------
 	class LiteralDataPoolCreator
 	{
 	public:
 		using DataType = LiteralDataPoolMap::DataType;
 
 	public:
-		explicit LiteralDataPoolCreator() : _dataPoolMap(new LiteralDataPoolMap()) {}
+		explicit LiteralDataPoolCreator()
+			: _top(LiteralDataPool::DataOffset), _dataPoolMap(new LiteralDataPoolMap()) {}
 		LiteralDataPoolCreator(const LiteralDataPoolCreator &) = delete;
 		LiteralDataPoolCreator& operator=(const LiteralDataPoolCreator &) = delete;
 
-		~LiteralDataPoolCreator() {
-			for (auto &data : _data_will_remove) {
-				delete[] data.second;
-			}
-		}
-
+		// Reserve the cleared space at the end of the arena.
+		// The pointer is valid until the next 'alloc', and the data is committed by 'insert'.
 		uint8_t* alloc(MemorySize size) {
 			std::lock_guard<std::mutex> lock(_alloc_mutex);
-			uint8_t *result = new uint8_t[size.data]();
-			_total_size += size;
-			_data_will_remove.push_back({size, result});
+			_arena.resize(_top.data + size.data);
+			uint8_t *result = _arena.get(_top.data);
+			std::memset(result, 0, size.data);
 			return result;
 		}
 		std::string toString() const {
-			std::string result = std::to_string(_total_size.data) + ":";
-			for (auto &data : _data_will_remove) {
-				result += PriLib::Convert::to_hex(data.second, data.first.data) + " ";
-			}
-			result.pop_back();
-			return result;
+			size_t size = _top.data - LiteralDataPool::DataOffset;
+			return std::to_string(size) + ":" + PriLib::Convert::to_hex(_arena.get(LiteralDataPool::DataOffset), size);
 		}
 		bool has(const DataID& dataid) const {
 			return _dataPoolMap->has(dataid);
 		}
-		void insert(const DataID& dataid, const DataType &data) {
-			_dataPoolMap->insert(dataid, data);
+		bool empty() const {
+			return _dataPoolMap->maxDataID().data == 0;
+		}
+		// Commit the last allocated data of the size to the DataID.
+		void insert(const DataID& dataid, MemorySize size) {
+			std::lock_guard<std::mutex> lock(_alloc_mutex);
+			assert(_top.data + size.data <= _arena.size());
+			const uint8_t *data = _arena.get(_top.data);
+			size_t hash = std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(data), size.data));
+			auto range = _contents.equal_range(hash);
+			for (auto iter = range.first; iter != range.second; ++iter) {
+				const DataType &content = iter->second;
+				if (content.first.data == size.data && std::memcmp(_arena.get(content.second.data), data, size.data) == 0) {
+					_dataPoolMap->insert(dataid, content);
+					return;
+				}
+			}
+			DataType content(size, _top);
+			_top += size;
+			_contents.emplace(hash, content);
+			_dataPoolMap->insert(dataid, content);
+		}
+
+		// Register the mapped file as the data of the DataID, the file is not copied.
+		void insertBlob(const DataID& dataid, const std::string &path, std::unique_ptr<PageProvider::MappedFile> file) {
+			std::lock_guard<std::mutex> lock(_alloc_mutex);
+			MemorySize size(file->size());
+			_dataPoolMap->insert(dataid, DataType(size, MemoryIndex(LiteralDataPool::BlobFlag | _blobs.size())));
+			_blobs.push_back(Blob { path, std::move(file) });
 		}
 
 		void mergeTo(const FileID &fileid, LiteralDataPool &result);
 
 	private:
-		MemorySize _total_size;
-		std::list<std::pair<MemorySize, uint8_t*>> _data_will_remove;
+		struct Blob {
+			std::string path;
+			std::unique_ptr<PageProvider::MappedFile> file;
+		};
+
+		PageProvider::PageBuffer _arena;
+		MemoryIndex _top;
+		std::unordered_multimap<size_t, DataType> _contents;
+		std::vector<Blob> _blobs;
 		std::unique_ptr<LiteralDataPoolMap> _dataPoolMap;
 		mutable std::mutex _alloc_mutex;
 	};
 
+	// The index is written after the data, then the arena is moved into the LiteralDataPool.
 	inline void LiteralDataPoolCreator::mergeTo(const FileID& fileid, LiteralDataPool &result) {
+		using SectionHeader = LiteralDataPool::SectionHeader;
+		using SectionFile = LiteralDataPool::SectionFile;
+		using SectionEntry = LiteralDataPool::SectionEntry;
+		using SectionBlob = LiteralDataPool::SectionBlob;
+
 		std::lock_guard<std::mutex> lock(_alloc_mutex);
-		PriLib::lightlist<uint8_t> &_data = result._data;
-		auto &_dataPoolMapReal = result._dataPoolMap;
-		// TODO
-		MemoryIndex index;
-		_data.recapacity(_total_size.data);
-		DataID dataid;
+		uint64_t datasize = _top.data - LiteralDataPool::DataOffset;
+		uint64_t filecount = uint64_t(fileid.data) + 1;
+		uint64_t entrycount = _dataPoolMap->maxDataID().data;
+		uint64_t fileoffset = (_top.data + alignof(SectionFile) - 1) / alignof(SectionFile) * alignof(SectionFile);
+		uint64_t entryoffset = fileoffset + filecount * sizeof(SectionFile);
+		uint64_t bloboffset = entryoffset + entrycount * sizeof(SectionEntry);
+		uint64_t pathoffset = bloboffset + _blobs.size() * sizeof(SectionBlob);
+		uint64_t totalsize = pathoffset;
+		for (const auto &blob : _blobs)
+			totalsize += blob.path.size();
+
+		_arena.resize(static_cast<size_t>(totalsize));
+		std::memset(_arena.get(_top.data), 0, static_cast<size_t>(totalsize - _top.data));
+
+		SectionHeader &header = *reinterpret_cast<SectionHeader*>(_arena.get());
+		std::memcpy(header.magic, LiteralDataPool::Magic, sizeof(header.magic));
+		header.version = LiteralDataPool::Version;
+		header.byteorder = LiteralDataPool::ByteOrder;
+		header.datasize = datasize;
+		header.filecount = filecount;
+		header.fileoffset = fileoffset;
+		header.totalsize = totalsize;
+		header.blobcount = _blobs.size();
+		header.bloboffset = bloboffset;
+
+		SectionFile *files = reinterpret_cast<SectionFile*>(_arena.get(static_cast<size_t>(fileoffset)));
+		files[fileid.data].entryoffset = entryoffset;
+		files[fileid.data].entrycount = entrycount;
+
+		SectionEntry *entries = reinterpret_cast<SectionEntry*>(_arena.get(static_cast<size_t>(entryoffset)));
 		for (const auto &dataid_value : *_dataPoolMap) {
-			dataid = DataID(dataid.data + 1);
 			if (dataid_value) {
 				const DataType &data = dataid_value.value();
-				uint8_t *address = _data.get(index.data);
-				PriLib::Memory::copyTo(address, data.second, data.first.data);
-				_dataPoolMapReal->insert((fileid, dataid), std::make_pair(index, data.first));
-				index += data.first;
+				entries->offset = data.second.data;
+				entries->size = data.first.data;
 			}
+			++entries;
 		}
-		_dataPoolMap.release();
-		for (auto &data : _data_will_remove) {
-			delete[] data.second;
+
+		SectionBlob *blobs = reinterpret_cast<SectionBlob*>(_arena.get(static_cast<size_t>(bloboffset)));
+		for (auto &blob : _blobs) {
+			blobs->pathoffset = pathoffset;
+			blobs->pathsize = blob.path.size();
+			blobs->size = blob.file->size();
+			std::memcpy(_arena.get(static_cast<size_t>(pathoffset)), blob.path.data(), blob.path.size());
+			pathoffset += blob.path.size();
+			result._blobs.push_back(std::move(blob.file));
+			++blobs;
 		}
-		_data_will_remove.clear();
+		_blobs.clear();
+
+		result._data = std::move(_arena);
+		result.bind(result._data.get(), result._data.size());
+		_dataPoolMap.reset();
+		_contents.clear();
+		_top = MemoryIndex(LiteralDataPool::DataOffset);
 	}
 }
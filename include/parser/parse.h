@@ -11,11 +11,16 @@
 
 namespace CVM
 {
+	namespace InstStruct { class InstArena; }
+
 	PriLib::StorePtr<ParseInfo> createParseInfo(InstStruct::GlobalInfo &ginfo);
 	void parseFile(ParseInfo &parseinfo, PriLib::TextFile &file);
 
 	bool haveError(const ParseInfo &parseinfo);
 	InstStruct::GlobalInfo& getGlobalInfo(ParseInfo &parseinfo);
+	InstStruct::InstArena& getInstArena(ParseInfo &parseinfo);
+	// Release the InstStruct of the file, call it after compilation.
+	void releaseInstStruct(ParseInfo &parseinfo);
 	bool isEndChar(ParseInfo &parseinfo, char c);
 	bool isIdentifierChar(ParseInfo &parseinfo, char c);
 	bool isIdentifierEscapePrefixChar(ParseInfo &parseinfo, char c);
@@ -0,0 +1,148 @@
+// bigint.h
+// * This file provides the values of cms#bigint.
+//   A value is an int64 inline, and is promoted to the large integer only when out of the range of int64.
+//   The large integer is immutable (so it's shared by the copies of the value),
+//   and is allocated by the collector (Collector::Alloc), or owned by the integer table (Intern).
+
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include "integer.h"
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace BigInt
+		{
+			// The limbs of GMP, 'size' is negative for the negative integer.
+			struct LargeData;
+
+			// The cleared value is 0.
+			struct alignas(8) BigIntValue {
+				int64_t small;
+				const LargeData *large;
+			};
+
+			constexpr size_t ValueSize = 16;
+
+			//--------------------------------------
+			// * Large Path
+			//--------------------------------------
+
+			void AddLarge(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs);
+			void SubLarge(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs);
+			void MulLarge(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs);
+			void DivLarge(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs);
+			void RemLarge(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs);
+			void NegLarge(BigIntValue &dst, const BigIntValue &src);
+			int CompareLarge(const BigIntValue &lhs, const BigIntValue &rhs);
+			BigIntValue FromUInt64Large(uint64_t value);
+			// Return false if the large integer is out of the range of uint64.
+			bool ToUInt64Large(const BigIntValue &src, uint64_t &result);
+			bool Parse(const std::string &word, int base, BigIntValue &result);
+			// The equal integers interned are the same value, which lives as long as the program (for the literals).
+			const BigIntValue& Intern(const BigIntValue &value);
+			std::string ToString(const BigIntValue &src, int base = 10);
+			int GetSign(const LargeData &large);
+
+			[[noreturn]] void DivideByZero();
+
+			//--------------------------------------
+			// * Small Path
+			//--------------------------------------
+
+			inline void Add(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs) {
+				int64_t result;
+				if (!lhs.large && !rhs.large && !Integer::AddOverflow(lhs.small, rhs.small, result))
+					dst = BigIntValue { result, nullptr };
+				else
+					AddLarge(dst, lhs, rhs);
+			}
+			inline void Sub(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs) {
+				int64_t result;
+				if (!lhs.large && !rhs.large && !Integer::SubOverflow(lhs.small, rhs.small, result))
+					dst = BigIntValue { result, nullptr };
+				else
+					SubLarge(dst, lhs, rhs);
+			}
+			inline void Mul(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs) {
+				int64_t result;
+				if (!lhs.large && !rhs.large && !Integer::MulOverflow(lhs.small, rhs.small, result))
+					dst = BigIntValue { result, nullptr };
+				else
+					MulLarge(dst, lhs, rhs);
+			}
+			// Truncated toward zero, the same as C++.
+			inline void Div(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs) {
+				if (!rhs.large && rhs.small == 0)
+					DivideByZero();
+				if (!lhs.large && !rhs.large && !(lhs.small == INT64_MIN && rhs.small == -1))
+					dst = BigIntValue { lhs.small / rhs.small, nullptr };
+				else
+					DivLarge(dst, lhs, rhs);
+			}
+			// The sign is the same as lhs.
+			inline void Rem(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs) {
+				if (!rhs.large && rhs.small == 0)
+					DivideByZero();
+				if (!lhs.large && !rhs.large)
+					dst = BigIntValue { rhs.small == -1 ? 0 : lhs.small % rhs.small, nullptr };
+				else
+					RemLarge(dst, lhs, rhs);
+			}
+			inline void Neg(BigIntValue &dst, const BigIntValue &src) {
+				if (!src.large && src.small != INT64_MIN)
+					dst = BigIntValue { -src.small, nullptr };
+				else
+					NegLarge(dst, src);
+			}
+			// Return -1, 0 or 1.
+			inline int Compare(const BigIntValue &lhs, const BigIntValue &rhs) {
+				if (!lhs.large && !rhs.large)
+					return lhs.small < rhs.small ? -1 : (lhs.small > rhs.small ? 1 : 0);
+				return CompareLarge(lhs, rhs);
+			}
+
+			template <typename T>
+			BigIntValue FromInteger(T value) {
+				static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(int64_t), "The type must be the builtin integer.");
+				if constexpr (std::is_unsigned<T>::value && sizeof(T) == sizeof(int64_t)) {
+					if (value > static_cast<uint64_t>(INT64_MAX))
+						return FromUInt64Large(value);
+				}
+				return BigIntValue { static_cast<int64_t>(value), nullptr };
+			}
+
+			// Saturated if out of the range of T.
+			template <typename T>
+			T ToInteger(const BigIntValue &src) {
+				static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(int64_t), "The type must be the builtin integer.");
+				using Limits = std::numeric_limits<T>;
+				if (src.large) {
+					if constexpr (std::is_unsigned<T>::value && sizeof(T) == sizeof(uint64_t)) {
+						uint64_t result;
+						if (ToUInt64Large(src, result))
+							return result;
+					}
+					return GetSign(*src.large) < 0 ? Limits::min() : Limits::max();
+				}
+				if constexpr (std::is_signed<T>::value) {
+					if (src.small < static_cast<int64_t>(Limits::min()))
+						return Limits::min();
+					if (src.small > static_cast<int64_t>(Limits::max()))
+						return Limits::max();
+				}
+				else {
+					if (src.small < 0)
+						return 0;
+					if (static_cast<uint64_t>(src.small) > static_cast<uint64_t>(Limits::max()))
+						return Limits::max();
+				}
+				return static_cast<T>(src.small);
+			}
+		}
+	}
+}
@@ -0,0 +1,47 @@
+// collector.h
+// * This file provides the collector of the runtime objects (the large data of cms#bigint, the characters of cms#string
+//   and the maps).
+//   The objects are shared by the values, which are copied by the bytes (mov, call, cpyn ...),
+//   so an object can't be freed (or reused) when a register holding it is overwritten.
+//   Instead, the objects referred by the roots (the frames, the VM stack, the memory marked by the scanner
+//   and the memory added by AddRoot) are marked conservatively, so are the objects referred by the marked
+//   ok_scanned objects, and the others are freed.
+//   The collection runs only in Alloc, so a new object must be stored in the roots before the next Alloc.
+//   The references in the roots must be aligned to the pointer (as the values are).
+
+#pragma once
+#include <cstddef>
+#include <functional>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace Collector
+		{
+			// Mark the roots out of the frames and the VM stack by MarkRange.
+			using RootScanner = std::function<void()>;
+
+			// Start collecting, the objects are never freed before it (e.g. in compiling).
+			void Enable(const RootScanner &scanner);
+
+			enum ObjectKind
+			{
+				ok_data,     // No references in the object (e.g. the characters of cms#string).
+				ok_scanned,  // The object may refer to the others (e.g. the table of cms#map).
+			};
+
+			void* Alloc(size_t size, ObjectKind kind = ok_data);
+			// Free the object which is known to be not referred (e.g. the old table of a map).
+			void Free(void *object);
+
+			// The memory out of the collector which may refer to the objects.
+			void AddRoot(const void *begin, size_t size);
+			void RemoveRoot(const void *begin);
+
+			// Mark the objects referred by the words in [begin, end).
+			void MarkRange(const void *begin, const void *end);
+			void Collect();
+		}
+	}
+}
@@ -2,7 +2,21 @@
 #include "memory.h"
 #include "register.h"
 #include "environment.h"
+#include "memorykernel.h"
+#include "vectorkernel.h"
+#include "integer.h"
+#include "bigint.h"
+#include "slice.h"
+#include "stringvalue.h"
+#include "hashmap.h"
+#include "vmstack.h"
 #include "../lcmm/include/lcmm.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 namespace CVM
 {
@@ -13,32 +27,412 @@ namespace CVM
 			std::string ToStringData(Runtime::ConstDataPointer dp, MemorySize size);
 			DataPointer Alloc(MemorySize size);
 			DataPointer AllocClear(MemorySize size);
+			DataPointer AllocFrame(MemorySize size, MemorySize align);
+			void FreeFrame(DataPointer dp);  // Frames must be freed in LIFO order.
+			// Call scan(begin, end) for the memory of the live frames (the roots of the collector).
+			void ScanFrames(void (*scan)(const void *begin, const void *end));
+			void Free(DataPointer dp);
 
 			// Move
 			void MoveRegisterDdDd(Environment &env, DataRegisterDynamic &dst, const DataRegisterDynamic &src);
 			void MoveRegisterDsDd(Environment &env, DataRegisterStatic &dst, const DataRegisterDynamic &src);
 			void MoveRegisterDdDs(Environment &env, DataRegisterDynamic &dst, const DataRegisterStatic &src, TypeIndex srctype);
-			void MoveRegisterDsDs(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src, TypeIndex srctype);
+			void MoveRegisterDsDs(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src, MemorySize srcsize);
+
+			template <MemoryKernel::SizeType _size>
+			void MoveRegisterDsDsFixed(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src) {
+				MemoryKernel::CopyFixed<_size>(dst.data.get(), src.data.get());
+			}
 
 			void MoveRegisterResDd(Environment &env, const DataRegisterDynamic &src);
-			void MoveRegisterResDs(Environment &env, const DataRegisterStatic &src, TypeIndex srctype);
+			void MoveRegisterResDs(Environment &env, const DataRegisterStatic &src, TypeIndex srctype, MemorySize srcsize);
 			void MoveRegisterDdRes(Environment &env, DataRegisterDynamic &dst, TypeIndex restype);
-			void MoveRegisterDsRes(Environment &env, DataRegisterStatic &dst, TypeIndex restype);
+			void MoveRegisterDsRes(Environment &env, DataRegisterStatic &dst, TypeIndex restype, MemorySize ressize);
 
 			// Load
-			void LoadDataDd(Environment &env, DataRegisterDynamic &dst, TypeIndex expecttype, ConstDataPointer src, MemorySize srcsize);
-			void LoadDataDs(Environment &env, DataRegisterStatic &dst, TypeIndex dsttype, ConstDataPointer src, MemorySize srcsize);
-			void LoadDataRes(Environment &env, TypeIndex restype, ConstDataPointer src, MemorySize srcsize);
+			// The sizes of the types are resolved by the compiler.
+			void LoadDataDd(Environment &env, DataRegisterDynamic &dst, TypeIndex expecttype, MemorySize expectsize, ConstDataPointer src, MemorySize srcsize);
+			void LoadDataDs(Environment &env, DataRegisterStatic &dst, MemorySize dstsize, ConstDataPointer src, MemorySize srcsize);
+
+			template <MemoryKernel::SizeType _size>
+			void LoadDataDsFixed(Environment &env, DataRegisterStatic &dst, ConstDataPointer src, MemorySize srcsize) {
+				if (srcsize.data >= _size) {
+					MemoryKernel::CopyFixed<_size>(dst.data.get(), src.get());
+				}
+				else {
+					MemoryKernel::ClearFixed<_size>(dst.data.get());
+					MemoryKernel::Copy(dst.data.get(), src.get(), srcsize.data);
+				}
+			}
+			void LoadDataRes(Environment &env, TypeIndex restype, MemorySize ressize, ConstDataPointer src, MemorySize srcsize);
 			
 			// LoadPointer
 			void LoadDataPointerDd(Environment &env, DataRegisterDynamic &dst, ConstDataPointer src);
-			void LoadDataPointerDs(Environment &env, DataRegisterStatic &dst, TypeIndex dsttype, ConstDataPointer src);
-			void LoadDataPointerRes(Environment &env, TypeIndex restype, ConstDataPointer src);
+			void LoadDataPointerDs(Environment &env, DataRegisterStatic &dst, MemorySize dstsize, ConstDataPointer src);
+			void LoadDataPointerRes(Environment &env, MemorySize ressize, ConstDataPointer src);
+
+			// Field
+			// The field is at the offset (resolved by the compiler) of the object.
+			void LoadField(Environment &env, DataRegisterStatic &dst, ConstDataPointer field, MemorySize size);
+			void StoreField(Environment &env, DataPointer field, const DataRegisterStatic &src, MemorySize size);
+
+			template <MemoryKernel::SizeType _size>
+			void LoadFieldFixed(Environment &env, DataRegisterStatic &dst, ConstDataPointer field) {
+				MemoryKernel::CopyFixed<_size>(dst.data.get(), field.get());
+			}
+			template <MemoryKernel::SizeType _size>
+			void StoreFieldFixed(Environment &env, DataPointer field, const DataRegisterStatic &src) {
+				MemoryKernel::CopyFixed<_size>(field.get(), src.data.get());
+			}
+
+			// Numeric
+			// The operands are static registers of the numeric types, accessed by memcpy.
+			template <typename T>
+			T ReadValue(const DataRegisterStatic &src) {
+				T result;
+				std::memcpy(&result, src.data.get(), sizeof(T));
+				return result;
+			}
+			template <typename T>
+			void WriteValue(DataRegisterStatic &dst, T value) {
+				std::memcpy(dst.data.get(), &value, sizeof(T));
+			}
+
+			// Float to integer is truncated and saturated (NaN to 0), others are the same as static_cast.
+			template <typename _Dst, typename _Src>
+			_Dst ConvertValue(_Src value) {
+				if constexpr (std::is_floating_point<_Src>::value && std::is_integral<_Dst>::value) {
+					if (value != value)
+						return 0;
+					if (value <= static_cast<_Src>(std::numeric_limits<_Dst>::min()))
+						return std::numeric_limits<_Dst>::min();
+					if (value >= static_cast<_Src>(std::numeric_limits<_Dst>::max()))
+						return std::numeric_limits<_Dst>::max();
+				}
+				return static_cast<_Dst>(value);
+			}
+
+			template <typename _Float, typename _Op>
+			void FloatArith(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, const DataRegisterStatic &rhs) {
+				WriteValue<_Float>(dst, _Op()(ReadValue<_Float>(lhs), ReadValue<_Float>(rhs)));
+			}
+			template <typename _Float>
+			void FloatNeg(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src) {
+				WriteValue<_Float>(dst, -ReadValue<_Float>(src));
+			}
+			// The result is 1 or 0 of the integer type _Result.
+			template <typename _Float, typename _Op, typename _Result>
+			void FloatCompare(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, const DataRegisterStatic &rhs) {
+				WriteValue<_Result>(dst, _Op()(ReadValue<_Float>(lhs), ReadValue<_Float>(rhs)) ? 1 : 0);
+			}
+			template <typename _Dst, typename _Src>
+			void Convert(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src) {
+				WriteValue<_Dst>(dst, ConvertValue<_Dst>(ReadValue<_Src>(src)));
+			}
+
+			// Integer
+			// The immediate operand (rhs) is stored in the instruction.
+			template <typename _Int, typename _Op>
+			void IntegerBinary(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, const DataRegisterStatic &rhs) {
+				WriteValue<_Int>(dst, _Op()(ReadValue<_Int>(lhs), ReadValue<_Int>(rhs)));
+			}
+			template <typename _Int, typename _Op>
+			void IntegerBinaryImm(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, _Int rhs) {
+				WriteValue<_Int>(dst, _Op()(ReadValue<_Int>(lhs), rhs));
+			}
+			template <typename _Int, typename _Op>
+			void IntegerUnary(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src) {
+				WriteValue<_Int>(dst, _Op()(ReadValue<_Int>(src)));
+			}
+			// The result is 1 or 0 of the integer type _Result.
+			template <typename _Int, typename _Op, typename _Result>
+			void IntegerCompare(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, const DataRegisterStatic &rhs) {
+				WriteValue<_Result>(dst, _Op()(ReadValue<_Int>(lhs), ReadValue<_Int>(rhs)) ? 1 : 0);
+			}
+			template <typename _Int, typename _Op, typename _Result>
+			void IntegerCompareImm(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, _Int rhs) {
+				WriteValue<_Result>(dst, _Op()(ReadValue<_Int>(lhs), rhs) ? 1 : 0);
+			}
+
+			// Vector
+			// The kernel is selected by the lane type and the vector size when compiled.
+			inline void VectorBinary(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, const DataRegisterStatic &rhs, VectorKernel::BinaryKernel kernel) {
+				kernel(dst.data.get(), lhs.data.get(), rhs.data.get());
+			}
+			inline void VectorShuffle(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src, const DataRegisterStatic &idx, VectorKernel::ShuffleKernel kernel) {
+				kernel(dst.data.get(), src.data.get(), idx.data.get());
+			}
+			inline void VectorReduce(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src, VectorKernel::ReduceKernel kernel) {
+				kernel(dst.data.get(), src.data.get());
+			}
+
+			// BigInt
+			// The operands are static registers of cms#bigint, except the other side of the compare and the convert.
+			template <void (*_func)(BigInt::BigIntValue&, const BigInt::BigIntValue&, const BigInt::BigIntValue&)>
+			void BigIntBinary(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, const DataRegisterStatic &rhs) {
+				BigInt::BigIntValue result;
+				_func(result, ReadValue<BigInt::BigIntValue>(lhs), ReadValue<BigInt::BigIntValue>(rhs));
+				WriteValue(dst, result);
+			}
+			inline void BigIntNeg(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src) {
+				BigInt::BigIntValue result;
+				BigInt::Neg(result, ReadValue<BigInt::BigIntValue>(src));
+				WriteValue(dst, result);
+			}
+			// The result is -1, 0 or 1 of the signed integer type _Result.
+			template <typename _Result>
+			void BigIntCompare(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, const DataRegisterStatic &rhs) {
+				WriteValue<_Result>(dst, static_cast<_Result>(BigInt::Compare(ReadValue<BigInt::BigIntValue>(lhs), ReadValue<BigInt::BigIntValue>(rhs))));
+			}
+			template <typename _Src>
+			void BigIntFromInteger(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src) {
+				WriteValue(dst, BigInt::FromInteger(ReadValue<_Src>(src)));
+			}
+			template <typename _Dst>
+			void BigIntToInteger(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src) {
+				WriteValue(dst, BigInt::ToInteger<_Dst>(ReadValue<BigInt::BigIntValue>(src)));
+			}
+
+			// Slice
+			// The length and the index are static registers of cms#int64 or cms#uint64, read as uint64
+			// (so the negative one is out of range).
+			// The element size is resolved by the compiler, the checked access also checks the element type.
+			inline void MakeSlice(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &ptr, const DataRegisterStatic &len, TypeIndex elemtype) {
+				uint64_t length = ReadValue<uint64_t>(len);
+				if (length > std::numeric_limits<Config::MemoryCountType>::max())
+					Slice::LengthOutOfRange(length);
+				WriteValue(dst, Slice::SliceValue { ReadValue<uint8_t*>(ptr), static_cast<Config::MemoryCountType>(length), elemtype.data });
+			}
+			inline void SliceLength(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &slice) {
+				WriteValue<uint64_t>(dst, ReadValue<Slice::SliceValue>(slice).length);
+			}
+			template <bool _checked>
+			uint8_t* GetSliceElement(const DataRegisterStatic &slice, const DataRegisterStatic &index, TypeIndex elemtype, MemorySize elemsize) {
+				Slice::SliceValue value = ReadValue<Slice::SliceValue>(slice);
+				uint64_t i = ReadValue<uint64_t>(index);
+				if (_checked) {
+					if (value.elemtype != elemtype.data)
+						Slice::ElementTypeMismatch(value.elemtype, elemtype.data);
+					if (i >= value.length)
+						Slice::IndexOutOfRange(i, value.length);
+				}
+				return value.data + i * elemsize.data;
+			}
+			template <bool _checked>
+			void LoadElement(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &slice, const DataRegisterStatic &index, TypeIndex elemtype, MemorySize size) {
+				MemoryKernel::Copy(dst.data.get(), GetSliceElement<_checked>(slice, index, elemtype, size), size.data);
+			}
+			template <bool _checked>
+			void StoreElement(Environment &env, const DataRegisterStatic &slice, const DataRegisterStatic &index, const DataRegisterStatic &src, TypeIndex elemtype, MemorySize size) {
+				MemoryKernel::Copy(GetSliceElement<_checked>(slice, index, elemtype, size), src.data.get(), size.data);
+			}
+			template <bool _checked, MemoryKernel::SizeType _size>
+			void LoadElementFixed(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &slice, const DataRegisterStatic &index, TypeIndex elemtype) {
+				MemoryKernel::CopyFixed<_size>(dst.data.get(), GetSliceElement<_checked>(slice, index, elemtype, MemorySize(_size)));
+			}
+			template <bool _checked, MemoryKernel::SizeType _size>
+			void StoreElementFixed(Environment &env, const DataRegisterStatic &slice, const DataRegisterStatic &index, const DataRegisterStatic &src, TypeIndex elemtype) {
+				MemoryKernel::CopyFixed<_size>(GetSliceElement<_checked>(slice, index, elemtype, MemorySize(_size)), src.data.get());
+			}
+
+			// String
+			// The operands are static registers of cms#string, except the integers (of cms#int64 or cms#uint64 for the range,
+			// resolved by the compiler for the result of the compare).
+			inline void StringConcat(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, const DataRegisterStatic &rhs) {
+				String::StringValue result;
+				String::Concat(result, ReadValue<String::StringValue>(lhs), ReadValue<String::StringValue>(rhs));
+				WriteValue(dst, result);
+			}
+			// The result is -1, 0 or 1 of the signed integer type _Result.
+			template <typename _Result>
+			void StringCompare(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &lhs, const DataRegisterStatic &rhs) {
+				WriteValue<_Result>(dst, static_cast<_Result>(String::Compare(ReadValue<String::StringValue>(lhs), ReadValue<String::StringValue>(rhs))));
+			}
+			inline void StringHash(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src) {
+				WriteValue<uint64_t>(dst, String::Hash(ReadValue<String::StringValue>(src)));
+			}
+			inline void StringLength(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src) {
+				WriteValue<uint64_t>(dst, String::GetLength(ReadValue<String::StringValue>(src)));
+			}
+			inline void StringSub(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src, const DataRegisterStatic &start, const DataRegisterStatic &len) {
+				String::StringValue result;
+				String::Substring(result, ReadValue<String::StringValue>(src), ReadValue<uint64_t>(start), ReadValue<uint64_t>(len));
+				WriteValue(dst, result);
+			}
+			inline void StringIntern(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src) {
+				WriteValue(dst, String::Intern(ReadValue<String::StringValue>(src)));
+			}
+
+			// Map
+			// The key and the value are static registers, their types are checked with the map on execution.
+			// The capacity (cms#int64 or cms#uint64) is optional.
+			inline void MakeMap(Environment &env, DataRegisterStatic &dst, const HashMap::MapType &type, const DataRegisterStatic *capacity) {
+				int64_t cap = capacity ? ReadValue<int64_t>(*capacity) : 0;
+				WriteValue(dst, HashMap::Create(type, cap < 0 ? 0 : static_cast<uint64_t>(cap)));
+			}
+			inline HashMap::MapData& GetMap(const DataRegisterStatic &map, const HashMap::MapType &type) {
+				HashMap::MapData *result = ReadValue<HashMap::MapData*>(map);
+				HashMap::Check(result, type.keytype, type.valtype);
+				return *result;
+			}
+			inline void MapPut(Environment &env, const DataRegisterStatic &map, const DataRegisterStatic &key, const DataRegisterStatic &val, const HashMap::MapType &type) {
+				void *value = HashMap::FindOrInsert(GetMap(map, type), key.data.get());
+				MemoryKernel::Copy(value, val.data.get(), type.valsize);
+			}
+			// The value is cleared if not found, and the result is 1 or 0 of the integer type _Found.
+			template <typename _Found>
+			void MapGet(Environment &env, DataRegisterStatic &found, DataRegisterStatic &val, const DataRegisterStatic &map, const DataRegisterStatic &key, const HashMap::MapType &type) {
+				const void *value = HashMap::Find(GetMap(map, type), key.data.get());
+				if (value)
+					MemoryKernel::Copy(val.data.get(), value, type.valsize);
+				else
+					MemoryKernel::Clear(val.data.get(), type.valsize);
+				WriteValue<_Found>(found, value ? 1 : 0);
+			}
+			inline void MapErase(Environment &env, const DataRegisterStatic &map, const DataRegisterStatic &key, const HashMap::MapType &type) {
+				HashMap::Erase(GetMap(map, type), key.data.get());
+			}
+			// pos (cms#int64) is the position to start, and is set to the one after the element found, or -1 if no more.
+			inline void MapNext(Environment &env, DataRegisterStatic &pos, DataRegisterStatic &key, DataRegisterStatic &val, const DataRegisterStatic &map, const HashMap::MapType &type) {
+				const HashMap::MapData &data = GetMap(map, type);
+				int64_t start = ReadValue<int64_t>(pos);
+				const void *k, *v;
+				uint64_t next = start < 0 ? HashMap::NotFound : HashMap::Next(data, static_cast<uint64_t>(start), k, v);
+				if (next == HashMap::NotFound) {
+					WriteValue<int64_t>(pos, -1);
+					return;
+				}
+				MemoryKernel::Copy(key.data.get(), k, type.keysize);
+				MemoryKernel::Copy(val.data.get(), v, type.valsize);
+				WriteValue<int64_t>(pos, static_cast<int64_t>(next + 1));
+			}
+			inline void MapSize(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &map) {
+				HashMap::MapData *data = ReadValue<HashMap::MapData*>(map);
+				WriteValue<uint64_t>(dst, data ? HashMap::Size(*data) : 0);
+			}
+
+			// Bulk
+			// The operand is the memory pointed by the register if indirect (cms#pointer), otherwise the register itself.
+			// The count is read from the register (cms#int64 or cms#uint64) if not null, otherwise it's the immediate.
+			inline void* GetBulkAddress(const DataRegisterStatic &reg, bool indirect) {
+				return indirect ? ReadValue<void*>(reg) : reg.data.get();
+			}
+			inline uint64_t GetBulkCount(const DataRegisterStatic *countreg, uint64_t count) {
+				return countreg ? ReadValue<uint64_t>(*countreg) : count;
+			}
+			// Copy size bytes, dst and src may overlap.
+			inline void CopyN(Environment &env, void *dst, const void *src, uint64_t size) {
+				MemoryKernel::Move(dst, src, static_cast<MemoryKernel::SizeType>(size));
+			}
+			[[noreturn]] void BulkSizeOverflow(uint64_t count, MemorySize valsize);
+			// Store the value of val to dst for count times.
+			// The count of a register is unchecked by the compiler, so count * valsize may overflow.
+			inline void FillN(Environment &env, void *dst, const DataRegisterStatic &val, MemorySize valsize, uint64_t count) {
+				if (count > std::numeric_limits<uint64_t>::max() / valsize.data)
+					BulkSizeOverflow(count, valsize);
+				MemoryKernel::Fill(dst, val.data.get(), valsize.data, count);
+			}
+
+			// Stack
+			// The stack registers are resolved to the offset from the top of the VM stack by the compiler,
+			// the space is released after use if _release (%sp(n)!).
+			inline uint8_t* GetStackAddress(Config::StackOffsetType offset) {
+				return VMStack::Top() + offset;
+			}
+			inline void StackAllocate(Environment &env, uint64_t size) {
+				VMStack::Allocate(static_cast<size_t>(size));
+			}
+			inline void StackRelease(Environment &env, uint64_t size) {
+				VMStack::Release(static_cast<size_t>(size));
+			}
+			inline void LoadStackPointer(Environment &env, DataRegisterStatic &dst, Config::StackOffsetType offset) {
+				WriteValue<void*>(dst, GetStackAddress(offset));
+			}
+			template <bool _release>
+			void LoadStack(Environment &env, DataRegisterStatic &dst, Config::StackOffsetType offset, MemorySize size) {
+				MemoryKernel::Copy(dst.data.get(), GetStackAddress(offset), size.data);
+				if (_release)
+					VMStack::Release(size.data);
+			}
+			template <bool _release>
+			void StoreStack(Environment &env, Config::StackOffsetType offset, const DataRegisterStatic &src, MemorySize size) {
+				MemoryKernel::Copy(GetStackAddress(offset), src.data.get(), size.data);
+				if (_release)
+					VMStack::Release(size.data);
+			}
+			template <bool _release, MemoryKernel::SizeType _size>
+			void LoadStackFixed(Environment &env, DataRegisterStatic &dst, Config::StackOffsetType offset) {
+				MemoryKernel::CopyFixed<_size>(dst.data.get(), GetStackAddress(offset));
+				if (_release)
+					VMStack::Release(_size);
+			}
+			template <bool _release, MemoryKernel::SizeType _size>
+			void StoreStackFixed(Environment &env, Config::StackOffsetType offset, const DataRegisterStatic &src) {
+				MemoryKernel::CopyFixed<_size>(GetStackAddress(offset), src.data.get());
+				if (_release)
+					VMStack::Release(_size);
+			}
+
+			// Atomic
+			// The object is a static global register of the integer type or cms#pointer (void*),
+			// accessed as std::atomic, so the operations are the hardware atomics.
+			template <typename T>
+			std::atomic<T>& GetAtomic(DataRegisterStatic &obj) {
+				static_assert(sizeof(std::atomic<T>) == sizeof(T) && alignof(std::atomic<T>) == alignof(T), "The atomic must be the same layout as the value.");
+				return *reinterpret_cast<std::atomic<T>*>(obj.data.get());
+			}
+			template <typename T>
+			void AtomicLoad(Environment &env, DataRegisterStatic &dst, DataRegisterStatic &obj, std::memory_order order) {
+				WriteValue<T>(dst, GetAtomic<T>(obj).load(order));
+			}
+			template <typename T>
+			void AtomicStore(Environment &env, DataRegisterStatic &obj, const DataRegisterStatic &src, std::memory_order order) {
+				GetAtomic<T>(obj).store(ReadValue<T>(src), order);
+			}
+			// dst is the value before the addition.
+			template <typename T>
+			void AtomicFetchAdd(Environment &env, DataRegisterStatic &dst, DataRegisterStatic &obj, const DataRegisterStatic &val, std::memory_order order) {
+				WriteValue<T>(dst, GetAtomic<T>(obj).fetch_add(ReadValue<T>(val), order));
+			}
+			// Store desired if the value is expected, otherwise load the value to expected.
+			// ok (cms#int64 or cms#uint64) is 1 if stored, otherwise 0.
+			template <typename T>
+			void AtomicCompareExchange(Environment &env, DataRegisterStatic &ok, DataRegisterStatic &obj, DataRegisterStatic &expected, const DataRegisterStatic &desired, std::memory_order order) {
+				T value = ReadValue<T>(expected);
+				bool success = GetAtomic<T>(obj).compare_exchange_strong(value, ReadValue<T>(desired), order);
+				if (!success)
+					WriteValue<T>(expected, value);
+				WriteValue<int64_t>(ok, success ? 1 : 0);
+			}
+
+			// Switch
+			// Return the line of the case of the value, or defaultline if there's no case of it.
+			// The table is indexed by (value - min), the keys are sorted.
+			template <typename _Int>
+			Config::LineCountType SwitchTable(const DataRegisterStatic &val, _Int min, const std::vector<Config::LineCountType> &table, Config::LineCountType defaultline) {
+				using Unsigned = std::make_unsigned_t<_Int>;
+				Unsigned index = static_cast<Unsigned>(static_cast<Unsigned>(ReadValue<_Int>(val)) - static_cast<Unsigned>(min));
+				return index < table.size() ? table[index] : defaultline;
+			}
+			template <typename _Int>
+			Config::LineCountType SwitchSearch(const DataRegisterStatic &val, const std::vector<_Int> &keys, const std::vector<Config::LineCountType> &lines, Config::LineCountType defaultline) {
+				_Int value = ReadValue<_Int>(val);
+				auto iter = std::lower_bound(keys.begin(), keys.end(), value);
+				return iter != keys.end() && *iter == value ? lines[iter - keys.begin()] : defaultline;
+			}
 
 			void CallDds(Environment &env, Config::RegisterIndexType dst, Config::FuncIndexType fid, const PriLib::lightlist<Config::RegisterIndexType> &arglist);
 			void CallRes(Environment &env, Config::FuncIndexType fid, const PriLib::lightlist<Config::RegisterIndexType> &arglist);
 			void CallZero(Environment &env, Config::FuncIndexType fid, const PriLib::lightlist<Config::RegisterIndexType> &arglist);
 
+			// The arguments are the static registers, dst is nullptr if the result register is %0.
+			inline void CallIntrinsic(Environment &env, IntrinsicFunction::Func *func, DataRegisterStatic *dst, const Config::RegisterIndexType *args, size_t argcount) {
+				DataPointer argp[IntrinsicFunction::MaxArgumentCount];
+				for (size_t i = 0; i != argcount; ++i)
+					argp[i] = env.get_stvarb(args[i]).data;
+				func(dst ? dst->data : DataPointer(nullptr), argp);
+			}
+
 			// Debug
 			void Debug_PrintRegister(Environment &env, const DataRegisterDynamic &src);
 			void Debug_PrintRegister(Environment &env, const DataRegisterStatic &src, TypeIndex type);
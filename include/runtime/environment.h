@@ -4,6 +4,7 @@
 #include "controlflow.h"
 #include "datapool.h"
 #include "functable.h"
+#include "vmstack.h"
 #include <set>
 #include <list>
 #include <memory>
@@ -46,6 +47,8 @@ namespace CVM
 			virtual void addSubEnvironment(Environment *envp) {
 				envp->SetGEnv(_genv);
 				envp->SetPEnv(this);
+				if (_tenv)
+					envp->SetTEnv(_tenv);
 				std::shared_ptr<Environment> env(envp);
 				_subenv_set.add(env);
 			}
@@ -73,8 +76,12 @@ namespace CVM
 				return getDataRegisterSet().get_dynamic(index);
 			}
 			DataRegisterStatic& get_stvarb(Config::RegisterIndexType index) {
+				if (Config::is_scoped(index))
+					return get_scoped_stvarb(index);
 				return getDataRegisterSet().get_static(index);
 			}
+			// The static register of the global (%g) or thread (%t) environment.
+			DataRegisterStatic& get_scoped_stvarb(Config::RegisterIndexType index);
 			DataRegisterSet& getDataRegisterSet() {
 				return _dataRegisterSet;
 			}
@@ -99,6 +106,13 @@ namespace CVM
 				assert(_genv == nullptr);
 				_genv = genv;
 			}
+			Environment& TEnv() const {
+				return *_tenv;
+			}
+			void SetTEnv(Environment *tenv) {
+				assert(_tenv == nullptr);
+				_tenv = tenv;
+			}
 			virtual const TypeInfoMap& getTypeInfoMap() const;
 
 		protected:
@@ -174,11 +188,16 @@ namespace CVM
 				: Environment(drs) {}
 		};
 
+		inline DataRegisterStatic& Environment::get_scoped_stvarb(Config::RegisterIndexType index) {
+			Environment &env = Config::is_global(index) ? static_cast<Environment&>(GEnv()) : TEnv();
+			return env.getDataRegisterSet().get_static(Config::get_scoped_id(index));
+		}
+
 		class LocalEnvironment : public Environment
 		{
 		public:
 			explicit LocalEnvironment(const DataRegisterSet &drs, const InstFunction &func)
-				: Environment(drs), _func(func), _controlflow(_func) {}
+				: Environment(drs), _func(func), _controlflow(_func), _callerstackbase(VMStack::Enter()) {}
 
 			ControlFlow& Controlflow() {
 				return _controlflow;
@@ -188,8 +207,14 @@ namespace CVM
 				return true;
 			}
 
+			// The VM stack base of the caller, restored when the function returns.
+			uint8_t* callerStackBase() const {
+				return _callerstackbase;
+			}
+
 			InstFunction _func;
 			ControlFlow _controlflow;
+			uint8_t *_callerstackbase;
 		};
 	}
 }
@@ -20,5 +20,6 @@ namespace CVM
 			}
 		};
 		using PtrFuncMap = std::map<HashID, Runtime::PointerFunction::Func*>;
+		using IntrinsicMap = std::map<HashID, Runtime::IntrinsicFunction>;
 	}
 }
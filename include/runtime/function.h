@@ -4,6 +4,7 @@
 #include "instruction.h"
 #include "datapointer.h"
 #include "funcinfo.h"
+#include "typebase.h"
 
 namespace CVM
 {
@@ -34,8 +35,8 @@ namespace CVM
 		public:
 			explicit InstFunction() = default;
 
-			explicit InstFunction(InstList &&il, Info &&info)
-				: _data(std::move(il)), _info(std::move(info)) {}
+			explicit InstFunction(InstList &&il, Info &&info, Config::FuncIndexType id)
+				: _data(std::move(il)), _info(std::move(info)), _id(id) {}
 
 			//explicit InstFunction(const InstList &il, const Info &info)
 			//	: _data(il), _info(info) {}
@@ -65,9 +66,14 @@ namespace CVM
 				return _info;
 			}
 
+			Config::FuncIndexType id() const {
+				return _id;
+			}
+
 		private:
 			InstList _data;
 			Info _info;
+			Config::FuncIndexType _id = 0;
 		};
 
 		class PointerFunction : public Function
@@ -91,5 +97,23 @@ namespace CVM
 		private:
 			std::function<Func> _data;
 		};
+
+		//--------------------------------------
+		// * IntrinsicFunction
+		//    The native function called with the data of the static registers directly,
+		//    without creating the argument list. It's resolved when the call is compiled,
+		//    and the types of the registers are checked by the compiler.
+		//--------------------------------------
+		struct IntrinsicFunction
+		{
+			static constexpr size_t MaxArgumentCount = 4;
+			using Func = void(DataPointer result, const DataPointer *args);
+
+			Func *func;
+			TypeInside restype;  // T_Void if there is no result (the result register must be %0).
+			size_t argcount;
+			TypeInside argtypes[MaxArgumentCount];
+			unsigned storeargs = 0;  // The bits of the arguments whose data (by pointer or slice) is written.
+		};
 	}
 }
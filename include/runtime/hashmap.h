@@ -0,0 +1,55 @@
+// hashmap.h
+// * This file provides the values of cms#map.
+//   The map is an open addressing hash table (Swiss table): the control bytes (7 bits of the hash)
+//   of a group of slots are matched at once, and the keys are compared only for the matched slots.
+//   The keys and the values are of fixed sizes (from TypeInfo), in the slots allocated by the collector,
+//   so the map is freed when no value refers to it.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "config.h"
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace HashMap
+		{
+			// The keys are compared by the bytes, except cms#string (by the characters).
+			struct MapType {
+				Config::TypeIndexType keytype;
+				Config::TypeIndexType valtype;
+				size_t keysize;
+				size_t valsize;
+				size_t valalign;
+				bool stringkey;
+			};
+
+			struct MapData;
+
+			// The value of cms#map is the pointer to MapData,
+			// the cleared value (nullptr) must be created by mkmap before used.
+			constexpr size_t ValueSize = sizeof(MapData*);
+
+			constexpr uint64_t NotFound = UINT64_MAX;
+
+			// The capacity is the count of elements that can be inserted without growing.
+			MapData* Create(const MapType &type, uint64_t capacity);
+			// Check the map is created with the types, or exit with error.
+			// The value type is not checked if it's T_Void (for the access of only the key).
+			void Check(const MapData *map, Config::TypeIndexType keytype, Config::TypeIndexType valtype);
+
+			// Return the value of the key, or nullptr.
+			void* Find(const MapData &map, const void *key);
+			// Return the value of the key, inserted (cleared) if not found.
+			void* FindOrInsert(MapData &map, const void *key);
+			// Return false if not found.
+			bool Erase(MapData &map, const void *key);
+			uint64_t Size(const MapData &map);
+			// Return the position of the first element from 'pos' (in the order of the slots), or NotFound.
+			// The positions are invalidated by the insertion.
+			uint64_t Next(const MapData &map, uint64_t pos, const void *&key, const void *&value);
+		}
+	}
+}
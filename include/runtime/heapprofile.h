@@ -0,0 +1,61 @@
+#pragma once
+#include <string>
+#include <limits>
+#include "config.h"
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		//--------------------------------------
+		// * HeapProfile
+		//    Attribute runtime allocations to the function and instruction
+		//    which caused them. Enabled by '--heap-profile[=file]'.
+		//    The report is written at exit, or on SIGUSR1 (as 'file.N'),
+		//    in pprof raw heap profile format.
+		//--------------------------------------
+
+		namespace HeapProfile
+		{
+			enum AllocKind
+			{
+				ak_data,
+				ak_frame,
+				ak_arglist,
+			};
+
+			struct Site
+			{
+				static constexpr Config::FuncIndexType NoFunc = std::numeric_limits<Config::FuncIndexType>::max();
+
+				Config::FuncIndexType func = NoFunc;
+				Config::LineCountType line = 0;
+			};
+
+			extern bool Enabled;
+			extern Site CurrentSite;
+
+			inline bool IsEnabled() {
+				return Enabled;
+			}
+			inline void SetSite(Config::FuncIndexType func, Config::LineCountType line) {
+				CurrentSite.func = func;
+				CurrentSite.line = line;
+			}
+			inline void ClearSite() {
+				CurrentSite = Site();
+			}
+
+			void Enable(const std::string &filename);
+			void SetFuncName(Config::FuncIndexType func, const std::string &name);
+
+			// Only the address is recorded, the memory may be uninitialized.
+			void RecordAlloc(void *ptr, Config::MemorySizeType size, AllocKind kind);
+			void RecordFree(const void *ptr);
+
+			// Dump the report if SIGUSR1 is received.
+			void CheckSignal();
+			void Dump();
+		}
+	}
+}
@@ -78,15 +78,26 @@ namespace CVM
 				}
 			};
 			struct MoveRegisterDsDs : public MoveRegisterDD {
-				TypeIndex srctype;
+				MemorySize srcsize;
 
-				MoveRegisterDsDs(Config::RegisterIndexType dst, Config::RegisterIndexType src, TypeIndex srctype)
-					: MoveRegisterDD(dst, src), srctype(srctype) {}
+				MoveRegisterDsDs(Config::RegisterIndexType dst, Config::RegisterIndexType src, MemorySize srcsize)
+					: MoveRegisterDD(dst, src), srcsize(srcsize) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
 						println("Do Inst <MoveRegisterDsDs> ", to_string(dst), " -> ", to_string(src));
-					DataManage::MoveRegisterDsDs(env, env.get_stvarb(dst), env.get_stvarb(src), srctype);
+					DataManage::MoveRegisterDsDs(env, env.get_stvarb(dst), env.get_stvarb(src), srcsize);
+				}
+			};
+			template <MemoryKernel::SizeType _size>
+			struct MoveRegisterDsDsFixed : public MoveRegisterDD {
+				MoveRegisterDsDsFixed(Config::RegisterIndexType dst, Config::RegisterIndexType src)
+					: MoveRegisterDD(dst, src) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <MoveRegisterDsDsFixed", _size, "> ", to_string(dst), " -> ", to_string(src));
+					DataManage::MoveRegisterDsDsFixed<_size>(env, env.get_stvarb(dst), env.get_stvarb(src));
 				}
 			};
 
@@ -109,14 +120,15 @@ namespace CVM
 			};
 			struct MoveRegisterResDs : public MoveRegisterResD {
 				TypeIndex srctype;
+				MemorySize srcsize;
 
-				MoveRegisterResDs(Config::RegisterIndexType src, TypeIndex srctype)
-					: MoveRegisterResD(src), srctype(srctype) {}
+				MoveRegisterResDs(Config::RegisterIndexType src, TypeIndex srctype, MemorySize srcsize)
+					: MoveRegisterResD(src), srctype(srctype), srcsize(srcsize) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
 						println("Do Inst <MoveRegisterResDs> ", to_string(src));
-					DataManage::MoveRegisterResDs(env, env.get_stvarb(src), srctype);
+					DataManage::MoveRegisterResDs(env, env.get_stvarb(src), srctype, srcsize);
 				}
 			};
 
@@ -138,13 +150,15 @@ namespace CVM
 				}
 			};
 			struct MoveRegisterDsRes : public MoveRegisterDRes {
-				MoveRegisterDsRes(Config::RegisterIndexType dst, TypeIndex restype)
-					: MoveRegisterDRes(dst, restype) {}
+				MemorySize ressize;
+
+				MoveRegisterDsRes(Config::RegisterIndexType dst, TypeIndex restype, MemorySize ressize)
+					: MoveRegisterDRes(dst, restype), ressize(ressize) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
 						println("Do Inst <MoveRegisterDsRes> ", to_string(dst));
-					DataManage::MoveRegisterDsRes(env, env.get_stvarb(dst), restype);
+					DataManage::MoveRegisterDsRes(env, env.get_stvarb(dst), restype, ressize);
 				}
 			};
 		}
@@ -158,76 +172,142 @@ namespace CVM
 			template <size_t _subid>
 			struct LoadData;
 			
+			// The immediate is encoded by the compiler as the value of the type (in native byte order).
+			struct ImmediateData {
+				alignas(8) uint8_t data[8] = {};
+				MemorySize size = MemorySize(0);
+			};
+
 			template <>
 			struct LoadData<1> : public Instruction {
-				using DataType = InstStruct::Data::Type;
+				using DataType = ImmediateData;
 				TypeIndex dsttype;
+				MemorySize dstsize;
 				DataType data;
 
-				LoadData(TypeIndex dsttype, DataType data)
-					: dsttype(dsttype), data(data) {}
+				LoadData(TypeIndex dsttype, MemorySize dstsize, DataType data)
+					: dsttype(dsttype), dstsize(dstsize), data(data) {}
 
 			protected:
 				ConstDataPointer get_datapointer(Environment &env) const {
-					return ConstDataPointer(&data);
+					return ConstDataPointer(data.data);
 				}
 				MemorySize get_memorysize(Environment &env) const {
-					return MemorySize(sizeof(DataType));
+					return data.size;
 				}
 			};
+			// The data label is resolved to the address and size in LiteralDataPool by the compiler.
 			template <>
 			struct LoadData<2> : public Instruction {
-				using DataType = InstStruct::DataLabel::Type;
+				using DataType = std::pair<const uint8_t*, MemorySize>;
+				TypeIndex dsttype;
+				MemorySize dstsize;
+				DataType data;
+
+				LoadData(TypeIndex dsttype, MemorySize dstsize, DataType data)
+					: dsttype(dsttype), dstsize(dstsize), data(data) {}
+
+			protected:
+				ConstDataPointer get_datapointer(Environment &env) const {
+					return ConstDataPointer(data.first);
+				}
+				MemorySize get_memorysize(Environment &env) const {
+					return data.second;
+				}
+			};
+			// The compressed data label is resolved to the lazy literal, decompressed by the first load.
+			template <>
+			struct LoadData<3> : public Instruction {
+				using DataType = const LazyLiteral*;
+				TypeIndex dsttype;
+				MemorySize dstsize;
+				DataType data;
+
+				LoadData(TypeIndex dsttype, MemorySize dstsize, DataType data)
+					: dsttype(dsttype), dstsize(dstsize), data(data) {}
+
+			protected:
+				ConstDataPointer get_datapointer(Environment &env) const {
+					return ConstDataPointer(data->get());
+				}
+				MemorySize get_memorysize(Environment &env) const {
+					return data->size();
+				}
+			};
+			// The compressed string literal is resolved to the lazy literal,
+			// the value (referring to the decompressed data) is created by the first load.
+			template <>
+			struct LoadData<4> : public Instruction {
+				using DataType = const LazyLiteral*;
 				TypeIndex dsttype;
+				MemorySize dstsize;
 				DataType data;
 
-				LoadData(TypeIndex dsttype, DataType data)
-					: dsttype(dsttype), data(data) {}
+				LoadData(TypeIndex dsttype, MemorySize dstsize, DataType data)
+					: dsttype(dsttype), dstsize(dstsize), data(data) {}
 
 			protected:
 				ConstDataPointer get_datapointer(Environment &env) const {
-					return ConstDataPointer(env.GEnv().getDataSectionMap().at((FileID(0), DataID(data))).first);
+					std::call_once(_once, [this]() { _value = String::FromLiteral(data->get(), data->size().data); });
+					return ConstDataPointer(reinterpret_cast<const uint8_t*>(&_value));
 				}
 				MemorySize get_memorysize(Environment &env) const {
-					return env.GEnv().getDataSectionMap().at((FileID(0), DataID(data))).second;
+					return MemorySize(String::ValueSize);
 				}
+
+			private:
+				mutable std::once_flag _once;
+				mutable String::StringValue _value;
 			};
 
 			template <size_t _subid>
 			struct LoadDataDd : public LoadData<_subid> {
 				Config::RegisterIndexType dst;
 
-				LoadDataDd(Config::RegisterIndexType dst, TypeIndex expecttype, typename LoadData<_subid>::DataType data)
-					: LoadData<_subid>(expecttype, data), dst(dst) {}
+				LoadDataDd(Config::RegisterIndexType dst, TypeIndex expecttype, MemorySize expectsize, typename LoadData<_subid>::DataType data)
+					: LoadData<_subid>(expecttype, expectsize, data), dst(dst) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
 						println("Do Inst <LoadDataDd", _subid, ">");
-					DataManage::LoadDataDd(env, env.get_dyvarb(dst), LoadData<_subid>::dsttype, LoadData<_subid>::get_datapointer(env), LoadData<_subid>::get_memorysize(env));
+					DataManage::LoadDataDd(env, env.get_dyvarb(dst), LoadData<_subid>::dsttype, LoadData<_subid>::dstsize, LoadData<_subid>::get_datapointer(env), LoadData<_subid>::get_memorysize(env));
 				}
 			};
 			template <size_t _subid>
 			struct LoadDataDs : public LoadData<_subid> {
 				Config::RegisterIndexType dst;
 
-				LoadDataDs(Config::RegisterIndexType dst, TypeIndex dsttype, typename LoadData<_subid>::DataType data)
-					: LoadData<_subid>(dsttype, data), dst(dst) {}
+				LoadDataDs(Config::RegisterIndexType dst, TypeIndex dsttype, MemorySize dstsize, typename LoadData<_subid>::DataType data)
+					: LoadData<_subid>(dsttype, dstsize, data), dst(dst) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
 						println("Do Inst <LoadDataDs", _subid, ">");
-					DataManage::LoadDataDs(env, env.get_stvarb(dst), LoadData<_subid>::dsttype, LoadData<_subid>::get_datapointer(env), LoadData<_subid>::get_memorysize(env));
+					DataManage::LoadDataDs(env, env.get_stvarb(dst), LoadData<_subid>::dstsize, LoadData<_subid>::get_datapointer(env), LoadData<_subid>::get_memorysize(env));
+				}
+			};
+			template <size_t _subid, MemoryKernel::SizeType _size>
+			struct LoadDataDsFixed : public LoadData<_subid> {
+				Config::RegisterIndexType dst;
+
+				LoadDataDsFixed(Config::RegisterIndexType dst, TypeIndex dsttype, MemorySize dstsize, typename LoadData<_subid>::DataType data)
+					: LoadData<_subid>(dsttype, dstsize, data), dst(dst) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <LoadDataDsFixed", _subid, ":", _size, ">");
+					DataManage::LoadDataDsFixed<_size>(env, env.get_stvarb(dst), LoadData<_subid>::get_datapointer(env), LoadData<_subid>::get_memorysize(env));
 				}
 			};
 			template <size_t _subid>
 			struct LoadDataRes : public LoadData<_subid> {
-				LoadDataRes(TypeIndex restype, typename LoadData<_subid>::DataType data)
-					: LoadData<_subid>(restype, data) {}
+				LoadDataRes(TypeIndex restype, MemorySize ressize, typename LoadData<_subid>::DataType data)
+					: LoadData<_subid>(restype, ressize, data) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
 						println("Do Inst <LoadDataRes", _subid, ">");
-					DataManage::LoadDataRes(env, LoadData<_subid>::dsttype, LoadData<_subid>::get_datapointer(env), LoadData<_subid>::get_memorysize(env));
+					DataManage::LoadDataRes(env, LoadData<_subid>::dsttype, LoadData<_subid>::dstsize, LoadData<_subid>::get_datapointer(env), LoadData<_subid>::get_memorysize(env));
 				}
 			};
 
@@ -235,16 +315,20 @@ namespace CVM
 			// * LoadDataPointer
 			//--------------------------------------
 
+			// The data label is resolved to the address in LiteralDataPool by the compiler,
+			// or to the lazy literal if the data is compressed.
 			struct LoadDataPointer : public Instruction {
-				using DataType = InstStruct::DataLabel::Type;
+				struct DataType {
+					const uint8_t *pointer;
+					const LazyLiteral *lazy;
+				};
 				DataType data;
 
 				LoadDataPointer(DataType data)
 					: data(data) {}
 
 				ConstDataPointer get_datapointer(Environment &env) const {
-					auto dp = env.GEnv().getDataSectionMap().at((FileID(0), DataID(data))).first;
-					return ConstDataPointer(dp);
+					return ConstDataPointer(data.lazy ? data.lazy->get() : data.pointer);
 				}
 			};
 			struct LoadDataPointerDd : public LoadDataPointer {
@@ -261,27 +345,27 @@ namespace CVM
 			};
 			struct LoadDataPointerDs : public LoadDataPointer {
 				Config::RegisterIndexType dst;
-				TypeIndex dsttype;
+				MemorySize dstsize;
 
-				LoadDataPointerDs(Config::RegisterIndexType dst, TypeIndex dsttype, DataType data)
-					: LoadDataPointer(data), dst(dst), dsttype(dsttype) {}
+				LoadDataPointerDs(Config::RegisterIndexType dst, MemorySize dstsize, DataType data)
+					: LoadDataPointer(data), dst(dst), dstsize(dstsize) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
 						println("Do Inst <LoadDataPointerDs>");
-					DataManage::LoadDataPointerDs(env, env.get_stvarb(dst), dsttype, get_datapointer(env));
+					DataManage::LoadDataPointerDs(env, env.get_stvarb(dst), dstsize, get_datapointer(env));
 				}
 			};
 			struct LoadDataPointerRes : public LoadDataPointer {
-				TypeIndex restype;
+				MemorySize ressize;
 
-				LoadDataPointerRes(TypeIndex restype, DataType data)
-					: LoadDataPointer(data), restype(restype) {}
+				LoadDataPointerRes(MemorySize ressize, DataType data)
+					: LoadDataPointer(data), ressize(ressize) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
 						println("Do Inst <LoadDataPointerRes>");
-					DataManage::LoadDataPointerRes(env, restype, get_datapointer(env));
+					DataManage::LoadDataPointerRes(env, ressize, get_datapointer(env));
 				}
 			};
 		}
@@ -289,20 +373,76 @@ namespace CVM
 		namespace Insts
 		{
 			//--------------------------------------
-			// * Jump
+			// * Field
+			//    The object is a static register (direct),
+			//    or a static register of the pointer to it (indirect).
+			//    The offset and the size of the field are resolved by the compiler.
 			//--------------------------------------
 
-			struct Jump : public Instruction {
-				Config::LineCountType line;
+			template <bool _indirect>
+			struct FieldAccess : public Instruction {
+				Config::RegisterIndexType obj;
+				Config::RegisterIndexType val;
+				MemorySize offset;
 
-				Jump(Config::LineCountType line)
-					: line(line) {}
+				FieldAccess(Config::RegisterIndexType obj, Config::RegisterIndexType val, MemorySize offset)
+					: obj(obj), val(val), offset(offset) {}
+
+			protected:
+				DataPointer get_fieldpointer(Environment &env) const {
+					DataPointer object = env.get_stvarb(obj).data;
+					if (_indirect)
+						object = DataPointer(*object.get<void*>());
+					return object.offset(offset);
+				}
+			};
+
+			template <bool _indirect>
+			struct LoadField : public FieldAccess<_indirect> {
+				MemorySize size;
+
+				LoadField(Config::RegisterIndexType obj, Config::RegisterIndexType val, MemorySize offset, MemorySize size)
+					: FieldAccess<_indirect>(obj, val, offset), size(size) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
-						println("Do Inst <Jump>");
-					CheckLocalEnv(env);
-					static_cast<Runtime::LocalEnvironment&>(env).Controlflow().setProgramCounter(line);
+						println("Do Inst <LoadField", _indirect ? "Indirect" : "", ">");
+					DataManage::LoadField(env, env.get_stvarb(this->val), this->get_fieldpointer(env), size);
+				}
+			};
+			template <bool _indirect, MemoryKernel::SizeType _size>
+			struct LoadFieldFixed : public FieldAccess<_indirect> {
+				LoadFieldFixed(Config::RegisterIndexType obj, Config::RegisterIndexType val, MemorySize offset)
+					: FieldAccess<_indirect>(obj, val, offset) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <LoadFieldFixed", _indirect ? "Indirect" : "", _size, ">");
+					DataManage::LoadFieldFixed<_size>(env, env.get_stvarb(this->val), this->get_fieldpointer(env));
+				}
+			};
+			template <bool _indirect>
+			struct StoreField : public FieldAccess<_indirect> {
+				MemorySize size;
+
+				StoreField(Config::RegisterIndexType obj, Config::RegisterIndexType val, MemorySize offset, MemorySize size)
+					: FieldAccess<_indirect>(obj, val, offset), size(size) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StoreField", _indirect ? "Indirect" : "", ">");
+					DataManage::StoreField(env, this->get_fieldpointer(env), env.get_stvarb(this->val), size);
+				}
+			};
+			template <bool _indirect, MemoryKernel::SizeType _size>
+			struct StoreFieldFixed : public FieldAccess<_indirect> {
+				StoreFieldFixed(Config::RegisterIndexType obj, Config::RegisterIndexType val, MemorySize offset)
+					: FieldAccess<_indirect>(obj, val, offset) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StoreFieldFixed", _indirect ? "Indirect" : "", _size, ">");
+					DataManage::StoreFieldFixed<_size>(env, this->get_fieldpointer(env), env.get_stvarb(this->val));
 				}
 			};
 		}
@@ -310,46 +450,924 @@ namespace CVM
 		namespace Insts
 		{
 			//--------------------------------------
-			// * Call
+			// * Float
+			//    The operands are static registers, whose types are resolved by the compiler.
 			//--------------------------------------
 
-			struct Call : public Instruction {
-				using ArgListType = PriLib::lightlist<Config::RegisterIndexType>;
-				Config::FuncIndexType fid;
-				ArgListType arglist;
+			template <typename _Float, typename _Op>
+			struct FloatArith : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				Config::RegisterIndexType rhs;
 
-				Call(Config::FuncIndexType fid, ArgListType arglist)
-					: fid(fid), arglist(arglist) {}
+				FloatArith(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, Config::RegisterIndexType rhs)
+					: dst(dst), lhs(lhs), rhs(rhs) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
-						println("Do Inst <Call> ", env.GEnv().getFuncTable().at(fid)->type(), ":", fid);
-					DataManage::CallZero(env, fid, arglist);
+						println("Do Inst <FloatArith", sizeof(_Float), ">");
+					DataManage::FloatArith<_Float, _Op>(env, env.get_stvarb(dst), env.get_stvarb(lhs), env.get_stvarb(rhs));
 				}
 			};
+			template <typename _Float>
+			struct FloatNeg : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
 
-			struct CallDds : public Call {
+				FloatNeg(Config::RegisterIndexType dst, Config::RegisterIndexType src)
+					: dst(dst), src(src) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <FloatNeg", sizeof(_Float), ">");
+					DataManage::FloatNeg<_Float>(env, env.get_stvarb(dst), env.get_stvarb(src));
+				}
+			};
+			template <typename _Float, typename _Op, typename _Result>
+			struct FloatCompare : public Instruction {
 				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				Config::RegisterIndexType rhs;
 
-				CallDds(Config::RegisterIndexType dst, Config::FuncIndexType fid, ArgListType arglist)
-					: Call(fid, arglist), dst(dst) {
-					assert(dst);
+				FloatCompare(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, Config::RegisterIndexType rhs)
+					: dst(dst), lhs(lhs), rhs(rhs) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <FloatCompare", sizeof(_Float), ">");
+					DataManage::FloatCompare<_Float, _Op, _Result>(env, env.get_stvarb(dst), env.get_stvarb(lhs), env.get_stvarb(rhs));
 				}
+			};
+			template <typename _Dst, typename _Src>
+			struct Convert : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+
+				Convert(Config::RegisterIndexType dst, Config::RegisterIndexType src)
+					: dst(dst), src(src) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
-						println("Do Inst <CallDds> ", env.GEnv().getFuncTable().at(fid)->type(), ":", fid);
-					DataManage::CallDds(env, dst, fid, arglist);
+						println("Do Inst <Convert>");
+					DataManage::Convert<_Dst, _Src>(env, env.get_stvarb(dst), env.get_stvarb(src));
 				}
 			};
-			struct CallRes : public Call {
-				CallRes(Config::FuncIndexType fid, ArgListType arglist)
-					: Call(fid, arglist) {}
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * Integer
+			//    The operands are static registers of the same integer type, resolved by the compiler.
+			//    The Imm instructions take the immediate rhs instead of the register.
+			//--------------------------------------
+
+			template <typename _Int, typename _Op>
+			struct IntegerBinary : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				Config::RegisterIndexType rhs;
+
+				IntegerBinary(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, Config::RegisterIndexType rhs)
+					: dst(dst), lhs(lhs), rhs(rhs) {}
 
 				virtual void operator()(Environment &env) const {
 					if (CVMInstDebugMode)
-						println("Do Inst <CallRes> ", env.GEnv().getFuncTable().at(fid)->type(), ":", fid);
-					DataManage::CallRes(env, fid, arglist);
+						println("Do Inst <IntegerBinary", sizeof(_Int), ">");
+					DataManage::IntegerBinary<_Int, _Op>(env, env.get_stvarb(dst), env.get_stvarb(lhs), env.get_stvarb(rhs));
+				}
+			};
+			template <typename _Int, typename _Op>
+			struct IntegerBinaryImm : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				_Int rhs;
+
+				IntegerBinaryImm(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, _Int rhs)
+					: dst(dst), lhs(lhs), rhs(rhs) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <IntegerBinaryImm", sizeof(_Int), ">");
+					DataManage::IntegerBinaryImm<_Int, _Op>(env, env.get_stvarb(dst), env.get_stvarb(lhs), rhs);
+				}
+			};
+			template <typename _Int, typename _Op>
+			struct IntegerUnary : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+
+				IntegerUnary(Config::RegisterIndexType dst, Config::RegisterIndexType src)
+					: dst(dst), src(src) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <IntegerUnary", sizeof(_Int), ">");
+					DataManage::IntegerUnary<_Int, _Op>(env, env.get_stvarb(dst), env.get_stvarb(src));
+				}
+			};
+			template <typename _Int, typename _Op, typename _Result>
+			struct IntegerCompare : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				Config::RegisterIndexType rhs;
+
+				IntegerCompare(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, Config::RegisterIndexType rhs)
+					: dst(dst), lhs(lhs), rhs(rhs) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <IntegerCompare", sizeof(_Int), ">");
+					DataManage::IntegerCompare<_Int, _Op, _Result>(env, env.get_stvarb(dst), env.get_stvarb(lhs), env.get_stvarb(rhs));
+				}
+			};
+			template <typename _Int, typename _Op, typename _Result>
+			struct IntegerCompareImm : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				_Int rhs;
+
+				IntegerCompareImm(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, _Int rhs)
+					: dst(dst), lhs(lhs), rhs(rhs) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <IntegerCompareImm", sizeof(_Int), ">");
+					DataManage::IntegerCompareImm<_Int, _Op, _Result>(env, env.get_stvarb(dst), env.get_stvarb(lhs), rhs);
+				}
+			};
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * Vector
+			//    The operands are static registers of cms#v128 or cms#v256.
+			//--------------------------------------
+
+			struct VectorBinary : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				Config::RegisterIndexType rhs;
+				VectorKernel::BinaryKernel kernel;
+
+				VectorBinary(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, Config::RegisterIndexType rhs, VectorKernel::BinaryKernel kernel)
+					: dst(dst), lhs(lhs), rhs(rhs), kernel(kernel) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <VectorBinary>");
+					DataManage::VectorBinary(env, env.get_stvarb(dst), env.get_stvarb(lhs), env.get_stvarb(rhs), kernel);
+				}
+			};
+			struct VectorShuffle : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+				Config::RegisterIndexType idx;
+				VectorKernel::ShuffleKernel kernel;
+
+				VectorShuffle(Config::RegisterIndexType dst, Config::RegisterIndexType src, Config::RegisterIndexType idx, VectorKernel::ShuffleKernel kernel)
+					: dst(dst), src(src), idx(idx), kernel(kernel) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <VectorShuffle>");
+					DataManage::VectorShuffle(env, env.get_stvarb(dst), env.get_stvarb(src), env.get_stvarb(idx), kernel);
+				}
+			};
+			struct VectorReduce : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+				VectorKernel::ReduceKernel kernel;
+
+				VectorReduce(Config::RegisterIndexType dst, Config::RegisterIndexType src, VectorKernel::ReduceKernel kernel)
+					: dst(dst), src(src), kernel(kernel) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <VectorReduce>");
+					DataManage::VectorReduce(env, env.get_stvarb(dst), env.get_stvarb(src), kernel);
+				}
+			};
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * BigInt
+			//    The operands are static registers, whose types are resolved by the compiler.
+			//--------------------------------------
+
+			template <void (*_func)(BigInt::BigIntValue&, const BigInt::BigIntValue&, const BigInt::BigIntValue&)>
+			struct BigIntBinary : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				Config::RegisterIndexType rhs;
+
+				BigIntBinary(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, Config::RegisterIndexType rhs)
+					: dst(dst), lhs(lhs), rhs(rhs) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <BigIntBinary>");
+					DataManage::BigIntBinary<_func>(env, env.get_stvarb(dst), env.get_stvarb(lhs), env.get_stvarb(rhs));
+				}
+			};
+			struct BigIntNeg : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+
+				BigIntNeg(Config::RegisterIndexType dst, Config::RegisterIndexType src)
+					: dst(dst), src(src) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <BigIntNeg>");
+					DataManage::BigIntNeg(env, env.get_stvarb(dst), env.get_stvarb(src));
+				}
+			};
+			template <typename _Result>
+			struct BigIntCompare : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				Config::RegisterIndexType rhs;
+
+				BigIntCompare(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, Config::RegisterIndexType rhs)
+					: dst(dst), lhs(lhs), rhs(rhs) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <BigIntCompare>");
+					DataManage::BigIntCompare<_Result>(env, env.get_stvarb(dst), env.get_stvarb(lhs), env.get_stvarb(rhs));
+				}
+			};
+			template <typename _Src>
+			struct BigIntFromInteger : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+
+				BigIntFromInteger(Config::RegisterIndexType dst, Config::RegisterIndexType src)
+					: dst(dst), src(src) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <BigIntFromInteger>");
+					DataManage::BigIntFromInteger<_Src>(env, env.get_stvarb(dst), env.get_stvarb(src));
+				}
+			};
+			template <typename _Dst>
+			struct BigIntToInteger : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+
+				BigIntToInteger(Config::RegisterIndexType dst, Config::RegisterIndexType src)
+					: dst(dst), src(src) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <BigIntToInteger>");
+					DataManage::BigIntToInteger<_Dst>(env, env.get_stvarb(dst), env.get_stvarb(src));
+				}
+			};
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * Slice
+			//    The operands are static registers, whose types are resolved by the compiler.
+			//    The bounds (and element type) check is omitted if _checked is false,
+			//    which is only compiled for the access proven safe.
+			//--------------------------------------
+
+			struct MakeSlice : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType ptr;
+				Config::RegisterIndexType len;
+				TypeIndex elemtype;
+
+				MakeSlice(Config::RegisterIndexType dst, Config::RegisterIndexType ptr, Config::RegisterIndexType len, TypeIndex elemtype)
+					: dst(dst), ptr(ptr), len(len), elemtype(elemtype) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <MakeSlice>");
+					DataManage::MakeSlice(env, env.get_stvarb(dst), env.get_stvarb(ptr), env.get_stvarb(len), elemtype);
+				}
+			};
+			struct SliceLength : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType slice;
+
+				SliceLength(Config::RegisterIndexType dst, Config::RegisterIndexType slice)
+					: dst(dst), slice(slice) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <SliceLength>");
+					DataManage::SliceLength(env, env.get_stvarb(dst), env.get_stvarb(slice));
+				}
+			};
+
+			struct ElementAccess : public Instruction {
+				Config::RegisterIndexType slice;
+				Config::RegisterIndexType index;
+				Config::RegisterIndexType val;
+				TypeIndex elemtype;
+
+				ElementAccess(Config::RegisterIndexType slice, Config::RegisterIndexType index, Config::RegisterIndexType val, TypeIndex elemtype)
+					: slice(slice), index(index), val(val), elemtype(elemtype) {}
+			};
+
+			template <bool _checked>
+			struct LoadElement : public ElementAccess {
+				MemorySize size;
+
+				LoadElement(Config::RegisterIndexType slice, Config::RegisterIndexType index, Config::RegisterIndexType val, TypeIndex elemtype, MemorySize size)
+					: ElementAccess(slice, index, val, elemtype), size(size) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <LoadElement", _checked ? "Checked" : "", ">");
+					DataManage::LoadElement<_checked>(env, env.get_stvarb(val), env.get_stvarb(slice), env.get_stvarb(index), elemtype, size);
+				}
+			};
+			template <bool _checked, MemoryKernel::SizeType _size>
+			struct LoadElementFixed : public ElementAccess {
+				LoadElementFixed(Config::RegisterIndexType slice, Config::RegisterIndexType index, Config::RegisterIndexType val, TypeIndex elemtype)
+					: ElementAccess(slice, index, val, elemtype) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <LoadElementFixed", _checked ? "Checked" : "", _size, ">");
+					DataManage::LoadElementFixed<_checked, _size>(env, env.get_stvarb(val), env.get_stvarb(slice), env.get_stvarb(index), elemtype);
+				}
+			};
+			template <bool _checked>
+			struct StoreElement : public ElementAccess {
+				MemorySize size;
+
+				StoreElement(Config::RegisterIndexType slice, Config::RegisterIndexType index, Config::RegisterIndexType val, TypeIndex elemtype, MemorySize size)
+					: ElementAccess(slice, index, val, elemtype), size(size) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StoreElement", _checked ? "Checked" : "", ">");
+					DataManage::StoreElement<_checked>(env, env.get_stvarb(slice), env.get_stvarb(index), env.get_stvarb(val), elemtype, size);
+				}
+			};
+			template <bool _checked, MemoryKernel::SizeType _size>
+			struct StoreElementFixed : public ElementAccess {
+				StoreElementFixed(Config::RegisterIndexType slice, Config::RegisterIndexType index, Config::RegisterIndexType val, TypeIndex elemtype)
+					: ElementAccess(slice, index, val, elemtype) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StoreElementFixed", _checked ? "Checked" : "", _size, ">");
+					DataManage::StoreElementFixed<_checked, _size>(env, env.get_stvarb(slice), env.get_stvarb(index), env.get_stvarb(val), elemtype);
+				}
+			};
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * String
+			//    The operands are static registers, whose types are resolved by the compiler.
+			//--------------------------------------
+
+			struct StringConcat : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				Config::RegisterIndexType rhs;
+
+				StringConcat(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, Config::RegisterIndexType rhs)
+					: dst(dst), lhs(lhs), rhs(rhs) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StringConcat>");
+					DataManage::StringConcat(env, env.get_stvarb(dst), env.get_stvarb(lhs), env.get_stvarb(rhs));
+				}
+			};
+			template <typename _Result>
+			struct StringCompare : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType lhs;
+				Config::RegisterIndexType rhs;
+
+				StringCompare(Config::RegisterIndexType dst, Config::RegisterIndexType lhs, Config::RegisterIndexType rhs)
+					: dst(dst), lhs(lhs), rhs(rhs) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StringCompare>");
+					DataManage::StringCompare<_Result>(env, env.get_stvarb(dst), env.get_stvarb(lhs), env.get_stvarb(rhs));
+				}
+			};
+			struct StringHash : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+
+				StringHash(Config::RegisterIndexType dst, Config::RegisterIndexType src)
+					: dst(dst), src(src) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StringHash>");
+					DataManage::StringHash(env, env.get_stvarb(dst), env.get_stvarb(src));
+				}
+			};
+			struct StringLength : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+
+				StringLength(Config::RegisterIndexType dst, Config::RegisterIndexType src)
+					: dst(dst), src(src) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StringLength>");
+					DataManage::StringLength(env, env.get_stvarb(dst), env.get_stvarb(src));
+				}
+			};
+			struct StringSub : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+				Config::RegisterIndexType start;
+				Config::RegisterIndexType len;
+
+				StringSub(Config::RegisterIndexType dst, Config::RegisterIndexType src, Config::RegisterIndexType start, Config::RegisterIndexType len)
+					: dst(dst), src(src), start(start), len(len) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StringSub>");
+					DataManage::StringSub(env, env.get_stvarb(dst), env.get_stvarb(src), env.get_stvarb(start), env.get_stvarb(len));
+				}
+			};
+			struct StringIntern : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType src;
+
+				StringIntern(Config::RegisterIndexType dst, Config::RegisterIndexType src)
+					: dst(dst), src(src) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StringIntern>");
+					DataManage::StringIntern(env, env.get_stvarb(dst), env.get_stvarb(src));
+				}
+			};
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * Map
+			//    The operands are static registers, the type of map is built by the compiler
+			//    from the types of the key and the value, and is checked with the map on execution.
+			//--------------------------------------
+
+			struct MakeMap : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType capacity;  // 0 if no capacity.
+				HashMap::MapType type;
+
+				MakeMap(Config::RegisterIndexType dst, Config::RegisterIndexType capacity, const HashMap::MapType &type)
+					: dst(dst), capacity(capacity), type(type) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <MakeMap>");
+					DataManage::MakeMap(env, env.get_stvarb(dst), type, capacity ? &env.get_stvarb(capacity) : nullptr);
+				}
+			};
+			struct MapPut : public Instruction {
+				Config::RegisterIndexType map;
+				Config::RegisterIndexType key;
+				Config::RegisterIndexType val;
+				HashMap::MapType type;
+
+				MapPut(Config::RegisterIndexType map, Config::RegisterIndexType key, Config::RegisterIndexType val, const HashMap::MapType &type)
+					: map(map), key(key), val(val), type(type) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <MapPut>");
+					DataManage::MapPut(env, env.get_stvarb(map), env.get_stvarb(key), env.get_stvarb(val), type);
+				}
+			};
+			template <typename _Found>
+			struct MapGet : public Instruction {
+				Config::RegisterIndexType found;
+				Config::RegisterIndexType val;
+				Config::RegisterIndexType map;
+				Config::RegisterIndexType key;
+				HashMap::MapType type;
+
+				MapGet(Config::RegisterIndexType found, Config::RegisterIndexType val, Config::RegisterIndexType map, Config::RegisterIndexType key, const HashMap::MapType &type)
+					: found(found), val(val), map(map), key(key), type(type) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <MapGet>");
+					DataManage::MapGet<_Found>(env, env.get_stvarb(found), env.get_stvarb(val), env.get_stvarb(map), env.get_stvarb(key), type);
+				}
+			};
+			struct MapErase : public Instruction {
+				Config::RegisterIndexType map;
+				Config::RegisterIndexType key;
+				HashMap::MapType type;
+
+				MapErase(Config::RegisterIndexType map, Config::RegisterIndexType key, const HashMap::MapType &type)
+					: map(map), key(key), type(type) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <MapErase>");
+					DataManage::MapErase(env, env.get_stvarb(map), env.get_stvarb(key), type);
+				}
+			};
+			struct MapNext : public Instruction {
+				Config::RegisterIndexType pos;
+				Config::RegisterIndexType key;
+				Config::RegisterIndexType val;
+				Config::RegisterIndexType map;
+				HashMap::MapType type;
+
+				MapNext(Config::RegisterIndexType pos, Config::RegisterIndexType key, Config::RegisterIndexType val, Config::RegisterIndexType map, const HashMap::MapType &type)
+					: pos(pos), key(key), val(val), map(map), type(type) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <MapNext>");
+					DataManage::MapNext(env, env.get_stvarb(pos), env.get_stvarb(key), env.get_stvarb(val), env.get_stvarb(map), type);
+				}
+			};
+			struct MapSize : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType map;
+
+				MapSize(Config::RegisterIndexType dst, Config::RegisterIndexType map)
+					: dst(dst), map(map) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <MapSize>");
+					DataManage::MapSize(env, env.get_stvarb(dst), env.get_stvarb(map));
+				}
+			};
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * Bulk
+			//    The count is the register (cms#int64 or cms#uint64) if countreg isn't 0, otherwise the immediate.
+			//--------------------------------------
+
+			// The memory pointed by the register of cms#pointer (indirect), the register itself,
+			// or the VM stack at the offset from %sp (stack).
+			struct BulkOperand {
+				Config::RegisterIndexType reg = 0;
+				bool indirect = false;
+				bool stack = false;
+				Config::StackOffsetType offset = 0;
+
+				void* address(Environment &env) const {
+					if (stack)
+						return DataManage::GetStackAddress(offset);
+					return DataManage::GetBulkAddress(env.get_stvarb(reg), indirect);
+				}
+			};
+
+			struct CopyN : public Instruction {
+				BulkOperand dst;
+				BulkOperand src;
+				Config::RegisterIndexType countreg;
+				uint64_t count;
+
+				CopyN(BulkOperand dst, BulkOperand src, Config::RegisterIndexType countreg, uint64_t count)
+					: dst(dst), src(src), countreg(countreg), count(count) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <CopyN>");
+					uint64_t size = DataManage::GetBulkCount(countreg ? &env.get_stvarb(countreg) : nullptr, count);
+					DataManage::CopyN(env, dst.address(env), src.address(env), size);
+				}
+			};
+			struct FillN : public Instruction {
+				BulkOperand dst;
+				Config::RegisterIndexType val;
+				MemorySize valsize;
+				Config::RegisterIndexType countreg;
+				uint64_t count;
+
+				FillN(BulkOperand dst, Config::RegisterIndexType val, MemorySize valsize, Config::RegisterIndexType countreg, uint64_t count)
+					: dst(dst), val(val), valsize(valsize), countreg(countreg), count(count) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <FillN>");
+					uint64_t n = DataManage::GetBulkCount(countreg ? &env.get_stvarb(countreg) : nullptr, count);
+					DataManage::FillN(env, dst.address(env), env.get_stvarb(val), valsize, n);
+				}
+			};
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * Stack
+			//    The stack registers are resolved to the offset from %sp by the compiler.
+			//    The size is the register (cms#int64 or cms#uint64) if sizereg isn't 0, otherwise the immediate.
+			//--------------------------------------
+
+			template <bool _release>
+			struct StackResize : public Instruction {
+				Config::RegisterIndexType sizereg;
+				uint64_t size;
+
+				StackResize(Config::RegisterIndexType sizereg, uint64_t size)
+					: sizereg(sizereg), size(size) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <Stack", _release ? "Release" : "Allocate", ">");
+					uint64_t n = DataManage::GetBulkCount(sizereg ? &env.get_stvarb(sizereg) : nullptr, size);
+					if (_release)
+						DataManage::StackRelease(env, n);
+					else
+						DataManage::StackAllocate(env, n);
+				}
+			};
+
+			struct LoadStackPointer : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::StackOffsetType offset;
+
+				LoadStackPointer(Config::RegisterIndexType dst, Config::StackOffsetType offset)
+					: dst(dst), offset(offset) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <LoadStackPointer>");
+					DataManage::LoadStackPointer(env, env.get_stvarb(dst), offset);
+				}
+			};
+
+			struct StackAccess : public Instruction {
+				Config::RegisterIndexType val;
+				Config::StackOffsetType offset;
+
+				StackAccess(Config::RegisterIndexType val, Config::StackOffsetType offset)
+					: val(val), offset(offset) {}
+			};
+
+			template <bool _release>
+			struct LoadStack : public StackAccess {
+				MemorySize size;
+
+				LoadStack(Config::RegisterIndexType val, Config::StackOffsetType offset, MemorySize size)
+					: StackAccess(val, offset), size(size) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <LoadStack", _release ? "Release" : "", ">");
+					DataManage::LoadStack<_release>(env, env.get_stvarb(val), offset, size);
+				}
+			};
+			template <bool _release, MemoryKernel::SizeType _size>
+			struct LoadStackFixed : public StackAccess {
+				LoadStackFixed(Config::RegisterIndexType val, Config::StackOffsetType offset)
+					: StackAccess(val, offset) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <LoadStackFixed", _release ? "Release" : "", _size, ">");
+					DataManage::LoadStackFixed<_release, _size>(env, env.get_stvarb(val), offset);
+				}
+			};
+			template <bool _release>
+			struct StoreStack : public StackAccess {
+				MemorySize size;
+
+				StoreStack(Config::RegisterIndexType val, Config::StackOffsetType offset, MemorySize size)
+					: StackAccess(val, offset), size(size) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StoreStack", _release ? "Release" : "", ">");
+					DataManage::StoreStack<_release>(env, offset, env.get_stvarb(val), size);
+				}
+			};
+			template <bool _release, MemoryKernel::SizeType _size>
+			struct StoreStackFixed : public StackAccess {
+				StoreStackFixed(Config::RegisterIndexType val, Config::StackOffsetType offset)
+					: StackAccess(val, offset) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <StoreStackFixed", _release ? "Release" : "", _size, ">");
+					DataManage::StoreStackFixed<_release, _size>(env, offset, env.get_stvarb(val));
+				}
+			};
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * Atomic
+			//    The object is a static global register, resolved by the compiler with the memory order.
+			//--------------------------------------
+
+			template <typename T>
+			struct AtomicLoad : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType obj;
+				std::memory_order order;
+
+				AtomicLoad(Config::RegisterIndexType dst, Config::RegisterIndexType obj, std::memory_order order)
+					: dst(dst), obj(obj), order(order) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <AtomicLoad", sizeof(T), ">");
+					DataManage::AtomicLoad<T>(env, env.get_stvarb(dst), env.get_stvarb(obj), order);
+				}
+			};
+			template <typename T>
+			struct AtomicStore : public Instruction {
+				Config::RegisterIndexType obj;
+				Config::RegisterIndexType src;
+				std::memory_order order;
+
+				AtomicStore(Config::RegisterIndexType obj, Config::RegisterIndexType src, std::memory_order order)
+					: obj(obj), src(src), order(order) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <AtomicStore", sizeof(T), ">");
+					DataManage::AtomicStore<T>(env, env.get_stvarb(obj), env.get_stvarb(src), order);
+				}
+			};
+			template <typename T>
+			struct AtomicFetchAdd : public Instruction {
+				Config::RegisterIndexType dst;
+				Config::RegisterIndexType obj;
+				Config::RegisterIndexType val;
+				std::memory_order order;
+
+				AtomicFetchAdd(Config::RegisterIndexType dst, Config::RegisterIndexType obj, Config::RegisterIndexType val, std::memory_order order)
+					: dst(dst), obj(obj), val(val), order(order) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <AtomicFetchAdd", sizeof(T), ">");
+					DataManage::AtomicFetchAdd<T>(env, env.get_stvarb(dst), env.get_stvarb(obj), env.get_stvarb(val), order);
+				}
+			};
+			template <typename T>
+			struct AtomicCompareExchange : public Instruction {
+				Config::RegisterIndexType ok;
+				Config::RegisterIndexType obj;
+				Config::RegisterIndexType expected;
+				Config::RegisterIndexType desired;
+				std::memory_order order;
+
+				AtomicCompareExchange(Config::RegisterIndexType ok, Config::RegisterIndexType obj, Config::RegisterIndexType expected, Config::RegisterIndexType desired, std::memory_order order)
+					: ok(ok), obj(obj), expected(expected), desired(desired), order(order) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <AtomicCompareExchange", sizeof(T), ">");
+					DataManage::AtomicCompareExchange<T>(env, env.get_stvarb(ok), env.get_stvarb(obj), env.get_stvarb(expected), env.get_stvarb(desired), order);
+				}
+			};
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * Jump
+			//--------------------------------------
+
+			struct Jump : public Instruction {
+				Config::LineCountType line;
+
+				Jump(Config::LineCountType line)
+					: line(line) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <Jump>");
+					CheckLocalEnv(env);
+					static_cast<Runtime::LocalEnvironment&>(env).Controlflow().setProgramCounter(line);
+				}
+			};
+
+			// The value is a static register of the integer type, the lines of the cases are resolved by the compiler.
+			template <typename _Int>
+			struct SwitchTable : public Instruction {
+				Config::RegisterIndexType val;
+				_Int min;
+				Config::LineCountType defaultline;
+				std::vector<Config::LineCountType> table;
+
+				SwitchTable(Config::RegisterIndexType val, _Int min, Config::LineCountType defaultline, std::vector<Config::LineCountType> table)
+					: val(val), min(min), defaultline(defaultline), table(std::move(table)) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <SwitchTable", sizeof(_Int), ">");
+					CheckLocalEnv(env);
+					Config::LineCountType line = DataManage::SwitchTable<_Int>(env.get_stvarb(val), min, table, defaultline);
+					static_cast<Runtime::LocalEnvironment&>(env).Controlflow().setProgramCounter(line);
+				}
+			};
+			template <typename _Int>
+			struct SwitchSearch : public Instruction {
+				Config::RegisterIndexType val;
+				Config::LineCountType defaultline;
+				std::vector<_Int> keys;
+				std::vector<Config::LineCountType> lines;
+
+				SwitchSearch(Config::RegisterIndexType val, Config::LineCountType defaultline, std::vector<_Int> keys, std::vector<Config::LineCountType> lines)
+					: val(val), defaultline(defaultline), keys(std::move(keys)), lines(std::move(lines)) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <SwitchSearch", sizeof(_Int), ">");
+					CheckLocalEnv(env);
+					Config::LineCountType line = DataManage::SwitchSearch<_Int>(env.get_stvarb(val), keys, lines, defaultline);
+					static_cast<Runtime::LocalEnvironment&>(env).Controlflow().setProgramCounter(line);
+				}
+			};
+		}
+
+		namespace Insts
+		{
+			//--------------------------------------
+			// * Call
+			//--------------------------------------
+
+			struct Call : public Instruction {
+				using ArgListType = PriLib::lightlist<Config::RegisterIndexType>;
+				Config::FuncIndexType fid;
+				ArgListType arglist;
+
+				Call(Config::FuncIndexType fid, ArgListType arglist)
+					: fid(fid), arglist(arglist) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <Call> ", env.GEnv().getFuncTable().at(fid)->type(), ":", fid);
+					DataManage::CallZero(env, fid, arglist);
+				}
+			};
+
+			struct CallDds : public Call {
+				Config::RegisterIndexType dst;
+
+				CallDds(Config::RegisterIndexType dst, Config::FuncIndexType fid, ArgListType arglist)
+					: Call(fid, arglist), dst(dst) {
+					assert(dst);
+				}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <CallDds> ", env.GEnv().getFuncTable().at(fid)->type(), ":", fid);
+					DataManage::CallDds(env, dst, fid, arglist);
+				}
+			};
+			struct CallRes : public Call {
+				CallRes(Config::FuncIndexType fid, ArgListType arglist)
+					: Call(fid, arglist) {}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <CallRes> ", env.GEnv().getFuncTable().at(fid)->type(), ":", fid);
+					DataManage::CallRes(env, fid, arglist);
+				}
+			};
+			struct CallIntrinsic : public Instruction {
+				IntrinsicFunction::Func *func;
+				Config::RegisterIndexType dst;  // 0 if the result register is %0.
+				Config::RegisterIndexType args[IntrinsicFunction::MaxArgumentCount];
+				size_t argcount;
+
+				CallIntrinsic(IntrinsicFunction::Func *func, Config::RegisterIndexType dst, const Config::RegisterIndexType *args, size_t argcount)
+					: func(func), dst(dst), args(), argcount(argcount) {
+					assert(argcount <= IntrinsicFunction::MaxArgumentCount);
+					std::copy(args, args + argcount, this->args);
+				}
+
+				virtual void operator()(Environment &env) const {
+					if (CVMInstDebugMode)
+						println("Do Inst <CallIntrinsic>");
+					DataManage::CallIntrinsic(env, func, dst ? &env.get_stvarb(dst) : nullptr, args, argcount);
 				}
 			};
 
@@ -395,14 +1413,13 @@ namespace CVM
 						PriLib::Output::print("stvarb:");
 						//for (size_t i = regset.dysize(); i <= regset.stsize() + regset.stsize());
 						//env.getType()
-						Runtime::DataPointer address = regset.get_static(regset.dysize() + 1).data;
+						Runtime::DataPointer address = regset.staddress();
 						printf(" [address : 0x%p]\n", address.get());
 						for (Config::RegisterIndexType i = 0; i < typelist_count; ++i) {
 							MemorySize size = env.getType(typelist[i]).size;
 							PriLib::Output::print("  %", (i + 1), "s", ": type(", env.GEnv().getHashIDContext(env.getType(typelist[i]).name), "), ");
-							const auto &str = Runtime::DataManage::ToStringData(address, size);
+							const auto &str = Runtime::DataManage::ToStringData(regset.get_static(i + 1).data, size);
 							PriLib::Output::println(str);
-							address = address.offset(size);
 						}
 					}
 					PriLib::Output::println("=======================");
@@ -1,5 +1,6 @@
 #pragma once
 #include <functional>
+#include <cstddef>
 
 namespace CVM
 {
@@ -12,6 +13,11 @@ namespace CVM
 		public:
 			virtual ~Instruction() {}
 			virtual void operator()(Environment &env) const = 0;
+
+			// Instructions are placed in the code buffer (see PageProvider),
+			// and are never freed one by one.
+			static void* operator new(std::size_t size);
+			static void operator delete(void *ptr) {}
 		};
 	}
 }
@@ -0,0 +1,210 @@
+// integer.h
+// * This file provides the operations of the builtin integer types (cms#int8 ... cms#uint64).
+//   The plain operations wrap around (two's complement), the Checked ones exit with error on overflow.
+//   The division by zero is always an error.
+
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace Integer
+		{
+			[[noreturn]] void Overflow(const char *op);
+			[[noreturn]] void DivideByZero();
+
+			// The unsigned type to compute the wrapping result,
+			// the types narrower than int are widened to unsigned int to avoid the promotion to int.
+			template <typename T>
+			using WrapType = std::conditional_t<(sizeof(T) < sizeof(unsigned int)), unsigned int, std::make_unsigned_t<T>>;
+
+			template <typename T>
+			constexpr bool IsSignedMinDivision(T lhs, T rhs) {
+				if constexpr (std::is_signed<T>::value)
+					return lhs == std::numeric_limits<T>::min() && rhs == -1;
+				else
+					return false;
+			}
+
+			//--------------------------------------
+			// * Wrapping
+			//--------------------------------------
+
+			template <typename T>
+			struct Add {
+				T operator()(T lhs, T rhs) const {
+					return static_cast<T>(static_cast<WrapType<T>>(lhs) + static_cast<WrapType<T>>(rhs));
+				}
+			};
+			template <typename T>
+			struct Sub {
+				T operator()(T lhs, T rhs) const {
+					return static_cast<T>(static_cast<WrapType<T>>(lhs) - static_cast<WrapType<T>>(rhs));
+				}
+			};
+			template <typename T>
+			struct Mul {
+				T operator()(T lhs, T rhs) const {
+					return static_cast<T>(static_cast<WrapType<T>>(lhs) * static_cast<WrapType<T>>(rhs));
+				}
+			};
+			// Truncated toward zero, min / -1 wraps to min.
+			template <typename T>
+			struct Div {
+				T operator()(T lhs, T rhs) const {
+					if (rhs == 0)
+						DivideByZero();
+					if (IsSignedMinDivision(lhs, rhs))
+						return lhs;
+					return static_cast<T>(lhs / rhs);
+				}
+			};
+			// The sign is the same as lhs, min % -1 is 0.
+			template <typename T>
+			struct Rem {
+				T operator()(T lhs, T rhs) const {
+					if (rhs == 0)
+						DivideByZero();
+					if (IsSignedMinDivision(lhs, rhs))
+						return 0;
+					return static_cast<T>(lhs % rhs);
+				}
+			};
+			template <typename T>
+			struct And {
+				T operator()(T lhs, T rhs) const {
+					return static_cast<T>(lhs & rhs);
+				}
+			};
+			template <typename T>
+			struct Or {
+				T operator()(T lhs, T rhs) const {
+					return static_cast<T>(lhs | rhs);
+				}
+			};
+			template <typename T>
+			struct Xor {
+				T operator()(T lhs, T rhs) const {
+					return static_cast<T>(lhs ^ rhs);
+				}
+			};
+			// The shift count is taken modulo the bit width (the same as x86).
+			template <typename T>
+			struct Shl {
+				T operator()(T lhs, T rhs) const {
+					unsigned int count = static_cast<unsigned int>(rhs) & (sizeof(T) * 8 - 1);
+					return static_cast<T>(static_cast<WrapType<T>>(lhs) << count);
+				}
+			};
+			// Arithmetic for the signed types, logical for the unsigned types.
+			template <typename T>
+			struct Shr {
+				T operator()(T lhs, T rhs) const {
+					unsigned int count = static_cast<unsigned int>(rhs) & (sizeof(T) * 8 - 1);
+					return static_cast<T>(lhs >> count);
+				}
+			};
+			template <typename T>
+			struct Neg {
+				T operator()(T src) const {
+					return static_cast<T>(WrapType<T>(0) - static_cast<WrapType<T>>(src));
+				}
+			};
+
+			//--------------------------------------
+			// * Checked
+			//--------------------------------------
+
+			template <typename T>
+			bool AddOverflow(T lhs, T rhs, T &result) {
+#if defined(__GNUC__) || defined(__clang__)
+				return __builtin_add_overflow(lhs, rhs, &result);
+#else
+				result = Add<T>()(lhs, rhs);
+				if constexpr (std::is_signed<T>::value)
+					return rhs < 0 ? result > lhs : result < lhs;
+				else
+					return result < lhs;
+#endif
+			}
+			template <typename T>
+			bool SubOverflow(T lhs, T rhs, T &result) {
+#if defined(__GNUC__) || defined(__clang__)
+				return __builtin_sub_overflow(lhs, rhs, &result);
+#else
+				result = Sub<T>()(lhs, rhs);
+				if constexpr (std::is_signed<T>::value)
+					return rhs < 0 ? result < lhs : result > lhs;
+				else
+					return lhs < rhs;
+#endif
+			}
+			template <typename T>
+			bool MulOverflow(T lhs, T rhs, T &result) {
+#if defined(__GNUC__) || defined(__clang__)
+				return __builtin_mul_overflow(lhs, rhs, &result);
+#else
+				result = Mul<T>()(lhs, rhs);
+				if (lhs == 0)
+					return false;
+				if constexpr (std::is_signed<T>::value) {
+					if (lhs == -1)
+						return rhs == std::numeric_limits<T>::min();
+				}
+				return result / lhs != rhs;
+#endif
+			}
+
+			template <typename T>
+			struct CheckedAdd {
+				T operator()(T lhs, T rhs) const {
+					T result;
+					if (AddOverflow(lhs, rhs, result))
+						Overflow("add");
+					return result;
+				}
+			};
+			template <typename T>
+			struct CheckedSub {
+				T operator()(T lhs, T rhs) const {
+					T result;
+					if (SubOverflow(lhs, rhs, result))
+						Overflow("sub");
+					return result;
+				}
+			};
+			template <typename T>
+			struct CheckedMul {
+				T operator()(T lhs, T rhs) const {
+					T result;
+					if (MulOverflow(lhs, rhs, result))
+						Overflow("mul");
+					return result;
+				}
+			};
+			template <typename T>
+			struct CheckedDiv {
+				T operator()(T lhs, T rhs) const {
+					if (rhs == 0)
+						DivideByZero();
+					if (IsSignedMinDivision(lhs, rhs))
+						Overflow("div");
+					return static_cast<T>(lhs / rhs);
+				}
+			};
+			template <typename T>
+			struct CheckedNeg {
+				T operator()(T src) const {
+					T result;
+					if (SubOverflow(T(0), src, result))
+						Overflow("neg");
+					return result;
+				}
+			};
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "config.h"
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace MemoryKernel
+		{
+			using SizeType = Config::MemorySizeType;
+
+			//--------------------------------------
+			// * Fixed Size
+			//    The size is a compile-time constant, so the copy (or clear)
+			//    of 1/2/4/8/16 bytes is lowered to a single load/store.
+			//--------------------------------------
+
+			template <SizeType _size>
+			inline void CopyFixed(void *dst, const void *src) {
+				std::memcpy(dst, src, _size);
+			}
+			template <SizeType _size>
+			inline void ClearFixed(void *dst) {
+				std::memset(dst, 0, _size);
+			}
+
+			inline bool IsFixedSize(SizeType size) {
+				switch (size) {
+				case 1: case 2: case 4: case 8: case 16:
+					return true;
+				default:
+					return false;
+				}
+			}
+
+			//--------------------------------------
+			// * Large Size
+			//    Copy (or clear) by 32 bytes (AVX2) or 16 bytes (SSE2),
+			//    the tail is done by memcpy (memset).
+			//--------------------------------------
+
+			inline void CopyLarge(void *dst, const void *src, SizeType size) {
+				uint8_t *dp = static_cast<uint8_t*>(dst);
+				const uint8_t *sp = static_cast<const uint8_t*>(src);
+#if defined(__AVX2__)
+				for (; size >= 32; size -= 32, dp += 32, sp += 32) {
+					__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sp));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dp), v);
+				}
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+				for (; size >= 16; size -= 16, dp += 16, sp += 16) {
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sp));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dp), v);
+				}
+#endif
+				std::memcpy(dp, sp, size);
+			}
+			inline void ClearLarge(void *dst, SizeType size) {
+				uint8_t *dp = static_cast<uint8_t*>(dst);
+#if defined(__AVX2__)
+				for (; size >= 32; size -= 32, dp += 32) {
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dp), _mm256_setzero_si256());
+				}
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+				for (; size >= 16; size -= 16, dp += 16) {
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dp), _mm_setzero_si128());
+				}
+#endif
+				std::memset(dp, 0, size);
+			}
+
+			//--------------------------------------
+			// * Runtime Size
+			//    Dispatch to the fixed size kernels if possible.
+			//--------------------------------------
+
+			inline void Copy(void *dst, const void *src, SizeType size) {
+				switch (size) {
+				case 0: break;
+				case 1: CopyFixed<1>(dst, src); break;
+				case 2: CopyFixed<2>(dst, src); break;
+				case 4: CopyFixed<4>(dst, src); break;
+				case 8: CopyFixed<8>(dst, src); break;
+				case 16: CopyFixed<16>(dst, src); break;
+				default: CopyLarge(dst, src, size); break;
+				}
+			}
+			inline void Clear(void *dst, SizeType size) {
+				switch (size) {
+				case 0: break;
+				case 1: ClearFixed<1>(dst); break;
+				case 2: ClearFixed<2>(dst); break;
+				case 4: ClearFixed<4>(dst); break;
+				case 8: ClearFixed<8>(dst); break;
+				case 16: ClearFixed<16>(dst); break;
+				default: ClearLarge(dst, size); break;
+				}
+			}
+
+			//--------------------------------------
+			// * Bulk
+			//    The sizes up to 32 bytes are done by the loads of the head and the tail,
+			//    the larger ones by the loop of 32 bytes (AVX2) or 16 bytes,
+			//    and the large non-overlapping copies by 'rep movsb' (x86-64).
+			//--------------------------------------
+
+			// The same as memmove, dst and src may overlap.
+			void Move(void *dst, const void *src, SizeType size);
+			// Store the value (of valsize bytes) to dst for count times.
+			void Fill(void *dst, const void *value, SizeType valsize, uint64_t count);
+		}
+	}
+}
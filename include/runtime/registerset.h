@@ -54,26 +54,40 @@ namespace CVM
 		};
 
 		// The DataRegisterSet (Static) Class
+		//    Each register is placed at the offset aligned to the align of its type,
+		//    the address of the frame must be aligned to the max of them.
 		class DataRegisterSetStatic : public DataRegisterSetBase<DataRegisterStatic>
 		{
 		public:
-			using SizeList = PriLib::lightlist<MemorySize>;
+			struct RegisterLayout {
+				MemorySize size;
+				MemorySize align = MemorySize(1);
+			};
+			using LayoutList = PriLib::lightlist<RegisterLayout>;
 
 		public:
 			explicit DataRegisterSetStatic()
 				: DataRegisterSetBase() {}
 
-			explicit DataRegisterSetStatic(Config::RegisterIndexType size, DataPointer address, const SizeList &sizelist)
+			explicit DataRegisterSetStatic(Config::RegisterIndexType size, DataPointer address, const LayoutList &layoutlist)
 				: DataRegisterSetBase(size) {
-				initialize(address, sizelist);
+				initialize(address, layoutlist);
 			}
+
+			// Get the size and the align of the frame.
+			static MemorySize GetFrameSize(const LayoutList &layoutlist);
+			static MemorySize GetFrameAlign(const LayoutList &layoutlist);
 			MemorySize memsize() const {
 				return _memsize;
 			}
+			DataPointer address() const {
+				return _address;
+			}
 
 		private:
-			void initialize(DataPointer address, const SizeList &sizelist);
+			void initialize(DataPointer address, const LayoutList &layoutlist);
 			MemorySize _memsize;
+			DataPointer _address;
 		};
 
 		// The DataRegisterSet (Whole) Class
@@ -87,11 +101,11 @@ namespace CVM
 			explicit DataRegisterSet(DyDatRegSize dy_size)
 				: _dynamic(dy_size.data) {}
 
-			explicit DataRegisterSet(StDatRegSize st_size, DataPointer address, const DataRegisterSetStatic::SizeList &sizelist)
-				: _static(st_size.data, address, sizelist) {}
+			explicit DataRegisterSet(StDatRegSize st_size, DataPointer address, const DataRegisterSetStatic::LayoutList &layoutlist)
+				: _static(st_size.data, address, layoutlist) {}
 
-			explicit DataRegisterSet(DyDatRegSize dy_size, StDatRegSize st_size, DataPointer address, const DataRegisterSetStatic::SizeList &sizelist)
-				: _dynamic(dy_size.data), _static(st_size.data, address, sizelist) {}
+			explicit DataRegisterSet(DyDatRegSize dy_size, StDatRegSize st_size, DataPointer address, const DataRegisterSetStatic::LayoutList &layoutlist)
+				: _dynamic(dy_size.data), _static(st_size.data, address, layoutlist) {}
 
 			bool is_dynamic(Config::RegisterIndexType id) {
 				return Config::is_dynamic(id, dysize(), stsize());
@@ -118,6 +132,9 @@ namespace CVM
 			MemorySize stmemsize() const {
 				return _static.memsize();
 			}
+			DataPointer staddress() const {
+				return _static.address();
+			}
 
 		private:
 			DataRegisterSetDynamic _dynamic;
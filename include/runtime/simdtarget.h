@@ -0,0 +1,12 @@
+// simdtarget.h
+// * This file provides the macros of the x86 SIMD kernels (runtime/vectorkernel.cpp, runtime/textkernel.cpp).
+//   The kernels are compiled for SSE2/AVX2 by function, whatever the target of the file,
+//   and are selected by the level detected at runtime (VectorKernel::GetLevel).
+
+#pragma once
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CVM_SIMD_X86
+#define CVM_TARGET_SSE2 __attribute__((target("sse2")))
+#define CVM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
@@ -0,0 +1,32 @@
+// slice.h
+// * This file provides the values of cms#slice.
+//   A slice is a view of the elements (of the same type) in the memory, it doesn't own the elements.
+//   The element type is recorded in the value, and is checked with the type of the accessing register.
+
+#pragma once
+#include <cstdint>
+#include "config.h"
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace Slice
+		{
+			// The cleared value is the empty slice (of cms#void).
+			struct alignas(8) SliceValue {
+				uint8_t *data;
+				Config::MemoryCountType length;  // The count of elements.
+				Config::TypeIndexType elemtype;
+			};
+
+			constexpr size_t ValueSize = 16;
+
+			static_assert(sizeof(SliceValue) == ValueSize, "The size of SliceValue must be ValueSize.");
+
+			[[noreturn]] void IndexOutOfRange(uint64_t index, Config::MemoryCountType length);
+			[[noreturn]] void LengthOutOfRange(uint64_t length);
+			[[noreturn]] void ElementTypeMismatch(Config::TypeIndexType elemtype, Config::TypeIndexType expecttype);
+		}
+	}
+}
@@ -0,0 +1,71 @@
+// stringvalue.h
+// * This file provides the values of cms#string.
+//   The short string (at most ShortCapacity bytes) is stored in the value.
+//   The long string refers to the immutable characters, which are shared by the copies and the substrings,
+//   and are allocated by the collector (Collector::Alloc), or owned by the literal data or the string table.
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "config.h"
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace String
+		{
+			// Short: bytes[0, length) are the characters, bytes[TagOffset] is the length.
+			// Long: the pointer to the characters and the length (MemoryCountType) are at the beginning,
+			//       bytes[TagOffset] is LongTag.
+			// The cleared value is the empty string.
+			struct alignas(8) StringValue {
+				char bytes[16];
+			};
+
+			constexpr size_t ValueSize = 16;
+			constexpr size_t TagOffset = ValueSize - 1;
+			constexpr size_t ShortCapacity = TagOffset;
+			constexpr uint8_t LongTag = 0xFF;
+
+			static_assert(sizeof(StringValue) == ValueSize, "The size of StringValue must be ValueSize.");
+			static_assert(sizeof(const char*) + sizeof(Config::MemoryCountType) <= TagOffset, "The long string must fit in StringValue.");
+
+			inline bool IsShort(const StringValue &value) {
+				return static_cast<uint8_t>(value.bytes[TagOffset]) != LongTag;
+			}
+			inline size_t GetLength(const StringValue &value) {
+				if (IsShort(value))
+					return static_cast<uint8_t>(value.bytes[TagOffset]);
+				Config::MemoryCountType length;
+				std::memcpy(&length, value.bytes + sizeof(const char*), sizeof(length));
+				return length;
+			}
+			// The characters of the short string are in the value.
+			inline const char* GetData(const StringValue &value) {
+				if (IsShort(value))
+					return value.bytes;
+				const char *data;
+				std::memcpy(&data, value.bytes, sizeof(data));
+				return data;
+			}
+
+			// Copy the characters if they fit in the short string, otherwise refer to them.
+			StringValue Make(const char *data, size_t length);
+			// The characters before the first NUL (or all the data if no NUL).
+			StringValue FromLiteral(const uint8_t *data, size_t size);
+
+			void Concat(StringValue &dst, const StringValue &lhs, const StringValue &rhs);
+			// Return -1, 0 or 1 by the bytes (as unsigned char), the shorter prefix is less.
+			int Compare(const StringValue &lhs, const StringValue &rhs);
+			// FNV-1a of the characters.
+			uint64_t Hash(const StringValue &value);
+			// The substring of 'length' characters from 'start', they must be in the range of src.
+			void Substring(StringValue &dst, const StringValue &src, uint64_t start, uint64_t length);
+			// The equal strings interned are the same characters (so they are compared by the pointer).
+			StringValue Intern(const StringValue &value);
+
+			[[noreturn]] void RangeError(uint64_t start, uint64_t length, size_t srclength);
+		}
+	}
+}
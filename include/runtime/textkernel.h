@@ -0,0 +1,28 @@
+// textkernel.h
+// * This file provides the kernels of scanning and case folding the text (bytes),
+//   implemented by AVX2/SSE2 (by the level of VectorKernel) with a scalar fallback.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace TextKernel
+		{
+			constexpr size_t NotFound = SIZE_MAX;
+
+			// Return the index of the first byte, or NotFound.
+			size_t FindByte(const char *data, size_t size, char byte);
+			// Return the index of the first occurrence of needle, or NotFound.
+			// The empty needle is found at 0.
+			size_t Find(const char *data, size_t size, const char *needle, size_t needlesize);
+			size_t CountByte(const char *data, size_t size, char byte);
+			// Fold the ASCII letters, other bytes are copied. dst may be the same as src.
+			void ToLower(char *dst, const char *src, size_t size);
+			void ToUpper(char *dst, const char *src, size_t size);
+		}
+	}
+}
@@ -0,0 +1,72 @@
+// vectorkernel.h
+// * This file provides the lane-wise kernels of the vector types (cms#v128, cms#v256),
+//   implemented by AVX2/SSE2 (selected by the CPU at runtime) with a scalar fallback.
+
+#pragma once
+#include <cstdint>
+#include "config.h"
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace VectorKernel
+		{
+			using SizeType = Config::MemorySizeType;
+
+			enum VectorLevel
+			{
+				vl_scalar,
+				vl_sse2,
+				vl_avx2,
+			};
+
+			enum VectorOp
+			{
+				vo_add,
+				vo_sub,
+				vo_mul,
+				vo_min,
+				vo_max,
+				vo_eq,   // All bits of the lane are set if equal, otherwise cleared.
+				vo_lt,   // All bits of the lane are set if less, otherwise cleared.
+			};
+
+			enum LaneType
+			{
+				lt_int8,
+				lt_int16,
+				lt_int32,
+				lt_int64,
+				lt_uint8,
+				lt_uint16,
+				lt_uint32,
+				lt_uint64,
+				lt_float32,
+				lt_float64,
+			};
+
+			// The level is detected once, and can only be lowered by SetLevel.
+			// The kernels are selected when the instructions are compiled.
+			VectorLevel GetDetectedLevel();
+			void SetLevel(VectorLevel level);
+			VectorLevel GetLevel();
+			bool ParseLevel(const char *str, VectorLevel &level);
+
+			// The operands are vectors of 'size' (16 or 32) bytes, any of them may be the same one.
+			using BinaryKernel = void (*)(void *dst, const void *lhs, const void *rhs);
+			// dst[i] = src[idx[i]]
+			using ShuffleKernel = void (*)(void *dst, const void *src, const void *idx);
+			// dst is a lane of src.
+			using ReduceKernel = void (*)(void *dst, const void *src);
+
+			// dst[i] = lhs[i] op rhs[i]
+			BinaryKernel GetBinaryKernel(VectorOp op, LaneType lane, SizeType size);
+			// dst[i] = idx[i] < lanecount ? src[idx[i]] : 0
+			// The index is the unsigned integer of the lane size.
+			ShuffleKernel GetShuffleKernel(LaneType lane, SizeType size);
+			// Reduce by add/min/max in the order of halving (the upper half to the lower half).
+			ReduceKernel GetReduceKernel(VectorOp op, LaneType lane, SizeType size);
+		}
+	}
+}
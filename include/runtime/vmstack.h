@@ -0,0 +1,74 @@
+// vmstack.h
+// * This file provides the VM stack, the memory of the stack registers (%sp).
+//   Each thread has its own stack, growing down from the end of a fixed-size buffer.
+//   'salloc' moves the top down (bump allocation), 'sfree' and the decreasing spaces (%sp(n)!) move it up,
+//   and the memory allocated by a function is released when it returns.
+//   The allocations are checked, the accesses by %sp are not (the same as the hardware stack).
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace VMStack
+		{
+			constexpr size_t DefaultSize = 1024 * 1024;
+			// The sizes are rounded up to it, so the values allocated by their types are aligned.
+			constexpr size_t Align = 8;
+
+			struct StackState
+			{
+				uint8_t *begin = nullptr;
+				uint8_t *top = nullptr;   // The value of %sp.
+				uint8_t *base = nullptr;  // The top when the current function is called.
+				uint8_t *end = nullptr;
+			};
+
+			extern thread_local StackState CurrentStack;
+
+			// Set the size (in bytes) of the stacks created after.
+			void SetSize(size_t size);
+			size_t GetSize();
+
+			[[noreturn]] void Overflow(size_t size);
+			[[noreturn]] void Underflow(size_t size);
+
+			// Enter the frame of a function, the stack of the thread is created by the first call.
+			// Return the base of the caller, which is restored by Leave.
+			uint8_t* Enter();
+
+			inline void Leave(uint8_t *callerbase) {
+				CurrentStack.top = CurrentStack.base;
+				CurrentStack.base = callerbase;
+			}
+
+			inline size_t AlignSize(size_t size) {
+				return (size + (Align - 1)) & ~(Align - 1);
+			}
+
+			inline uint8_t* Top() {
+				return CurrentStack.top;
+			}
+
+			inline void Allocate(size_t size) {
+				StackState &stack = CurrentStack;
+				size = AlignSize(size);
+				if (static_cast<size_t>(stack.top - stack.begin) < size)
+					Overflow(size);
+				stack.top -= size;
+			}
+
+			// Only the memory allocated by the current function can be released.
+			inline void Release(size_t size) {
+				StackState &stack = CurrentStack;
+				size = AlignSize(size);
+				if (static_cast<size_t>(stack.base - stack.top) < size)
+					Underflow(size);
+				stack.top += size;
+			}
+		}
+	}
+}
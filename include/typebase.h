@@ -16,6 +16,14 @@ namespace CVM
 		T_Pointer,
 		T_Function,
 		T_Environment,
-		T_VirtualMachine
+		T_VirtualMachine,
+		T_Float32,
+		T_Float64,
+		T_V128,
+		T_V256,
+		T_BigInt,
+		T_Slice,
+		T_String,
+		T_Map
 	};
 }
@@ -1,7 +1,7 @@
 #pragma once
 #include "../prilib/include/explicittype.h"
 #include <cstdint>
-#include <map>
+#include <cassert>
 #include <vector>
 #include <limits>
 #include "config.h"
@@ -108,8 +108,74 @@ namespace CVM
 		TypeIndex index;
 		MemorySize size;
 		TypeNameID name;
+		MemorySize align = MemorySize(1);
+		// The fields of the type are [fieldbegin, fieldbegin + fieldcount) in TypeInfoMap.
+		Config::TypeIndexType fieldbegin = 0;
+		Config::TypeIndexType fieldcount = 0;
+		// The registers of the type must start cleared (the cleared value is valid, e.g. cms#bigint), so do the types with its fields.
+		bool needclear = false;
 	};
 
+	struct FieldInfo
+	{
+		TypeNameID name;
+		TypeIndex type;
+		MemorySize offset;
+	};
+
+	//--------------------------------------
+	// * BuiltinTypes
+	//    The builtin types have the fixed indices (the same as TypeInside) in every TypeInfoMap.
+	//--------------------------------------
+	struct BuiltinTypeInfo
+	{
+		TypeInside index;
+		Config::MemorySizeType size;
+		const char *name;
+	};
+
+	constexpr Config::MemorySizeType PointerTypeSize = sizeof(void*);
+
+	constexpr BuiltinTypeInfo BuiltinTypes[] = {
+		{ T_Void, 0, "cms#void" },
+		{ T_Int8, 1, "cms#int8" },
+		{ T_Int16, 2, "cms#int16" },
+		{ T_Int32, 4, "cms#int32" },
+		{ T_Int64, 8, "cms#int64" },
+		{ T_UInt8, 1, "cms#uint8" },
+		{ T_UInt16, 2, "cms#uint16" },
+		{ T_UInt32, 4, "cms#uint32" },
+		{ T_UInt64, 8, "cms#uint64" },
+		{ T_Pointer, PointerTypeSize, "cms#pointer" },
+		{ T_Function, PointerTypeSize, "cms#function" },
+		{ T_Environment, PointerTypeSize, "cms#environment" },
+		{ T_VirtualMachine, PointerTypeSize, "cms#virtualmachine" },
+		{ T_Float32, 4, "cms#float32" },
+		{ T_Float64, 8, "cms#float64" },
+		{ T_V128, 16, "cms#v128" },
+		{ T_V256, 32, "cms#v256" },
+		{ T_BigInt, 16, "cms#bigint" },
+		{ T_Slice, 16, "cms#slice" },
+		{ T_String, 16, "cms#string" },
+		{ T_Map, PointerTypeSize, "cms#map" },
+	};
+
+	constexpr size_t BuiltinTypeCount = sizeof(BuiltinTypes) / sizeof(BuiltinTypes[0]);
+
+	constexpr bool CheckBuiltinTypes() {
+		for (size_t i = 0; i != BuiltinTypeCount; ++i)
+			if (static_cast<size_t>(BuiltinTypes[i].index) != i)
+				return false;
+		return true;
+	}
+	static_assert(CheckBuiltinTypes(), "The index of builtin type must be the same as TypeInside.");
+
+	//--------------------------------------
+	// * TypeInfoMap
+	//    The types are in a flat vector indexed by TypeIndex, the builtin types come first.
+	//    The names are found by an open addressing (linear probing) hash table of the indices.
+	//    The fields of all the types are in another flat vector, the fields of a type are adjacent.
+	//--------------------------------------
 	class TypeInfoMap
 	{
 	public:
@@ -117,28 +183,47 @@ namespace CVM
 
 		bool insert(const HashID &nameid, const TypeInfo &info);
 		bool find(const HashID &nameid, TypeIndex &id) const {
-			auto iter = _keymap.find(nameid);
-			if (iter != _keymap.end()) {
-				id.data = iter->second;
-				return true;
+			size_t mask = _slots.size() - 1;
+			for (size_t i = Hash(nameid) & mask; _slots[i] != EmptySlot; i = (i + 1) & mask) {
+				if (_data[_slots[i]].name == nameid) {
+					id.data = _slots[i];
+					return true;
+				}
 			}
 			return false;
 		}
 		const TypeInfo& at(TypeIndex id) const {
-			return _data.at(id.data);
+			assert(id.data < _data.size());
+			return _data[id.data];
 		}
 		const TypeInfo& at(const HashID &nameid) const {
 			TypeIndex id;
 			bool result = find(nameid, id);
 			assert(result);
-			return _data.at(id.data);
+			return _data[id.data];
 		}
 		TypeInfo& at(const HashID &nameid) {
 			return const_cast<TypeInfo&>(const_cast<const TypeInfoMap*>(this)->at(nameid));
 		}
 
+		// Append the field to the type (which must be the last one with fields) and update its layout.
+		// The field is placed after the last one (aligned) if 'offset' is nullptr.
+		// Return false if the field name is duplicate.
+		bool addField(TypeIndex type, const HashID &fieldname, TypeIndex fieldtype, const MemorySize *offset);
+		bool findField(TypeIndex type, const HashID &fieldname, FieldInfo &result) const;
+
 	private:
-		std::map<HashID, Config::TypeIndexType> _keymap;
+		static constexpr Config::TypeIndexType EmptySlot = std::numeric_limits<Config::TypeIndexType>::max();
+		static constexpr size_t MinSlotCount = 32;
+
+		static size_t Hash(const HashID &nameid) {
+			return static_cast<size_t>((static_cast<uint64_t>(nameid) * 0x9E3779B97F4A7C15ull) >> 32);
+		}
+		void place(Config::TypeIndexType index);
+		void rehash(size_t slotcount);
+
+		std::vector<Config::TypeIndexType> _slots;
 		std::vector<TypeInfo> _data;
+		std::vector<FieldInfo> _fields;
 	};
 }
@@ -17,10 +17,21 @@ namespace CVM
 			return *_genv;
 		}
 
+		void addThreadEnvironment(Runtime::ThreadEnvironment *tenv) {
+			_tenv = std::shared_ptr<Runtime::ThreadEnvironment>(tenv);
+		}
+
+		Runtime::ThreadEnvironment& Tenv() {
+			return *_tenv;
+		}
+
 		void Call(Runtime::LocalEnvironment *env);
 		void Launch();
+		// Mark the memory of the dynamic registers for the collector.
+		void MarkRoots();
 
 		std::shared_ptr<Runtime::GlobalEnvironment> _genv;
+		std::shared_ptr<Runtime::ThreadEnvironment> _tenv;  // The environment of the main thread.
 		Runtime::LocalEnvironment *_currenv = nullptr;
 	};
 }
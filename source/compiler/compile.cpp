@@ -4,6 +4,15 @@
 #include "runtime/datamanage.h"
 #include "datapool.h"
 #include "runtime/instdef.hpp"
+#include "runtime/heapprofile.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
 
 namespace CVM
 {
@@ -18,7 +27,7 @@ namespace CVM
 	}
 
 	// Temp func
-	static bool check(const std::vector<InstStruct::Element> &list, const std::vector<InstStruct::ElementType> &et) {
+	static bool check(const InstStruct::ElementList &list, const std::vector<InstStruct::ElementType> &et) {
 		if (list.size() != et.size())
 			return false;
 		for (size_t i = 0; i != list.size(); ++i) {
@@ -29,7 +38,183 @@ namespace CVM
 	}
 
 	namespace Compile {
-		static Runtime::Instruction* const NopeInst = new Runtime::Insts::Nope();
+		static Runtime::Insts::Nope _nopeInst;
+		static Runtime::Instruction* const NopeInst = &_nopeInst;
+
+		// TEMP
+		TypeInfoMap *_ptypeInfoMap = nullptr;  // TODO!!
+		const HashStringPool *_phashStringPool = nullptr;  // TODO!!
+		InstStruct::IdentKeyTable *_pfuncTable = nullptr;  // TODO!!
+		const LiteralDataPool *_pliteralDataPool = nullptr;  // TODO!!
+		const Runtime::IntrinsicMap *_pintrinsicMap = nullptr;  // TODO!!
+		const Runtime::PtrFuncMap *_pptrFuncMap = nullptr;  // TODO!!
+		const std::vector<TypeIndex> *_pglobalTypeList = nullptr;  // TODO!!
+		const std::vector<TypeIndex> *_pthreadTypeList = nullptr;  // TODO!!
+
+		// The static register is a local static register of the function,
+		// or a static global (%g) / thread (%t) register declared in '.program'.
+		static bool isStaticRegister(const InstStruct::Register &reg, const FunctionInfo &info) {
+			if (reg.isPrivateDataRegister())
+				return info.is_stvarb(reg.index());
+			if (!reg.isScopedDataRegister() || reg.registerType == InstStruct::rt_data_dynamic)
+				return false;
+			auto index = reg.index();
+			const auto &typelist = Config::is_global(index) ? *_pglobalTypeList : *_pthreadTypeList;
+			auto id = Config::get_scoped_id(index);
+			return 0 < id && id <= typelist.size();
+		}
+
+		static TypeIndex getStvarbType(const FunctionInfo &info, Config::RegisterIndexType index) {
+			if (Config::is_scoped(index)) {
+				const auto &typelist = Config::is_global(index) ? *_pglobalTypeList : *_pthreadTypeList;
+				return typelist[Config::get_scoped_id(index) - 1];
+			}
+			return info.get_stvarb_type(index);
+		}
+
+		// Create the size-specialized instruction if the size is 1/2/4/8/16 bytes,
+		// otherwise return nullptr.
+		template <template <Runtime::MemoryKernel::SizeType> typename InstType, typename... Args>
+		static Runtime::Instruction* createFixedSizeInst(MemorySize size, Args... args) {
+			switch (size.data) {
+			case 1: return new InstType<1>(args...);
+			case 2: return new InstType<2>(args...);
+			case 4: return new InstType<4>(args...);
+			case 8: return new InstType<8>(args...);
+			case 16: return new InstType<16>(args...);
+			default: return nullptr;
+			}
+		}
+
+		template <Runtime::MemoryKernel::SizeType _size>
+		using LoadDataDs1Fixed = Runtime::Insts::LoadDataDsFixed<1, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using LoadDataDs2Fixed = Runtime::Insts::LoadDataDsFixed<2, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using LoadDataDs3Fixed = Runtime::Insts::LoadDataDsFixed<3, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using LoadDataDs4Fixed = Runtime::Insts::LoadDataDsFixed<4, _size>;
+
+		// The space of a stack space register, type is 0 for the spaces by size,
+		// size is 0 for the full space (%sp(), %sp[offset]()).
+		struct StackSpace {
+			Config::StackOffsetType offset;
+			MemorySize size;
+			TypeIndex type;
+			bool release;
+		};
+
+		static bool checkLocalStack(const InstStruct::Register &reg) {
+			if (reg.scopeType != InstStruct::rst_local) {
+				println("Error compile with non-local stack register.");
+				return false;
+			}
+			return true;
+		}
+
+		static bool getStackSpace(const InstStruct::Register &reg, StackSpace &result) {
+			if (!checkLocalStack(reg))
+				return false;
+			auto &data = std::get<InstStruct::StackSpaceRegisterBase>(reg.data);
+			result.offset = data.offset.data;
+			result.size = MemorySize(0);
+			result.type = TypeIndex(0);
+			result.release = reg.registerType == InstStruct::rt_stack_space_size_decrease || reg.registerType == InstStruct::rt_stack_space_type_decrease;
+			switch (reg.registerType) {
+			case InstStruct::rt_stack_space_full:
+				break;
+			case InstStruct::rt_stack_space_size:
+			case InstStruct::rt_stack_space_size_decrease:
+				result.size = MemorySize(data.stacksize.data);
+				break;
+			default:
+				if (!_ptypeInfoMap->find(data.typehashid, result.type)) {
+					println("Error compile with stack space of undefined type.");
+					return false;
+				}
+				result.size = _ptypeInfoMap->at(result.type).size;
+				break;
+			}
+			return true;
+		}
+
+		template <Runtime::MemoryKernel::SizeType _size>
+		using LoadStackKeepFixed = Runtime::Insts::LoadStackFixed<false, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using LoadStackReleaseFixed = Runtime::Insts::LoadStackFixed<true, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using StoreStackKeepFixed = Runtime::Insts::StoreStackFixed<false, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using StoreStackReleaseFixed = Runtime::Insts::StoreStackFixed<true, _size>;
+
+		template <template <Runtime::MemoryKernel::SizeType> typename FixedInstType, typename InstType>
+		static Runtime::Instruction* createStackInst(Config::RegisterIndexType val, Config::StackOffsetType offset, MemorySize size) {
+			if (auto fixedinst = createFixedSizeInst<FixedInstType>(size, val, offset))
+				return fixedinst;
+			return new InstType(val, offset, size);
+		}
+
+		// mov %val, %sp[offset]
+		// mov %val, %sp[offset](n|Type)
+		// mov %sp[offset](n|Type), %val
+		// The register must be static, and of cms#pointer for %sp[offset].
+		// The space must be of the size of its type (of the same type for Type),
+		// the decreasing spaces (%sp(n)!, %sp(Type)!) are released after the access.
+		static Runtime::Instruction* compile_MoveStack(const InstStruct::Register &dst, const InstStruct::Register &src, const FunctionInfo &info) {
+			bool isstore = InstStruct::is_rt_stack(dst.registerType);
+			auto &stack = isstore ? dst : src;
+			auto &val = isstore ? src : dst;
+			if (!isStaticRegister(val, info)) {
+				println("Error compile with stack access of non-static register.");
+				return NopeInst;
+			}
+			if (!checkLocalStack(stack))
+				return NopeInst;
+			auto val_id = val.index();
+			TypeIndex type = getStvarbType(info, val_id);
+
+			if (InstStruct::is_rt_stack_pointer(stack.registerType)) {
+				if (isstore) {
+					println("Error compile with store to stack pointer.");
+					return NopeInst;
+				}
+				if (type.data != T_Pointer) {
+					println("Error compile with stack pointer to non-pointer register.");
+					return NopeInst;
+				}
+				return new Runtime::Insts::LoadStackPointer(val_id, std::get<InstStruct::StackPointerRegisterBase>(stack.data).offset.data);
+			}
+
+			StackSpace space;
+			if (!getStackSpace(stack, space))
+				return NopeInst;
+			MemorySize size = _ptypeInfoMap->at(type).size;
+			if (space.type.data != 0 ? space.type.data != type.data : space.size.data != size.data) {
+				println("Error compile with stack space mismatch with the register.");
+				return NopeInst;
+			}
+			if (isstore) {
+				if (space.release)
+					return createStackInst<StoreStackReleaseFixed, Runtime::Insts::StoreStack<true>>(val_id, space.offset, size);
+				return createStackInst<StoreStackKeepFixed, Runtime::Insts::StoreStack<false>>(val_id, space.offset, size);
+			}
+			else {
+				if (space.release)
+					return createStackInst<LoadStackReleaseFixed, Runtime::Insts::LoadStack<true>>(val_id, space.offset, size);
+				return createStackInst<LoadStackKeepFixed, Runtime::Insts::LoadStack<false>>(val_id, space.offset, size);
+			}
+		}
+
+		static Runtime::Instruction* createMoveStatic(Config::RegisterIndexType dst_id, Config::RegisterIndexType src_id, const FunctionInfo &info) {
+			if (getStvarbType(info, dst_id).data != getStvarbType(info, src_id).data) {
+				println("Error must be same type with two static data registers.");
+				return NopeInst;
+			}
+			MemorySize size = _ptypeInfoMap->at(getStvarbType(info, src_id)).size;
+			if (auto fixedinst = createFixedSizeInst<Runtime::Insts::MoveRegisterDsDsFixed>(size, dst_id, src_id))
+				return fixedinst;
+			return new Runtime::Insts::MoveRegisterDsDs(dst_id, src_id, size);
+		}
 
 		static Runtime::Instruction* compile_Move(const InstStruct::Instruction &inst, const FunctionInfo &info) {
 			if (!check(inst.data, { InstStruct::ET_Register, InstStruct::ET_Register }))
@@ -54,16 +239,15 @@ namespace CVM
 					return new Runtime::Insts::MoveRegisterDsDd(dst_id, src_id);
 				}
 				else if (info.is_dyvarb(dst_id) && info.is_stvarb(src_id)) {
-					return new Runtime::Insts::MoveRegisterDdDs(dst_id, src_id, info.get_stvarb_type(src_id));
+					return new Runtime::Insts::MoveRegisterDdDs(dst_id, src_id, getStvarbType(info, src_id));
 				}
 				else if (info.is_stvarb(dst_id) && info.is_stvarb(src_id)) {
-					if (info.get_stvarb_type(dst_id).data != info.get_stvarb_type(src_id).data) {
-						println("Error must be same type with two static data registers.");
-						return NopeInst;
-					}
-					return new Runtime::Insts::MoveRegisterDsDs(dst_id, src_id, info.get_stvarb_type(src_id));
+					return createMoveStatic(dst_id, src_id, info);
 				}
 			}
+			else if (isStaticRegister(dst, info) && isStaticRegister(src, info)) {
+				return createMoveStatic(dst.index(), src.index(), info);
+			}
 			else if (dst.isResultRegister() && src.isPrivateDataRegister()) {
 				auto src_id = src.index();
 
@@ -71,7 +255,8 @@ namespace CVM
 					return new Runtime::Insts::MoveRegisterDdRes(src_id, info.get_accesser().result_type());
 				}
 				else if (info.is_stvarb(src_id)) {
-					return new Runtime::Insts::MoveRegisterDsRes(src_id, info.get_accesser().result_type());
+					TypeIndex restype = info.get_accesser().result_type();
+					return new Runtime::Insts::MoveRegisterDsRes(src_id, restype, _ptypeInfoMap->at(restype).size);
 				}
 			}
 			else if (dst.isPrivateDataRegister() && src.isResultRegister()) {
@@ -81,11 +266,16 @@ namespace CVM
 					return new Runtime::Insts::MoveRegisterResDd(dst_id);
 				}
 				else if (info.is_stvarb(dst_id)) {
-					return new Runtime::Insts::MoveRegisterResDs(dst_id, info.get_stvarb_type(dst_id));
+					TypeIndex type = getStvarbType(info, dst_id);
+					return new Runtime::Insts::MoveRegisterResDs(dst_id, type, _ptypeInfoMap->at(type).size);
 				}
 			}
+			else if (InstStruct::is_rt_stack(dst.registerType) != InstStruct::is_rt_stack(src.registerType)) {
+				return compile_MoveStack(dst, src, info);
+			}
 			else {
-				assert(false);
+				println("Error compile with illegal registers of mov.");
+				return NopeInst;
 			}
 
 			return NopeInst;
@@ -99,10 +289,6 @@ namespace CVM
 			return true;
 		}
 		
-		// TEMP
-		TypeInfoMap *_ptypeInfoMap = nullptr;  // TODO!!
-		InstStruct::IdentKeyTable *_pfuncTable = nullptr;  // TODO!!
-
 		static TypeIndex parseType(TypeInfoMap &typeInfoMap, const InstStruct::Element &elt) {
 			TypeIndex index;
 			if (typeInfoMap.find(elt.get<InstStruct::Identifier>().data(), index)) {
@@ -114,20 +300,144 @@ namespace CVM
 			}
 		}
 
-		// TODO
-		static uint32_t parseData(const InstStruct::Element &elt) {
+		// Check the data label is defined in LiteralDataPool.
+		static bool parseDataLabel(const InstStruct::Element &elt, DataID &result) {
+			DataID dataid(elt.get<InstStruct::DataLabel>().data());
+			if (dataid.data == 0 || !_pliteralDataPool->has(FileID(0), dataid)) {
+				println("Error compile with undefined data label #", dataid.data, ".");
+				return false;
+			}
+			result = dataid;
+			return true;
+		}
+
+		static bool isFloatType(TypeIndex type) {
+			return type.data == T_Float32 || type.data == T_Float64;
+		}
+
+		static bool isIntegerType(TypeIndex type) {
+			return T_Int8 <= type.data && type.data <= T_UInt64;
+		}
+
+		static void encodeFloat(double value, TypeIndex type, Runtime::Insts::ImmediateData &result) {
+			if (type.data == T_Float32) {
+				float v = static_cast<float>(value);
+				std::memcpy(result.data, &v, sizeof(v));
+				result.size = MemorySize(sizeof(v));
+			}
+			else {
+				std::memcpy(result.data, &value, sizeof(value));
+				result.size = MemorySize(sizeof(value));
+			}
+		}
+
+		// Encode the integer as the value of the type (in native byte order).
+		// Integer types are range checked by their signedness, float types get the (rounded) value,
+		// cms#bigint is encoded as int64 (its inline value), other types are treated as unsigned.
+		// The float is only for the float types.
+		static bool parseImmediate(const InstStruct::Element &elt, TypeIndex type, Runtime::Insts::ImmediateData &result) {
+			if (elt.type() == InstStruct::ET_FloatData) {
+				if (!isFloatType(type)) {
+					println("Error compile with float immediate of non-float type.");
+					return false;
+				}
+				encodeFloat(elt.get<InstStruct::FloatData>().data(), type, result);
+				return true;
+			}
 			auto &data = elt.get<InstStruct::IntegerData>();
-			if (data.data().size() <= sizeof(uint32_t)) {
-				uint32_t result = 0;
-				if (data.data().toBuffer(&result, sizeof(result)))
-					return result;
+			uint64_t magnitude;
+			bool negative;
+			if (!data.get_inline(magnitude, negative)) {
+				println("Error compile with immediate larger than 64 bits.");
+				return false;
+			}
+			if (isFloatType(type)) {
+				double value = static_cast<double>(magnitude);
+				encodeFloat(negative ? -value : value, type, result);
+				return true;
+			}
+			bool is_signed = (T_Int8 <= type.data && type.data <= T_Int64) || type.data == T_BigInt;
+			size_t size = std::min<size_t>(_ptypeInfoMap->at(type).size.data, sizeof(result.data));
+			uint64_t umax = size == 8 ? UINT64_MAX : (uint64_t(1) << (size * 8)) - 1;
+			uint64_t value;
+			if (negative) {
+				if (!is_signed || magnitude > (umax >> 1) + 1) {
+					println("Error compile with immediate out of range of the type.");
+					return false;
+				}
+				value = ~magnitude + 1;
+			}
+			else {
+				if (magnitude > umax) {
+					println("Error compile with immediate out of range of the type.");
+					return false;
+				}
+				value = magnitude;
+			}
+			switch (size) {
+			case 1: { uint8_t v = static_cast<uint8_t>(value); std::memcpy(result.data, &v, size); break; }
+			case 2: { uint16_t v = static_cast<uint16_t>(value); std::memcpy(result.data, &v, size); break; }
+			case 4: { uint32_t v = static_cast<uint32_t>(value); std::memcpy(result.data, &v, size); break; }
+			case 8: { std::memcpy(result.data, &value, size); break; }
+			default:
+				for (size_t i = 0; i != size; ++i)
+					result.data[i] = static_cast<uint8_t>(value >> (i * 8));
+				break;
+			}
+			result.size = MemorySize(size);
+			return true;
+		}
+
+		template <size_t _subid, template <Runtime::MemoryKernel::SizeType> typename FixedInstType>
+		static Runtime::Instruction* createLoadDataDs(Config::RegisterIndexType dst_id, TypeIndex type, MemorySize size, typename Runtime::Insts::LoadData<_subid>::DataType data) {
+			// TODO!!! type & dsttype is different !
+			if (auto fixedinst = createFixedSizeInst<FixedInstType>(size, dst_id, type, size, data))
+				return fixedinst;
+			return new Runtime::Insts::LoadDataDs<_subid>(dst_id, type, size, data);
+		}
+
+		template <size_t _subid, template <Runtime::MemoryKernel::SizeType> typename FixedInstType>
+		static Runtime::Instruction* createLoadData(const InstStruct::Register &dst, const FunctionInfo &info, TypeIndex type, typename Runtime::Insts::LoadData<_subid>::DataType data) {
+			MemorySize size = _ptypeInfoMap->at(type).size;
+			if (dst.isPrivateDataRegister()) {
+				auto dst_id = dst.index();
+				if (info.is_dyvarb(dst_id)) {
+					return new Runtime::Insts::LoadDataDd<_subid>(dst_id, type, size, data);
+				}
+				else if (info.is_stvarb(dst_id)) {
+					return createLoadDataDs<_subid, FixedInstType>(dst_id, type, size, data);
+				}
+				else {
+					assert(false);
+				}
+			}
+			else if (isStaticRegister(dst, info)) {
+				return createLoadDataDs<_subid, FixedInstType>(dst.index(), type, size, data);
+			}
+			else if (dst.isResultRegister()) {
+				// TODO!!! type & restype is different !
+				return new Runtime::Insts::LoadDataRes<_subid>(type, size, data);
+			}
+			else {
+				assert(false);
 			}
-			println("Error parse uint32 data.");
-			return 0;
+			return NopeInst;
+		}
+
+		// The string literal is the data before the first NUL, referred by the value without copying.
+		// The value is created once, by the first execution if the literal is compressed.
+		static Runtime::Instruction* createLoadString(const InstStruct::Register &dst, const FunctionInfo &info, TypeIndex type, DataID dataid) {
+			if (auto lazy = _pliteralDataPool->lazy(FileID(0), dataid))
+				return createLoadData<4, LoadDataDs4Fixed>(dst, info, type, lazy);
+			auto literal = _pliteralDataPool->at(FileID(0), dataid);
+			auto *value = new Runtime::String::StringValue(Runtime::String::FromLiteral(literal.first, literal.second.data));
+			auto data = std::make_pair(reinterpret_cast<const uint8_t*>(value), MemorySize(Runtime::String::ValueSize));
+			return createLoadData<2, LoadDataDs2Fixed>(dst, info, type, data);
 		}
 
 		static Runtime::Instruction* compile_Load(const InstStruct::Instruction &inst, const FunctionInfo &info) {
-			if (check(inst.data, { InstStruct::ET_Register, InstStruct::ET_IntegerData, InstStruct::ET_Identifier })) {
+			if (check(inst.data, { InstStruct::ET_Register, InstStruct::ET_IntegerData, InstStruct::ET_Identifier }) ||
+			    check(inst.data, { InstStruct::ET_Register, InstStruct::ET_FloatData, InstStruct::ET_Identifier })) {
 
 				if (!check_dst_is_not_zero(inst)) {
 					return NopeInst;
@@ -135,30 +445,31 @@ namespace CVM
 
 				TypeIndex type = parseType(*_ptypeInfoMap, inst.data[2]);
 
-				auto data = parseData(inst.data[1]);
-
 				auto &dst = inst.data[0].get<InstStruct::Register>();
 
-				if (dst.isPrivateDataRegister()) {
-					auto dst_id = dst.index();
-					if (info.is_dyvarb(dst_id)) {
-						return new Runtime::Insts::LoadDataDd<1>(dst_id, type, data);
-					}
-					else if (info.is_stvarb(dst_id)) {
-						// TODO!!! type & dsttype is different !
-						return new Runtime::Insts::LoadDataDs<1>(dst_id, type, data);
-					}
-					else {
-						assert(false);
+				if (type.data == T_BigInt && inst.data[1].type() == InstStruct::ET_IntegerData && !inst.data[1].get<InstStruct::IntegerData>().is_inline()) {
+					// The equal integers share one value (interned), which lives as long as the code.
+					Runtime::BigInt::BigIntValue value;
+					if (!Runtime::BigInt::Parse(inst.data[1].get<InstStruct::IntegerData>().toString(16), 16, value)) {
+						println("Error compile with illegal integer of cms#bigint.");
+						return NopeInst;
 					}
+					const Runtime::BigInt::BigIntValue &literal = Runtime::BigInt::Intern(value);
+					auto data = std::make_pair(reinterpret_cast<const uint8_t*>(&literal), MemorySize(Runtime::BigInt::ValueSize));
+					return createLoadData<2, LoadDataDs2Fixed>(dst, info, type, data);
 				}
-				else if (dst.isResultRegister()) {
-					// TODO!!! type & restype is different !
-					return new Runtime::Insts::LoadDataRes<1>(type, data);
+
+				if (type.data == T_String) {
+					println("Error compile with immediate of cms#string.");
+					return NopeInst;
 				}
-				else {
-					assert(false);
+
+				Runtime::Insts::ImmediateData data;
+				if (!parseImmediate(inst.data[1], type, data)) {
+					return NopeInst;
 				}
+
+				return createLoadData<1, LoadDataDs1Fixed>(dst, info, type, data);
 			}
 			else if (check(inst.data, { InstStruct::ET_Register, InstStruct::ET_DataLabel, InstStruct::ET_Identifier })) {
 
@@ -167,32 +478,23 @@ namespace CVM
 				}
 
 				TypeIndex type = parseType(*_ptypeInfoMap, inst.data[2]);
+				if (type.data == T_BigInt) {
+					println("Error compile with data label of cms#bigint.");
+					return NopeInst;
+				}
 
-				auto &src = inst.data[1].get<InstStruct::DataLabel>();
 				auto &dst = inst.data[0].get<InstStruct::Register>();
 
-				auto index = src.data();
-
-				if (dst.isPrivateDataRegister()) {
-					auto dst_id = dst.index();
-					if (info.is_dyvarb(dst_id)) {
-						return new Runtime::Insts::LoadDataDd<2>(dst_id, type, index);
-					}
-					else if (info.is_stvarb(dst_id)) {
-						// TODO!!! type & dsttype is different !
-						return new Runtime::Insts::LoadDataDs<2>(dst_id, type, index);
-					}
-					else {
-						assert(false);
-					}
-				}
-				else if (dst.isResultRegister()) {
-					// TODO!!! type & restype is different !
-					return new Runtime::Insts::LoadDataRes<2>(type, index);
-				}
-				else {
-					assert(false);
+				DataID dataid;
+				if (!parseDataLabel(inst.data[1], dataid)) {
+					return NopeInst;
 				}
+
+				if (type.data == T_String)
+					return createLoadString(dst, info, type, dataid);
+				if (_pliteralDataPool->isCompressed(FileID(0), dataid))
+					return createLoadData<3, LoadDataDs3Fixed>(dst, info, type, _pliteralDataPool->lazy(FileID(0), dataid));
+				return createLoadData<2, LoadDataDs2Fixed>(dst, info, type, _pliteralDataPool->at(FileID(0), dataid));
 			}
 			else {
 				assert(false);
@@ -209,10 +511,15 @@ namespace CVM
 				return NopeInst;
 			}
 
-			auto &src = inst.data[1].get<InstStruct::DataLabel>();
 			auto &dst = inst.data[0].get<InstStruct::Register>();
 
-			auto index = src.data();
+			DataID dataid;
+			if (!parseDataLabel(inst.data[1], dataid)) {
+				return NopeInst;
+			}
+			Runtime::Insts::LoadDataPointer::DataType index { nullptr, _pliteralDataPool->lazy(FileID(0), dataid) };
+			if (!index.lazy)
+				index.pointer = _pliteralDataPool->at(FileID(0), dataid).first;
 
 			if (dst.isPrivateDataRegister()) {
 				auto dst_id = dst.index();
@@ -220,16 +527,20 @@ namespace CVM
 					return new Runtime::Insts::LoadDataPointerDd(dst_id, index);
 				}
 				else if (info.is_stvarb(dst_id)) {
-					const auto &type = info.get_stvarb_type(dst_id);
-					return new Runtime::Insts::LoadDataPointerDs(dst_id, type, index);
+					const auto &type = getStvarbType(info, dst_id);
+					return new Runtime::Insts::LoadDataPointerDs(dst_id, _ptypeInfoMap->at(type).size, index);
 				}
 				else {
 					assert(false);
 				}
 			}
+			else if (isStaticRegister(dst, info)) {
+				auto dst_id = dst.index();
+				return new Runtime::Insts::LoadDataPointerDs(dst_id, _ptypeInfoMap->at(getStvarbType(info, dst_id)).size, index);
+			}
 			else if (dst.isResultRegister()) {
 				const auto &type = info.get_accesser().result_type();
-				return new Runtime::Insts::LoadDataPointerRes(type, index);
+				return new Runtime::Insts::LoadDataPointerRes(_ptypeInfoMap->at(type).size, index);
 			}
 			else {
 				assert(false);
@@ -238,6 +549,105 @@ namespace CVM
 			return NopeInst;
 		}
 
+		//--------------------------------------
+		// * Literal Stores
+		//    The literal data is read-only, and the literals of the same content share their data,
+		//    so the stores through the pointers of loadp are rejected (stf, sti, cpyn, tset,
+		//    and the intrinsics writing their arguments).
+		//    A register may hold a literal pointer if it's written by loadp, or by mov/mkslice from such a register,
+		//    anywhere in the function, so the branches don't matter.
+		//    The pointers passed by call (arguments and results) are not tracked.
+		//--------------------------------------
+
+		using LiteralRegisterSet = std::set<Config::RegisterIndexType>;
+
+		// The registers of the current function that may hold literal pointers.
+		const LiteralRegisterSet *_pliteralregisters = nullptr;  // TODO!!
+
+		static bool getLiteralRegister(const InstStruct::Element &elt, Config::RegisterIndexType &reg) {
+			if (elt.type() != InstStruct::ET_Register)
+				return false;
+			auto &r = elt.get<InstStruct::Register>();
+			if (!r.isPrivateDataRegister() && !r.isScopedDataRegister())
+				return false;
+			reg = r.index();
+			return true;
+		}
+
+		static LiteralRegisterSet findLiteralRegisters(const InstStruct::Function &func) {
+			LiteralRegisterSet result;
+			for (bool changed = true; changed;) {
+				changed = false;
+				for (const InstStruct::Instruction *pinst : func.instdata) {
+					const auto &data = pinst->data;
+					Config::RegisterIndexType dst, src;
+					bool literal = false;
+					if (pinst->instcode == InstStruct::i_loadp && data.size() == 2)
+						literal = getLiteralRegister(data[0], dst);
+					else if (pinst->instcode == InstStruct::i_mov && data.size() == 2)
+						literal = getLiteralRegister(data[0], dst) && getLiteralRegister(data[1], src) && result.count(src);
+					else if (pinst->instcode == InstStruct::i_mkslice && data.size() == 4)
+						literal = getLiteralRegister(data[0], dst) && getLiteralRegister(data[1], src) && result.count(src);
+					if (literal && result.insert(dst).second)
+						changed = true;
+				}
+			}
+			return result;
+		}
+
+		// Check the memory written through the register isn't literal data.
+		static bool checkLiteralStore(const InstStruct::Element &elt) {
+			Config::RegisterIndexType reg;
+			if (_pliteralregisters && getLiteralRegister(elt, reg) && _pliteralregisters->count(reg)) {
+				println("Error compile with store to literal data.");
+				return false;
+			}
+			return true;
+		}
+
+		// call %dst, name, %args...
+		// The registers must be static and of the types of the intrinsic, dst is %0 if there is no result.
+		static Runtime::Instruction* compile_CallIntrinsic(const InstStruct::Instruction &inst, const FunctionInfo &info, const Runtime::IntrinsicFunction &intrinsic) {
+			size_t argcount = inst.data.size() - 2;
+			if (argcount != intrinsic.argcount) {
+				println("Error compile with intrinsic of wrong argument count.");
+				return NopeInst;
+			}
+
+			Config::RegisterIndexType dst = 0;
+			auto &res = inst.data[0].get<InstStruct::Register>();
+			if (!res.isZeroRegister()) {
+				if (!isStaticRegister(res, info) || getStvarbType(info, res.index()).data != intrinsic.restype) {
+					println("Error compile with intrinsic of illegal result register.");
+					return NopeInst;
+				}
+				dst = res.index();
+			}
+
+			Config::RegisterIndexType args[Runtime::IntrinsicFunction::MaxArgumentCount];
+			for (size_t i = 0; i != argcount; ++i) {
+				const auto &elt = inst.data[i + 2];
+				if (elt.type() != InstStruct::ET_Register) {
+					println("Not register");
+					return NopeInst;
+				}
+				auto &arg = elt.get<InstStruct::Register>();
+				if (!isStaticRegister(arg, info) || getStvarbType(info, arg.index()).data != intrinsic.argtypes[i]) {
+					println("Error compile with intrinsic of illegal argument register.");
+					return NopeInst;
+				}
+				if ((intrinsic.storeargs & (1u << i)) && !checkLiteralStore(elt))
+					return NopeInst;
+				args[i] = arg.index();
+			}
+			return new Runtime::Insts::CallIntrinsic(intrinsic.func, dst, args, argcount);
+		}
+
+		// The function defined in the program (by .func), which shadows the intrinsic and the native function of the same name.
+		static bool isProgramFunction(const HashID &namekey) {
+			return _pfuncTable->hasKey(namekey) && _pfuncTable->getData(namekey) != nullptr;
+		}
+
 		static Runtime::Instruction* compile_Call(const InstStruct::Instruction &inst, const FunctionInfo &info) {
 			Config::FuncIndexType fid = 0;
 			InstStruct::ArgumentList arglist;
@@ -247,6 +657,9 @@ namespace CVM
 				if (inst.data[0].type() == InstStruct::ET_Register && inst.data[1].type() == InstStruct::ET_Identifier) {
 					auto res = inst.data[0].get<InstStruct::Register>();
 					const auto &namekey = inst.data[1].get<InstStruct::Identifier>().data();
+					auto intrinsic = _pintrinsicMap->find(namekey);
+					if (intrinsic != _pintrinsicMap->end() && !isProgramFunction(namekey))
+						return compile_CallIntrinsic(inst, info, intrinsic->second);
 					auto id = _pfuncTable->getID(namekey);
 					InstStruct::FuncIdentifier func(id);
 					InstStruct::ArgumentList::creater arglist_creater(inst.data.size() - 2);
@@ -281,7 +694,7 @@ namespace CVM
 					}
 				}
 				else {
-					assert(false);
+					println("Error compile with call argument of non-local register.");
 					return NopeInst;
 				}
 			}
@@ -305,76 +718,1874 @@ namespace CVM
 			return NopeInst;
 		}
 
-		InstStruct::LabelKeyTable *labelkeytable = nullptr;   // TODO
+		template <Runtime::MemoryKernel::SizeType _size>
+		using LoadFieldDirectFixed = Runtime::Insts::LoadFieldFixed<false, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using LoadFieldIndirectFixed = Runtime::Insts::LoadFieldFixed<true, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using StoreFieldDirectFixed = Runtime::Insts::StoreFieldFixed<false, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using StoreFieldIndirectFixed = Runtime::Insts::StoreFieldFixed<true, _size>;
+
+		template <template <Runtime::MemoryKernel::SizeType> typename FixedInstType, typename InstType>
+		static Runtime::Instruction* createFieldInst(Config::RegisterIndexType obj, Config::RegisterIndexType val, MemorySize offset, MemorySize size) {
+			if (auto fixedinst = createFixedSizeInst<FixedInstType>(size, obj, val, offset))
+				return fixedinst;
+			return new InstType(obj, val, offset, size);
+		}
 
-		static Runtime::Instruction* compile_Jump(const InstStruct::Instruction &inst, const FunctionInfo &info) {
-			if (check(inst.data, { InstStruct::ET_LineLabel })) {
-				InstStruct::LineLabel label = inst.data[0].get<InstStruct::LineLabel>();
-				size_t line = (*labelkeytable)[label.data()];
-				return new Runtime::Insts::Jump(static_cast<Config::LineCountType>(line));
+		// ldf %val, %obj, field
+		// ldf %val, %ptr, type, field
+		// stf %obj, %val, field
+		// stf %ptr, %val, type, field
+		// The registers must be static, ptr must be of cms#pointer, the value register must be of the type of the field.
+		static Runtime::Instruction* compile_Field(const InstStruct::Instruction &inst, const FunctionInfo &info, bool isstore) {
+			bool indirect;
+			if (check(inst.data, { InstStruct::ET_Register, InstStruct::ET_Register, InstStruct::ET_Identifier }))
+				indirect = false;
+			else if (check(inst.data, { InstStruct::ET_Register, InstStruct::ET_Register, InstStruct::ET_Identifier, InstStruct::ET_Identifier }))
+				indirect = true;
+			else {
+				println("Error compile with illegal format of field access.");
+				return NopeInst;
 			}
-			return NopeInst;
-		}
-	}
 
-	Runtime::Instruction* Compiler::compile(const InstStruct::Instruction &inst, const FunctionInfo &info) {
-		using namespace Compile;
+			auto &obj = inst.data[isstore ? 0 : 1].get<InstStruct::Register>();
+			auto &val = inst.data[isstore ? 1 : 0].get<InstStruct::Register>();
+			if (!isStaticRegister(obj, info) || !isStaticRegister(val, info)) {
+				println("Error compile with field access of non-static register.");
+				return NopeInst;
+			}
+			auto obj_id = obj.index();
+			auto val_id = val.index();
 
-		if (inst.instcode == InstStruct::i_nop) {
-			return NopeInst;
-		}
-		else if (inst.instcode == InstStruct::i_mov) {
-			return compile_Move(inst, info);
-		}
-		else if (inst.instcode == InstStruct::i_load) {
-			return compile_Load(inst, info);
-		}
-		else if (inst.instcode == InstStruct::i_loadp) {
-			return compile_LoadPointer(inst, info);
+			TypeIndex type;
+			if (indirect) {
+				if (getStvarbType(info, obj_id).data != T_Pointer) {
+					println("Error compile with field access by non-pointer register.");
+					return NopeInst;
+				}
+				type = parseType(*_ptypeInfoMap, inst.data[2]);
+			}
+			else {
+				type = getStvarbType(info, obj_id);
+			}
+
+			FieldInfo field;
+			if (!_ptypeInfoMap->findField(type, inst.data[indirect ? 3 : 2].get<InstStruct::Identifier>().data(), field)) {
+				println("Error compile with undefined field.");
+				return NopeInst;
+			}
+			if (field.type.data != getStvarbType(info, val_id).data) {
+				println("Error compile with field type mismatch.");
+				return NopeInst;
+			}
+
+			MemorySize size = _ptypeInfoMap->at(field.type).size;
+			if (isstore && indirect && !checkLiteralStore(inst.data[0]))
+				return NopeInst;
+			if (isstore) {
+				if (indirect)
+					return createFieldInst<StoreFieldIndirectFixed, Runtime::Insts::StoreField<true>>(obj_id, val_id, field.offset, size);
+				return createFieldInst<StoreFieldDirectFixed, Runtime::Insts::StoreField<false>>(obj_id, val_id, field.offset, size);
+			}
+			else {
+				if (indirect)
+					return createFieldInst<LoadFieldIndirectFixed, Runtime::Insts::LoadField<true>>(obj_id, val_id, field.offset, size);
+				return createFieldInst<LoadFieldDirectFixed, Runtime::Insts::LoadField<false>>(obj_id, val_id, field.offset, size);
+			}
 		}
-		else if (inst.instcode == InstStruct::i_ret) {
-			return new Runtime::Insts::Return();
+
+		// Check the first 'count' elements are static registers, and get their types.
+		static bool getStaticRegisterTypes(const InstStruct::Instruction &inst, const FunctionInfo &info, size_t count, std::vector<TypeIndex> &types) {
+			assert(count <= inst.data.size());
+			for (size_t i = 0; i != count; ++i) {
+				if (inst.data[i].type() != InstStruct::ET_Register) {
+					println("Error type for inst");
+					return false;
+				}
+				auto &reg = inst.data[i].get<InstStruct::Register>();
+				if (!isStaticRegister(reg, info)) {
+					println("Error compile with non-static register.");
+					return false;
+				}
+				types.push_back(getStvarbType(info, reg.index()));
+			}
+			return true;
 		}
-		else if (inst.instcode == InstStruct::i_jump) {
-			return compile_Jump(inst, info);
+
+		static bool getStaticRegister(const InstStruct::Element &elt, const FunctionInfo &info, Config::RegisterIndexType &reg) {
+			if (elt.type() != InstStruct::ET_Register)
+				return false;
+			auto &r = elt.get<InstStruct::Register>();
+			if (!isStaticRegister(r, info))
+				return false;
+			reg = r.index();
+			return true;
 		}
-		else if (inst.instcode == InstStruct::i_call) {
-			return compile_Call(inst, info);
+
+		template <typename T>
+		struct TypeTag { using Type = T; };
+
+		// Call func with the TypeTag of the C++ type of the builtin numeric type,
+		// return nullptr if it is not numeric.
+		template <typename Func>
+		static Runtime::Instruction* dispatchNumericType(TypeIndex type, Func func) {
+			switch (type.data) {
+			case T_Int8: return func(TypeTag<int8_t>());
+			case T_Int16: return func(TypeTag<int16_t>());
+			case T_Int32: return func(TypeTag<int32_t>());
+			case T_Int64: return func(TypeTag<int64_t>());
+			case T_UInt8: return func(TypeTag<uint8_t>());
+			case T_UInt16: return func(TypeTag<uint16_t>());
+			case T_UInt32: return func(TypeTag<uint32_t>());
+			case T_UInt64: return func(TypeTag<uint64_t>());
+			case T_Float32: return func(TypeTag<float>());
+			case T_Float64: return func(TypeTag<double>());
+			default: return nullptr;
+			}
 		}
-		else if (inst.instcode == InstStruct::id_opreg) {
-			return new Runtime::InstsDebug::OutputRegister();
+
+		template <typename Func>
+		static Runtime::Instruction* dispatchFloatType(TypeIndex type, Func func) {
+			if (!isFloatType(type))
+				return nullptr;
+			return dispatchNumericType(type, func);
 		}
-		else {
-			println(inst.instcode);
-			return NopeInst;
+
+		static Config::RegisterIndexType getRegisterIndex(const InstStruct::Instruction &inst, size_t i) {
+			return inst.data[i].get<InstStruct::Register>().index();
 		}
 
-		assert(false);
+		// fadd/fsub/fmul/fdiv %dst, %lhs, %rhs
+		// The registers must be static and of the same float type.
+		template <template <typename> typename _Op>
+		static Runtime::Instruction* compile_FloatArith(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 3 || !getStaticRegisterTypes(inst, info, 3, types))
+				return NopeInst;
+			if (types[0].data != types[1].data || types[0].data != types[2].data) {
+				println("Error compile with float instruction of non-float register.");
+				return NopeInst;
+			}
+			auto dst = getRegisterIndex(inst, 0), lhs = getRegisterIndex(inst, 1), rhs = getRegisterIndex(inst, 2);
+			auto result = dispatchFloatType(types[0], [&](auto tag) -> Runtime::Instruction* {
+				using Float = typename decltype(tag)::Type;
+				return new Runtime::Insts::FloatArith<Float, _Op<Float>>(dst, lhs, rhs);
+			});
+			if (!result) {
+				println("Error compile with float instruction of non-float register.");
+				return NopeInst;
+			}
+			return result;
+		}
 
-		return NopeInst;
-	}
-}
+		// fneg %dst, %src
+		static Runtime::Instruction* compile_FloatNeg(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 2 || !getStaticRegisterTypes(inst, info, 2, types))
+				return NopeInst;
+			if (types[0].data != types[1].data) {
+				println("Error compile with float instruction of non-float register.");
+				return NopeInst;
+			}
+			auto dst = getRegisterIndex(inst, 0), src = getRegisterIndex(inst, 1);
+			auto result = dispatchFloatType(types[0], [&](auto tag) -> Runtime::Instruction* {
+				using Float = typename decltype(tag)::Type;
+				return new Runtime::Insts::FloatNeg<Float>(dst, src);
+			});
+			if (!result) {
+				println("Error compile with float instruction of non-float register.");
+				return NopeInst;
+			}
+			return result;
+		}
+
+		// feq/fne/flt/fle %dst, %lhs, %rhs
+		// The operands must be of the same float type, the result (1 or 0) is written to the integer register dst.
+		template <template <typename> typename _Op>
+		static Runtime::Instruction* compile_FloatCompare(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 3 || !getStaticRegisterTypes(inst, info, 3, types))
+				return NopeInst;
+			if (types[1].data != types[2].data) {
+				println("Error compile with float instruction of non-float register.");
+				return NopeInst;
+			}
+			auto dst = getRegisterIndex(inst, 0), lhs = getRegisterIndex(inst, 1), rhs = getRegisterIndex(inst, 2);
+			auto result = dispatchNumericType(types[0], [&](auto restag) -> Runtime::Instruction* {
+				using Result = typename decltype(restag)::Type;
+				if constexpr (std::is_integral<Result>::value) {
+					return dispatchFloatType(types[1], [&](auto tag) -> Runtime::Instruction* {
+						using Float = typename decltype(tag)::Type;
+						return new Runtime::Insts::FloatCompare<Float, _Op<Float>, std::make_unsigned_t<Result>>(dst, lhs, rhs);
+					});
+				}
+				else {
+					return nullptr;
+				}
+			});
+			if (!result) {
+				println("Error compile with float instruction of non-float register.");
+				return NopeInst;
+			}
+			return result;
+		}
+
+		// fcvt %dst, %src
+		// Convert between the numeric types, at least one of them is float.
+		// Float to integer is truncated and saturated.
+		static Runtime::Instruction* compile_FloatConvert(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 2 || !getStaticRegisterTypes(inst, info, 2, types))
+				return NopeInst;
+			if (!isFloatType(types[0]) && !isFloatType(types[1])) {
+				println("Error compile with float instruction of non-float register.");
+				return NopeInst;
+			}
+			auto dst = getRegisterIndex(inst, 0), src = getRegisterIndex(inst, 1);
+			auto result = dispatchNumericType(types[0], [&](auto dsttag) -> Runtime::Instruction* {
+				using Dst = typename decltype(dsttag)::Type;
+				return dispatchNumericType(types[1], [&](auto srctag) -> Runtime::Instruction* {
+					using Src = typename decltype(srctag)::Type;
+					if constexpr (std::is_floating_point<Dst>::value || std::is_floating_point<Src>::value)
+						return new Runtime::Insts::Convert<Dst, Src>(dst, src);
+					else
+						return nullptr;
+				});
+			});
+			if (!result) {
+				println("Error compile with float conversion of non-numeric register.");
+				return NopeInst;
+			}
+			return result;
+		}
+
+		// Get the types of the integer instruction (dst, lhs, rhs), rhs may be an immediate of the type of lhs.
+		// The registers must be static, and lhs and rhs are of the same integer type.
+		static bool getIntegerOperandTypes(const InstStruct::Instruction &inst, const FunctionInfo &info, std::vector<TypeIndex> &types, bool &immediate) {
+			if (inst.data.size() != 3)
+				return false;
+			immediate = inst.data[2].type() == InstStruct::ET_IntegerData;
+			if (!getStaticRegisterTypes(inst, info, immediate ? 2 : 3, types))
+				return false;
+			if (!isIntegerType(types[1]) || (!immediate && types[2].data != types[1].data)) {
+				println("Error compile with integer instruction of non-integer register.");
+				return false;
+			}
+			return true;
+		}
+
+		template <typename _Int>
+		static bool parseIntegerImmediate(const InstStruct::Element &elt, TypeIndex type, _Int &result) {
+			Runtime::Insts::ImmediateData data;
+			if (!parseImmediate(elt, type, data))
+				return false;
+			std::memcpy(&result, data.data, sizeof(_Int));
+			return true;
+		}
+
+		// iadd/isub/imul/idiv/irem/iand/ior/ixor/ishl/ishr %dst, %lhs, %rhs
+		// iaddc/isubc/imulc/idivc %dst, %lhs, %rhs
+		// dst is of the same integer type as lhs, rhs is a register or an immediate.
+		template <template <typename> typename _Op>
+		static Runtime::Instruction* compile_IntegerBinary(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			bool immediate;
+			if (!getIntegerOperandTypes(inst, info, types, immediate))
+				return NopeInst;
+			if (types[0].data != types[1].data) {
+				println("Error compile with integer instruction of non-integer register.");
+				return NopeInst;
+			}
+			auto dst = getRegisterIndex(inst, 0), lhs = getRegisterIndex(inst, 1);
+			return dispatchNumericType(types[1], [&](auto tag) -> Runtime::Instruction* {
+				using Int = typename decltype(tag)::Type;
+				if constexpr (std::is_integral<Int>::value) {
+					if (!immediate)
+						return new Runtime::Insts::IntegerBinary<Int, _Op<Int>>(dst, lhs, getRegisterIndex(inst, 2));
+					Int rhs;
+					if (!parseIntegerImmediate(inst.data[2], types[1], rhs))
+						return NopeInst;
+					return new Runtime::Insts::IntegerBinaryImm<Int, _Op<Int>>(dst, lhs, rhs);
+				}
+				else {
+					return NopeInst;
+				}
+			});
+		}
+
+		// ineg/inegc %dst, %src
+		template <template <typename> typename _Op>
+		static Runtime::Instruction* compile_IntegerUnary(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 2 || !getStaticRegisterTypes(inst, info, 2, types))
+				return NopeInst;
+			if (types[0].data != types[1].data || !isIntegerType(types[0])) {
+				println("Error compile with integer instruction of non-integer register.");
+				return NopeInst;
+			}
+			auto dst = getRegisterIndex(inst, 0), src = getRegisterIndex(inst, 1);
+			return dispatchNumericType(types[0], [&](auto tag) -> Runtime::Instruction* {
+				using Int = typename decltype(tag)::Type;
+				if constexpr (std::is_integral<Int>::value)
+					return new Runtime::Insts::IntegerUnary<Int, _Op<Int>>(dst, src);
+				else
+					return NopeInst;
+			});
+		}
+
+		// ieq/ine/ilt/ile/igt/ige %dst, %lhs, %rhs
+		// The result (1 or 0) is written to the integer register dst, rhs is a register or an immediate.
+		template <template <typename> typename _Op>
+		static Runtime::Instruction* compile_IntegerCompare(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			bool immediate;
+			if (!getIntegerOperandTypes(inst, info, types, immediate))
+				return NopeInst;
+			auto dst = getRegisterIndex(inst, 0), lhs = getRegisterIndex(inst, 1);
+			auto result = dispatchNumericType(types[0], [&](auto restag) -> Runtime::Instruction* {
+				using Result = typename decltype(restag)::Type;
+				if constexpr (std::is_integral<Result>::value) {
+					return dispatchNumericType(types[1], [&](auto tag) -> Runtime::Instruction* {
+						using Int = typename decltype(tag)::Type;
+						if constexpr (std::is_integral<Int>::value) {
+							if (!immediate)
+								return new Runtime::Insts::IntegerCompare<Int, _Op<Int>, std::make_unsigned_t<Result>>(dst, lhs, getRegisterIndex(inst, 2));
+							Int rhs;
+							if (!parseIntegerImmediate(inst.data[2], types[1], rhs))
+								return NopeInst;
+							return new Runtime::Insts::IntegerCompareImm<Int, _Op<Int>, std::make_unsigned_t<Result>>(dst, lhs, rhs);
+						}
+						else {
+							return nullptr;
+						}
+					});
+				}
+				else {
+					return nullptr;
+				}
+			});
+			if (!result) {
+				println("Error compile with integer compare of non-integer register.");
+				return NopeInst;
+			}
+			return result;
+		}
+
+		using CompileFunction = Runtime::Instruction* (*)(const InstStruct::Instruction &, const FunctionInfo &);
+
+		// The operators of the native functions named as "cms#int64#+".
+		static const std::map<std::string, std::pair<InstStruct::InstCode, CompileFunction>>& getOperatorCallMap() {
+			static const std::map<std::string, std::pair<InstStruct::InstCode, CompileFunction>> result {
+				{ "+", { InstStruct::i_iadd, compile_IntegerBinary<Runtime::Integer::Add> } },
+				{ "-", { InstStruct::i_isub, compile_IntegerBinary<Runtime::Integer::Sub> } },
+				{ "*", { InstStruct::i_imul, compile_IntegerBinary<Runtime::Integer::Mul> } },
+				{ "/", { InstStruct::i_idiv, compile_IntegerBinary<Runtime::Integer::Div> } },
+				{ "%", { InstStruct::i_irem, compile_IntegerBinary<Runtime::Integer::Rem> } },
+				{ "&", { InstStruct::i_iand, compile_IntegerBinary<Runtime::Integer::And> } },
+				{ "|", { InstStruct::i_ior, compile_IntegerBinary<Runtime::Integer::Or> } },
+				{ "^", { InstStruct::i_ixor, compile_IntegerBinary<Runtime::Integer::Xor> } },
+				{ "<<", { InstStruct::i_ishl, compile_IntegerBinary<Runtime::Integer::Shl> } },
+				{ ">>", { InstStruct::i_ishr, compile_IntegerBinary<Runtime::Integer::Shr> } },
+			};
+			return result;
+		}
+
+		// call %dst, cms#int64#+, %lhs, %rhs
+		// The call of the operator of the integer type is lowered to the integer instruction (wrapping),
+		// if the native function of the name is registered (and not shadowed by the program),
+		// and all the registers are static and of the type. Otherwise return nullptr.
+		static Runtime::Instruction* lowerOperatorCall(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			if (inst.data.size() != 4 || inst.data[1].type() != InstStruct::ET_Identifier)
+				return nullptr;
+			const auto &namekey = inst.data[1].get<InstStruct::Identifier>().data();
+			if (_pptrFuncMap->find(namekey) == _pptrFuncMap->end() || isProgramFunction(namekey))
+				return nullptr;
+			const std::string &name = _phashStringPool->get(namekey);
+			size_t pos = name.rfind('#');
+			if (pos == std::string::npos)
+				return nullptr;
+			auto iter = getOperatorCallMap().find(name.substr(pos + 1));
+			if (iter == getOperatorCallMap().end())
+				return nullptr;
+			Config::RegisterIndexType dst, lhs, rhs;
+			if (!getStaticRegister(inst.data[0], info, dst) || !getStaticRegister(inst.data[2], info, lhs) || !getStaticRegister(inst.data[3], info, rhs))
+				return nullptr;
+			TypeIndex type = getStvarbType(info, lhs);
+			if (!isIntegerType(type) || getStvarbType(info, dst).data != type.data || getStvarbType(info, rhs).data != type.data)
+				return nullptr;
+			if (name.compare(0, pos, _phashStringPool->get(_ptypeInfoMap->at(type).name)) != 0)
+				return nullptr;
+			InstStruct::Element operands[] = { inst.data[0], inst.data[2], inst.data[3] };
+			return iter->second.second(InstStruct::Instruction(iter->second.first, InstStruct::ElementList(operands, 3)), info);
+		}
+
+		static bool isVectorType(TypeIndex type) {
+			return type.data == T_V128 || type.data == T_V256;
+		}
+
+		static bool getLaneType(TypeIndex type, Runtime::VectorKernel::LaneType &lane) {
+			using namespace Runtime::VectorKernel;
+			switch (type.data) {
+			case T_Int8: lane = lt_int8; return true;
+			case T_Int16: lane = lt_int16; return true;
+			case T_Int32: lane = lt_int32; return true;
+			case T_Int64: lane = lt_int64; return true;
+			case T_UInt8: lane = lt_uint8; return true;
+			case T_UInt16: lane = lt_uint16; return true;
+			case T_UInt32: lane = lt_uint32; return true;
+			case T_UInt64: lane = lt_uint64; return true;
+			case T_Float32: lane = lt_float32; return true;
+			case T_Float64: lane = lt_float64; return true;
+			default: return false;
+			}
+		}
+
+		// Check the 'count' registers and the lane type of the vector instruction, and get the lane and the vector size.
+		// The registers must be static and of the same vector type,
+		// except that the dst of the reduce is of the lane type.
+		static bool getVectorOperands(const InstStruct::Instruction &inst, const FunctionInfo &info, size_t count, Runtime::VectorKernel::LaneType &lane, Runtime::VectorKernel::SizeType &size) {
+			bool isreduce = count == 2;
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != count + 1 || inst.data[count].type() != InstStruct::ET_Identifier) {
+				println("Error compile with illegal format of vector instruction.");
+				return false;
+			}
+			if (!getStaticRegisterTypes(inst, info, count, types))
+				return false;
+
+			TypeIndex lanetype = parseType(*_ptypeInfoMap, inst.data[count]);
+			if (!getLaneType(lanetype, lane)) {
+				println("Error compile with non-numeric lane type.");
+				return false;
+			}
+			TypeIndex vectype = types[1];
+			bool typematch = isVectorType(vectype) && (isreduce ? types[0].data == lanetype.data : (types[0].data == vectype.data && types[2].data == vectype.data));
+			if (!typematch) {
+				println("Error compile with vector instruction of non-vector register.");
+				return false;
+			}
+			size = _ptypeInfoMap->at(vectype).size.data;
+			return true;
+		}
+
+		// vadd/vsub/vmul/vmin/vmax/vcmpeq/vcmplt %dst, %lhs, %rhs, lanetype
+		static Runtime::Instruction* compile_VectorBinary(const InstStruct::Instruction &inst, const FunctionInfo &info, Runtime::VectorKernel::VectorOp op) {
+			Runtime::VectorKernel::LaneType lane;
+			Runtime::VectorKernel::SizeType size;
+			if (!getVectorOperands(inst, info, 3, lane, size))
+				return NopeInst;
+			auto kernel = Runtime::VectorKernel::GetBinaryKernel(op, lane, size);
+			assert(kernel);
+			return new Runtime::Insts::VectorBinary(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1), getRegisterIndex(inst, 2), kernel);
+		}
+
+		// vshuf %dst, %src, %idx, lanetype
+		// The lanes of idx are the unsigned indexes of the lanes of src, the lane is cleared if out of range.
+		static Runtime::Instruction* compile_VectorShuffle(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			Runtime::VectorKernel::LaneType lane;
+			Runtime::VectorKernel::SizeType size;
+			if (!getVectorOperands(inst, info, 3, lane, size))
+				return NopeInst;
+			auto kernel = Runtime::VectorKernel::GetShuffleKernel(lane, size);
+			assert(kernel);
+			return new Runtime::Insts::VectorShuffle(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1), getRegisterIndex(inst, 2), kernel);
+		}
+
+		// vradd/vrmin/vrmax %dst, %src, lanetype
+		static Runtime::Instruction* compile_VectorReduce(const InstStruct::Instruction &inst, const FunctionInfo &info, Runtime::VectorKernel::VectorOp op) {
+			Runtime::VectorKernel::LaneType lane;
+			Runtime::VectorKernel::SizeType size;
+			if (!getVectorOperands(inst, info, 2, lane, size))
+				return NopeInst;
+			auto kernel = Runtime::VectorKernel::GetReduceKernel(op, lane, size);
+			assert(kernel);
+			return new Runtime::Insts::VectorReduce(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1), kernel);
+		}
+
+		// badd/bsub/bmul/bdiv/brem %dst, %lhs, %rhs
+		// The registers must be static and of cms#bigint.
+		template <void (*_func)(Runtime::BigInt::BigIntValue&, const Runtime::BigInt::BigIntValue&, const Runtime::BigInt::BigIntValue&)>
+		static Runtime::Instruction* compile_BigIntArith(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 3 || !getStaticRegisterTypes(inst, info, 3, types))
+				return NopeInst;
+			if (types[0].data != T_BigInt || types[1].data != T_BigInt || types[2].data != T_BigInt) {
+				println("Error compile with bigint instruction of non-bigint register.");
+				return NopeInst;
+			}
+			return new Runtime::Insts::BigIntBinary<_func>(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1), getRegisterIndex(inst, 2));
+		}
+
+		// bneg %dst, %src
+		static Runtime::Instruction* compile_BigIntNeg(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 2 || !getStaticRegisterTypes(inst, info, 2, types))
+				return NopeInst;
+			if (types[0].data != T_BigInt || types[1].data != T_BigInt) {
+				println("Error compile with bigint instruction of non-bigint register.");
+				return NopeInst;
+			}
+			return new Runtime::Insts::BigIntNeg(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1));
+		}
+
+		// bcmp %dst, %lhs, %rhs
+		// The result (-1, 0 or 1) is written to the signed integer register dst.
+		static Runtime::Instruction* compile_BigIntCompare(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 3 || !getStaticRegisterTypes(inst, info, 3, types))
+				return NopeInst;
+			if (types[1].data != T_BigInt || types[2].data != T_BigInt) {
+				println("Error compile with bigint instruction of non-bigint register.");
+				return NopeInst;
+			}
+			auto dst = getRegisterIndex(inst, 0), lhs = getRegisterIndex(inst, 1), rhs = getRegisterIndex(inst, 2);
+			auto result = dispatchNumericType(types[0], [&](auto tag) -> Runtime::Instruction* {
+				using Result = typename decltype(tag)::Type;
+				if constexpr (std::is_integral<Result>::value && std::is_signed<Result>::value)
+					return new Runtime::Insts::BigIntCompare<Result>(dst, lhs, rhs);
+				else
+					return nullptr;
+			});
+			if (!result) {
+				println("Error compile with bigint compare of non-signed-integer register.");
+				return NopeInst;
+			}
+			return result;
+		}
+
+		// bcvt %dst, %src
+		// Convert between cms#bigint and the builtin integer types.
+		// cms#bigint to integer is saturated.
+		static Runtime::Instruction* compile_BigIntConvert(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 2 || !getStaticRegisterTypes(inst, info, 2, types))
+				return NopeInst;
+			auto dst = getRegisterIndex(inst, 0), src = getRegisterIndex(inst, 1);
+			bool tobigint = types[0].data == T_BigInt;
+			if (tobigint == (types[1].data == T_BigInt)) {
+				println("Error compile with bigint conversion of illegal register.");
+				return NopeInst;
+			}
+			auto result = dispatchNumericType(types[tobigint ? 1 : 0], [&](auto tag) -> Runtime::Instruction* {
+				using Integer = typename decltype(tag)::Type;
+				if constexpr (std::is_integral<Integer>::value) {
+					if (tobigint)
+						return new Runtime::Insts::BigIntFromInteger<Integer>(dst, src);
+					return new Runtime::Insts::BigIntToInteger<Integer>(dst, src);
+				}
+				else {
+					return nullptr;
+				}
+			});
+			if (!result) {
+				println("Error compile with bigint conversion of illegal register.");
+				return NopeInst;
+			}
+			return result;
+		}
+
+		//--------------------------------------
+		// * Bounds Check Elimination
+		//    The facts of the local static registers are found by a forward pass over the basic blocks
+		//    (a block starts at a label, or after jump/switch/ret), repeated until the facts are stable.
+		//    A block starts with the facts holding on all of its reached incoming edges,
+		//    the edges of switch on the result of a compare also know the result, and a fact is dropped when its register is written.
+		//    The check of ldi/sti is redundant if the same (slice, index, element type) is accessed before,
+		//    or the element type of the slice is known (by mkslice or an access before), and:
+		//      both the index and the length of the slice are known constants, or
+		//      index < bound is known by a compare (ilt/ile/igt/ige) of registers, and bound is the length of the slice (by slen or mkslice).
+		//    For the signed compare, the index must be known >= 0: a constant, a length,
+		//    or the index increased by 1 (iadd/iaddc) when it's >= 0 and below a bound.
+		//    So the checks of the counted loop over the length of a slice are removed:
+		//        load %i, 0, cms#int64
+		//        slen %n, %s
+		//    #loop
+		//        ilt %c, %i, %n
+		//        switch %c, #end, 1, #body
+		//    #body
+		//        ldi %v, %s, %i
+		//        iadd %i, %i, 1
+		//        jump #loop
+		//    #end
+		//--------------------------------------
+
+		using BoundsCheckFreeSet = std::set<const InstStruct::Instruction*>;
+
+		// The ldi/sti of the current function whose checks are proven redundant.
+		const BoundsCheckFreeSet *_pboundscheckfree = nullptr;  // TODO!!
+
+		static bool isIndexType(TypeIndex type) {
+			return type.data == T_Int64 || type.data == T_UInt64;
+		}
+
+		template <typename _Container, typename _Pred>
+		static void eraseFactsIf(_Container &facts, _Pred pred) {
+			for (auto iter = facts.begin(); iter != facts.end();) {
+				if (pred(*iter))
+					iter = facts.erase(iter);
+				else
+					++iter;
+			}
+		}
+
+		// Keep the facts also in other, return whether any is dropped.
+		template <typename _Key, typename _Value>
+		static bool intersectFacts(std::map<_Key, _Value> &facts, const std::map<_Key, _Value> &other) {
+			size_t count = facts.size();
+			eraseFactsIf(facts, [&](const std::pair<const _Key, _Value> &fact) {
+				auto iter = other.find(fact.first);
+				return iter == other.end() || !(iter->second == fact.second);
+			});
+			return facts.size() != count;
+		}
+		template <typename _Key>
+		static bool intersectFacts(std::set<_Key> &facts, const std::set<_Key> &other) {
+			size_t count = facts.size();
+			eraseFactsIf(facts, [&](const _Key &fact) { return other.count(fact) == 0; });
+			return facts.size() != count;
+		}
+
+		struct BoundsFacts
+		{
+			using AccessKey = std::tuple<Config::RegisterIndexType, Config::RegisterIndexType, Config::TypeIndexType>;
+			using RegisterPair = std::pair<Config::RegisterIndexType, Config::RegisterIndexType>;
+
+			// The result register of the compare is (lhs op rhs).
+			struct Compare
+			{
+				InstStruct::InstCode op;
+				Config::RegisterIndexType lhs;
+				Config::RegisterIndexType rhs;
+				bool issigned;
+
+				bool operator==(const Compare &other) const {
+					return op == other.op && lhs == other.lhs && rhs == other.rhs && issigned == other.issigned;
+				}
+			};
+
+			std::map<Config::RegisterIndexType, uint64_t> constants;  // The index registers of known values.
+			std::set<Config::RegisterIndexType> nonnegatives;  // The index registers known >= 0.
+			std::map<Config::RegisterIndexType, Config::TypeIndexType> elemtypes;  // The slices of known element types.
+			std::map<Config::RegisterIndexType, uint64_t> lengths;  // The slices of known lengths.
+			std::map<Config::RegisterIndexType, Config::RegisterIndexType> lengthof;  // The index registers holding the lengths of the slices.
+			std::set<RegisterPair> less;  // (index, bound) with index < bound, as uint64.
+			std::map<Config::RegisterIndexType, Compare> compares;  // The results of the compares.
+			std::set<AccessKey> checked;  // (slice, index, element type) accessed without error.
+
+			void kill(Config::RegisterIndexType reg) {
+				constants.erase(reg);
+				nonnegatives.erase(reg);
+				elemtypes.erase(reg);
+				lengths.erase(reg);
+				lengthof.erase(reg);
+				eraseFactsIf(lengthof, [=](const std::pair<const Config::RegisterIndexType, Config::RegisterIndexType> &fact) { return fact.second == reg; });
+				eraseFactsIf(less, [=](const RegisterPair &fact) { return fact.first == reg || fact.second == reg; });
+				compares.erase(reg);
+				eraseFactsIf(compares, [=](const std::pair<const Config::RegisterIndexType, Compare> &fact) { return fact.second.lhs == reg || fact.second.rhs == reg; });
+				eraseFactsIf(checked, [=](const AccessKey &fact) { return std::get<0>(fact) == reg || std::get<1>(fact) == reg; });
+			}
+			bool intersect(const BoundsFacts &other) {
+				bool changed = intersectFacts(constants, other.constants);
+				changed = intersectFacts(nonnegatives, other.nonnegatives) || changed;
+				changed = intersectFacts(elemtypes, other.elemtypes) || changed;
+				changed = intersectFacts(lengths, other.lengths) || changed;
+				changed = intersectFacts(lengthof, other.lengthof) || changed;
+				changed = intersectFacts(less, other.less) || changed;
+				changed = intersectFacts(compares, other.compares) || changed;
+				changed = intersectFacts(checked, other.checked) || changed;
+				return changed;
+			}
+			// The result of the compare in reg is known (on an edge of switch).
+			void assume(Config::RegisterIndexType reg, bool result) {
+				auto iter = compares.find(reg);
+				if (iter == compares.end())
+					return;
+				const Compare &compare = iter->second;
+				bool lhsless;
+				if ((compare.op == InstStruct::i_ilt && result) || (compare.op == InstStruct::i_ige && !result))
+					lhsless = true;
+				else if ((compare.op == InstStruct::i_igt && result) || (compare.op == InstStruct::i_ile && !result))
+					lhsless = false;
+				else
+					return;
+				auto index = lhsless ? compare.lhs : compare.rhs;
+				auto bound = lhsless ? compare.rhs : compare.lhs;
+				// If signed, index < bound as uint64 only if index >= 0.
+				if (!compare.issigned || nonnegatives.count(index))
+					less.emplace(index, bound);
+			}
+			bool hasBound(Config::RegisterIndexType index) const {
+				auto iter = less.lower_bound(RegisterPair(index, 0));
+				return iter != less.end() && iter->first == index;
+			}
+			bool proven(const AccessKey &key) const {
+				if (checked.count(key))
+					return true;
+				auto slice = std::get<0>(key), index = std::get<1>(key);
+				auto elemtype = elemtypes.find(slice);
+				if (elemtype == elemtypes.end() || elemtype->second != std::get<2>(key))
+					return false;
+				auto length = lengths.find(slice);
+				auto constant = constants.find(index);
+				if (length != lengths.end() && constant != constants.end() && constant->second < length->second)
+					return true;
+				for (auto &fact : lengthof) {
+					if (fact.second == slice && less.count(RegisterPair(index, fact.first)))
+						return true;
+				}
+				return false;
+			}
+		};
+
+		// The operands of the registers written by the instruction.
+		static const std::vector<size_t>& getWrittenOperands(const InstStruct::Instruction &inst) {
+			static const std::vector<size_t> none;
+			static const std::vector<size_t> first { 0 };
+			static const std::vector<size_t> mget { 0, 1 };        // found, value
+			static const std::vector<size_t> mnext { 0, 1, 2 };    // pos, key, value
+			static const std::vector<size_t> acas { 0, 2 };        // ok, expected (loaded if failed)
+			switch (inst.instcode) {
+			case InstStruct::i_nop:
+			case InstStruct::i_ret:
+			case InstStruct::i_jump:
+			case InstStruct::i_switch:
+			case InstStruct::i_sti:
+			case InstStruct::i_mput:
+			case InstStruct::i_mdel:
+			case InstStruct::id_opreg:
+				return none;
+			case InstStruct::i_mget:
+				return mget;
+			case InstStruct::i_mnext:
+				return mnext;
+			case InstStruct::i_acas:
+				return acas;
+			default:
+				return first;
+			}
+		}
+
+		static bool getWrittenRegister(const InstStruct::Instruction &inst, size_t i, Config::RegisterIndexType &reg) {
+			if (i >= inst.data.size() || inst.data[i].type() != InstStruct::ET_Register)
+				return false;
+			auto &r = inst.data[i].get<InstStruct::Register>();
+			if (!r.isPrivateDataRegister())
+				return false;
+			reg = r.index();
+			return true;
+		}
+
+		// The facts are only of the local static registers,
+		// the scoped registers (%g, %t) may be written by the other functions.
+		static bool getFactRegister(const InstStruct::Element &elt, const FunctionInfo &info, Config::RegisterIndexType &reg) {
+			return getStaticRegister(elt, info, reg) && !Config::is_scoped(reg);
+		}
+
+		static void updateBoundsFacts(const InstStruct::Instruction &inst, const FunctionInfo &info, BoundsFacts &facts, BoundsCheckFreeSet *result) {
+			Config::RegisterIndexType reg[3];
+			const auto &data = inst.data;
+
+			// The facts of the register written (dst), made by this instruction from the facts before it.
+			Config::RegisterIndexType dst = 0;
+			bool hasconstant = false, nonnegative = false, haselemtype = false, haslength = false, haslengthof = false, hascompare = false;
+			uint64_t constant = 0, length = 0;
+			Config::TypeIndexType elemtype = 0;
+			Config::RegisterIndexType lengthof = 0;
+			BoundsFacts::Compare compare;
+			// The length register of mkslice.
+			bool haslengthreg = false;
+			Config::RegisterIndexType lengthreg = 0;
+			bool hascheck = false;
+			BoundsFacts::AccessKey key;
+
+			if (inst.instcode == InstStruct::i_load && data.size() == 3 && getFactRegister(data[0], info, dst) &&
+			    data[1].type() == InstStruct::ET_IntegerData && data[2].type() == InstStruct::ET_Identifier) {
+				TypeIndex type = parseType(*_ptypeInfoMap, data[2]);
+				uint64_t magnitude;
+				bool negative;
+				if (isIndexType(type) && type.data == getStvarbType(info, dst).data &&
+				    data[1].get<InstStruct::IntegerData>().get_inline(magnitude, negative) && !negative) {
+					hasconstant = nonnegative = true;
+					constant = magnitude;
+				}
+			}
+			else if (inst.instcode == InstStruct::i_mov && data.size() == 2 && getFactRegister(data[0], info, dst) && getFactRegister(data[1], info, reg[1]) &&
+			         getStvarbType(info, dst).data == getStvarbType(info, reg[1]).data) {
+				auto c = facts.constants.find(reg[1]);
+				if ((hasconstant = c != facts.constants.end()))
+					constant = c->second;
+				nonnegative = facts.nonnegatives.count(reg[1]) != 0;
+				auto e = facts.elemtypes.find(reg[1]);
+				if ((haselemtype = e != facts.elemtypes.end()))
+					elemtype = e->second;
+				auto l = facts.lengths.find(reg[1]);
+				if ((haslength = l != facts.lengths.end()))
+					length = l->second;
+				auto lo = facts.lengthof.find(reg[1]);
+				if ((haslengthof = lo != facts.lengthof.end()))
+					lengthof = lo->second;
+			}
+			else if (inst.instcode == InstStruct::i_mkslice && data.size() == 4 && getFactRegister(data[0], info, dst) && data[3].type() == InstStruct::ET_Identifier) {
+				haselemtype = true;
+				elemtype = parseType(*_ptypeInfoMap, data[3]).data;
+				if ((haslengthreg = getFactRegister(data[2], info, lengthreg))) {
+					auto c = facts.constants.find(lengthreg);
+					if ((haslength = c != facts.constants.end()))
+						length = c->second;
+				}
+			}
+			else if (inst.instcode == InstStruct::i_slen && data.size() == 2 && getFactRegister(data[0], info, dst) && getFactRegister(data[1], info, reg[1]) &&
+			         getStvarbType(info, reg[1]).data == T_Slice) {
+				// The length of the slice in memory is less than 2^63.
+				nonnegative = haslengthof = true;
+				lengthof = reg[1];
+				auto l = facts.lengths.find(reg[1]);
+				if ((hasconstant = l != facts.lengths.end()))
+					constant = l->second;
+			}
+			else if ((inst.instcode == InstStruct::i_ilt || inst.instcode == InstStruct::i_ile || inst.instcode == InstStruct::i_igt || inst.instcode == InstStruct::i_ige) &&
+			         data.size() == 3 && getFactRegister(data[0], info, dst) && getFactRegister(data[1], info, reg[1]) && getFactRegister(data[2], info, reg[2])) {
+				TypeIndex type = getStvarbType(info, reg[1]);
+				if ((hascompare = isIndexType(type) && dst != reg[1] && dst != reg[2]))
+					compare = BoundsFacts::Compare { inst.instcode, reg[1], reg[2], type.data == T_Int64 };
+			}
+			else if ((inst.instcode == InstStruct::i_iadd || inst.instcode == InstStruct::i_iaddc) && data.size() == 3 &&
+			         getFactRegister(data[0], info, dst) && getFactRegister(data[1], info, reg[1]) && data[2].type() == InstStruct::ET_IntegerData) {
+				// index + 1 doesn't overflow if index < bound.
+				uint64_t magnitude;
+				bool negative;
+				nonnegative = isIndexType(getStvarbType(info, dst)) &&
+					data[2].get<InstStruct::IntegerData>().get_inline(magnitude, negative) && !negative && magnitude == 1 &&
+					facts.nonnegatives.count(reg[1]) && facts.hasBound(reg[1]);
+			}
+			else if ((inst.instcode == InstStruct::i_ldi || inst.instcode == InstStruct::i_sti) && data.size() == 3) {
+				bool isstore = inst.instcode == InstStruct::i_sti;
+				if (getFactRegister(data[isstore ? 0 : 1], info, reg[0]) && getFactRegister(data[isstore ? 1 : 2], info, reg[1]) &&
+				    getFactRegister(data[isstore ? 2 : 0], info, reg[2])) {
+					key = BoundsFacts::AccessKey(reg[0], reg[1], getStvarbType(info, reg[2]).data);
+					if (result && facts.proven(key))
+						result->insert(&inst);
+					hascheck = true;
+				}
+			}
+
+			bool dstkilled = false, checkkilled = false;
+			for (size_t i : getWrittenOperands(inst)) {
+				Config::RegisterIndexType written;
+				if (!getWrittenRegister(inst, i, written))
+					continue;
+				facts.kill(written);
+				dstkilled = dstkilled || (i == 0 && written == dst);
+				checkkilled = checkkilled || written == std::get<0>(key) || written == std::get<1>(key);
+			}
+			if (dstkilled) {
+				if (hasconstant)
+					facts.constants[dst] = constant;
+				if (nonnegative)
+					facts.nonnegatives.insert(dst);
+				if (haselemtype)
+					facts.elemtypes[dst] = elemtype;
+				if (haslength)
+					facts.lengths[dst] = length;
+				if (haslengthof)
+					facts.lengthof[dst] = lengthof;
+				if (hascompare)
+					facts.compares[dst] = compare;
+				if (haslengthreg && lengthreg != dst)
+					facts.lengthof[lengthreg] = dst;
+			}
+			// The access doesn't return if the check fails, so it holds after the access.
+			if (hascheck && !checkkilled) {
+				facts.checked.insert(key);
+				facts.elemtypes[std::get<0>(key)] = std::get<2>(key);
+			}
+		}
+
+		// Get the line of the label, false if it's undefined.
+		static bool getBoundsLabelLine(const InstStruct::Function &func, const InstStruct::Element &elt, size_t &line) {
+			if (elt.type() != InstStruct::ET_LineLabel)
+				return false;
+			auto iter = func.labelkeytable.find(elt.get<InstStruct::LineLabel>().data());
+			if (iter == func.labelkeytable.end())
+				return false;
+			line = iter->second;
+			return true;
+		}
+
+		// Call f(target, facts) for each edge from the instruction at the line ending a block, with the facts on the edge.
+		template <typename F>
+		static void forEachBoundsEdge(const InstStruct::Function &func, size_t line, const BoundsFacts &facts, F f) {
+			const InstStruct::Instruction &inst = *func.instdata[line];
+			const auto &data = inst.data;
+			size_t target;
+			if (inst.instcode == InstStruct::i_ret) {
+				return;
+			}
+			else if (inst.instcode == InstStruct::i_jump) {
+				if (data.size() == 1 && getBoundsLabelLine(func, data[0], target))
+					f(target, facts);
+			}
+			else if (inst.instcode == InstStruct::i_switch) {
+				// The result of a compare is 1 or 0, known on the edges of the cases 1 and 0,
+				// and on the default edge if only one of them is a case.
+				Config::RegisterIndexType reg = 0;
+				bool hasreg = !data.empty() && getFactRegister(data[0], func.info, reg);
+				bool hascase[2] = { false, false };
+				for (size_t i = 2; i + 1 < data.size(); i += 2) {
+					uint64_t key = 0;
+					bool negative = false;
+					bool isresult = data[i].type() == InstStruct::ET_IntegerData &&
+						data[i].get<InstStruct::IntegerData>().get_inline(key, negative) && !negative && key <= 1;
+					if (isresult)
+						hascase[key] = true;
+					if (!getBoundsLabelLine(func, data[i + 1], target))
+						continue;
+					BoundsFacts edge = facts;
+					if (hasreg && isresult)
+						edge.assume(reg, key == 1);
+					f(target, edge);
+				}
+				if (data.size() >= 2 && getBoundsLabelLine(func, data[1], target)) {
+					BoundsFacts edge = facts;
+					if (hasreg && hascase[0] != hascase[1])
+						edge.assume(reg, hascase[0]);
+					f(target, edge);
+				}
+			}
+			else if (line + 1 < func.instdata.size()) {
+				f(line + 1, facts);
+			}
+		}
+
+		struct BoundsBlock
+		{
+			size_t end = 0;
+			bool reached = false;
+			BoundsFacts facts;  // The facts at the start of the block.
+		};
+
+		static BoundsCheckFreeSet findBoundsCheckFree(const InstStruct::Function &func) {
+			const auto &instdata = func.instdata;
+			BoundsCheckFreeSet result;
+			if (instdata.empty())
+				return result;
+
+			std::set<size_t> begins { 0 };
+			for (auto &pair : func.labelkeytable)
+				begins.insert(pair.second);
+			for (size_t line = 0; line != instdata.size(); ++line) {
+				auto code = instdata[line]->instcode;
+				if (code == InstStruct::i_jump || code == InstStruct::i_switch || code == InstStruct::i_ret)
+					begins.insert(line + 1);
+			}
+			std::map<size_t, BoundsBlock> blocks;
+			for (auto iter = begins.begin(); iter != begins.end() && *iter < instdata.size(); ++iter) {
+				auto next = std::next(iter);
+				blocks[*iter].end = next == begins.end() ? instdata.size() : std::min<size_t>(*next, instdata.size());
+			}
+
+			// The facts only decrease after a block is reached, so it ends.
+			blocks[0].reached = true;
+			std::set<size_t> worklist { 0 };
+			while (!worklist.empty()) {
+				size_t begin = *worklist.begin();
+				worklist.erase(worklist.begin());
+				const BoundsBlock &block = blocks[begin];
+				BoundsFacts facts = block.facts;
+				for (size_t line = begin; line != block.end; ++line)
+					updateBoundsFacts(*instdata[line], func.info, facts, nullptr);
+				forEachBoundsEdge(func, block.end - 1, facts, [&](size_t target, const BoundsFacts &edge) {
+					auto iter = blocks.find(target);
+					if (iter == blocks.end())
+						return;
+					BoundsBlock &next = iter->second;
+					if (!next.reached) {
+						next.reached = true;
+						next.facts = edge;
+						worklist.insert(target);
+					}
+					else if (next.facts.intersect(edge)) {
+						worklist.insert(target);
+					}
+				});
+			}
+
+			for (auto &pair : blocks) {
+				if (!pair.second.reached)
+					continue;
+				BoundsFacts facts = pair.second.facts;
+				for (size_t line = pair.first; line != pair.second.end; ++line)
+					updateBoundsFacts(*instdata[line], func.info, facts, &result);
+			}
+			return result;
+		}
+
+		template <Runtime::MemoryKernel::SizeType _size>
+		using LoadElementCheckedFixed = Runtime::Insts::LoadElementFixed<true, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using LoadElementUncheckedFixed = Runtime::Insts::LoadElementFixed<false, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using StoreElementCheckedFixed = Runtime::Insts::StoreElementFixed<true, _size>;
+		template <Runtime::MemoryKernel::SizeType _size>
+		using StoreElementUncheckedFixed = Runtime::Insts::StoreElementFixed<false, _size>;
+
+		template <template <Runtime::MemoryKernel::SizeType> typename FixedInstType, typename InstType>
+		static Runtime::Instruction* createElementInst(Config::RegisterIndexType slice, Config::RegisterIndexType index, Config::RegisterIndexType val, TypeIndex elemtype, MemorySize size) {
+			if (auto fixedinst = createFixedSizeInst<FixedInstType>(size, slice, index, val, elemtype))
+				return fixedinst;
+			return new InstType(slice, index, val, elemtype, size);
+		}
+
+		// mkslice %dst, %ptr, %len, elemtype
+		// ptr is a static register of cms#pointer, len is of cms#int64 or cms#uint64.
+		static Runtime::Instruction* compile_MakeSlice(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 4 || inst.data[3].type() != InstStruct::ET_Identifier) {
+				println("Error compile with illegal format of slice instruction.");
+				return NopeInst;
+			}
+			if (!getStaticRegisterTypes(inst, info, 3, types))
+				return NopeInst;
+			if (types[0].data != T_Slice || types[1].data != T_Pointer || !isIndexType(types[2])) {
+				println("Error compile with slice instruction of illegal register.");
+				return NopeInst;
+			}
+			TypeIndex elemtype = parseType(*_ptypeInfoMap, inst.data[3]);
+			if (_ptypeInfoMap->at(elemtype).size.data == 0) {
+				println("Error compile with slice of zero-sized element type.");
+				return NopeInst;
+			}
+			return new Runtime::Insts::MakeSlice(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1), getRegisterIndex(inst, 2), elemtype);
+		}
+
+		// slen %dst, %slice
+		// slen %dst, %string
+		// slen %dst, %map
+		// dst is a static register of cms#int64 or cms#uint64.
+		static Runtime::Instruction* compile_Length(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 2 || !getStaticRegisterTypes(inst, info, 2, types))
+				return NopeInst;
+			if (!isIndexType(types[0]) || (types[1].data != T_Slice && types[1].data != T_String && types[1].data != T_Map)) {
+				println("Error compile with slen of illegal register.");
+				return NopeInst;
+			}
+			if (types[1].data == T_String)
+				return new Runtime::Insts::StringLength(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1));
+			if (types[1].data == T_Map)
+				return new Runtime::Insts::MapSize(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1));
+			return new Runtime::Insts::SliceLength(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1));
+		}
+
+		// ldi %val, %slice, %idx
+		// sti %slice, %idx, %val
+		// The registers must be static, the index is of cms#int64 or cms#uint64,
+		// and the element type is the type of the value register.
+		static Runtime::Instruction* compile_ElementAccess(const InstStruct::Instruction &inst, const FunctionInfo &info, bool isstore) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 3 || !getStaticRegisterTypes(inst, info, 3, types))
+				return NopeInst;
+			size_t slicepos = isstore ? 0 : 1, indexpos = isstore ? 1 : 2, valpos = isstore ? 2 : 0;
+			if (types[slicepos].data != T_Slice || !isIndexType(types[indexpos])) {
+				println("Error compile with slice instruction of illegal register.");
+				return NopeInst;
+			}
+			if (isstore && !checkLiteralStore(inst.data[0]))
+				return NopeInst;
+			auto slice = getRegisterIndex(inst, slicepos), index = getRegisterIndex(inst, indexpos), val = getRegisterIndex(inst, valpos);
+			TypeIndex elemtype = types[valpos];
+			MemorySize size = _ptypeInfoMap->at(elemtype).size;
+			bool checked = !(_pboundscheckfree && _pboundscheckfree->count(&inst));
+
+			if (isstore) {
+				if (checked)
+					return createElementInst<StoreElementCheckedFixed, Runtime::Insts::StoreElement<true>>(slice, index, val, elemtype, size);
+				return createElementInst<StoreElementUncheckedFixed, Runtime::Insts::StoreElement<false>>(slice, index, val, elemtype, size);
+			}
+			else {
+				if (checked)
+					return createElementInst<LoadElementCheckedFixed, Runtime::Insts::LoadElement<true>>(slice, index, val, elemtype, size);
+				return createElementInst<LoadElementUncheckedFixed, Runtime::Insts::LoadElement<false>>(slice, index, val, elemtype, size);
+			}
+		}
+
+		// Check the registers at the positions are static registers of cms#string.
+		static bool checkStringRegisters(const std::vector<TypeIndex> &types, std::initializer_list<size_t> positions) {
+			for (size_t i : positions) {
+				if (types[i].data != T_String) {
+					println("Error compile with string instruction of non-string register.");
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// scat %dst, %lhs, %rhs
+		static Runtime::Instruction* compile_StringConcat(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 3 || !getStaticRegisterTypes(inst, info, 3, types) || !checkStringRegisters(types, { 0, 1, 2 }))
+				return NopeInst;
+			return new Runtime::Insts::StringConcat(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1), getRegisterIndex(inst, 2));
+		}
+
+		// scmp %dst, %lhs, %rhs
+		// The result (-1, 0 or 1) is written to the signed integer register dst.
+		static Runtime::Instruction* compile_StringCompare(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 3 || !getStaticRegisterTypes(inst, info, 3, types) || !checkStringRegisters(types, { 1, 2 }))
+				return NopeInst;
+			auto dst = getRegisterIndex(inst, 0), lhs = getRegisterIndex(inst, 1), rhs = getRegisterIndex(inst, 2);
+			auto result = dispatchNumericType(types[0], [&](auto tag) -> Runtime::Instruction* {
+				using Result = typename decltype(tag)::Type;
+				if constexpr (std::is_integral<Result>::value && std::is_signed<Result>::value)
+					return new Runtime::Insts::StringCompare<Result>(dst, lhs, rhs);
+				else
+					return nullptr;
+			});
+			if (!result) {
+				println("Error compile with string compare of non-signed-integer register.");
+				return NopeInst;
+			}
+			return result;
+		}
+
+		// shash %dst, %src
+		// dst is a static register of cms#int64 or cms#uint64.
+		static Runtime::Instruction* compile_StringHash(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 2 || !getStaticRegisterTypes(inst, info, 2, types) || !checkStringRegisters(types, { 1 }))
+				return NopeInst;
+			if (!isIndexType(types[0])) {
+				println("Error compile with string hash of illegal register.");
+				return NopeInst;
+			}
+			return new Runtime::Insts::StringHash(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1));
+		}
+
+		// ssub %dst, %src, %start, %len
+		// start and len are static registers of cms#int64 or cms#uint64.
+		static Runtime::Instruction* compile_StringSub(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 4 || !getStaticRegisterTypes(inst, info, 4, types) || !checkStringRegisters(types, { 0, 1 }))
+				return NopeInst;
+			if (!isIndexType(types[2]) || !isIndexType(types[3])) {
+				println("Error compile with substring of illegal register.");
+				return NopeInst;
+			}
+			return new Runtime::Insts::StringSub(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1), getRegisterIndex(inst, 2), getRegisterIndex(inst, 3));
+		}
+
+		// sintern %dst, %src
+		static Runtime::Instruction* compile_StringIntern(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 2 || !getStaticRegisterTypes(inst, info, 2, types) || !checkStringRegisters(types, { 0, 1 }))
+				return NopeInst;
+			return new Runtime::Insts::StringIntern(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1));
+		}
+
+		static Runtime::HashMap::MapType getMapType(TypeIndex keytype, TypeIndex valtype) {
+			const TypeInfo &keyinfo = _ptypeInfoMap->at(keytype);
+			const TypeInfo &valinfo = _ptypeInfoMap->at(valtype);
+			return Runtime::HashMap::MapType {
+				keytype.data, valtype.data, keyinfo.size.data, valinfo.size.data, valinfo.align.data, keytype.data == T_String
+			};
+		}
+
+		// mkmap %dst, keytype, valtype
+		// mkmap %dst, keytype, valtype, %capacity
+		// capacity is a static register of cms#int64 or cms#uint64.
+		static Runtime::Instruction* compile_MakeMap(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			size_t count = inst.data.size();
+			if ((count != 3 && count != 4) || inst.data[1].type() != InstStruct::ET_Identifier || inst.data[2].type() != InstStruct::ET_Identifier) {
+				println("Error compile with illegal format of map instruction.");
+				return NopeInst;
+			}
+			if (!getStaticRegisterTypes(inst, info, 1, types))
+				return NopeInst;
+			if (count == 4) {
+				Config::RegisterIndexType capacity;
+				if (!getStaticRegister(inst.data[3], info, capacity) || !isIndexType(getStvarbType(info, capacity))) {
+					println("Error compile with map capacity of illegal register.");
+					return NopeInst;
+				}
+			}
+			if (types[0].data != T_Map) {
+				println("Error compile with map instruction of illegal register.");
+				return NopeInst;
+			}
+			auto type = getMapType(parseType(*_ptypeInfoMap, inst.data[1]), parseType(*_ptypeInfoMap, inst.data[2]));
+			return new Runtime::Insts::MakeMap(getRegisterIndex(inst, 0), count == 4 ? getRegisterIndex(inst, 3) : 0, type);
+		}
+
+		// mput %map, %key, %val
+		// mdel %map, %key
+		// The types of key and value are the types of the registers.
+		static Runtime::Instruction* compile_MapUpdate(const InstStruct::Instruction &inst, const FunctionInfo &info, bool iserase) {
+			std::vector<TypeIndex> types;
+			size_t count = iserase ? 2 : 3;
+			if (inst.data.size() != count || !getStaticRegisterTypes(inst, info, count, types))
+				return NopeInst;
+			if (types[0].data != T_Map) {
+				println("Error compile with map instruction of illegal register.");
+				return NopeInst;
+			}
+			auto map = getRegisterIndex(inst, 0), key = getRegisterIndex(inst, 1);
+			if (iserase)
+				return new Runtime::Insts::MapErase(map, key, getMapType(types[1], TypeIndex(T_Void)));
+			return new Runtime::Insts::MapPut(map, key, getRegisterIndex(inst, 2), getMapType(types[1], types[2]));
+		}
+
+		// mget %found, %val, %map, %key
+		// found is a static register of integer type, set to 1 if the key is found, otherwise 0 (and val is cleared).
+		static Runtime::Instruction* compile_MapGet(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 4 || !getStaticRegisterTypes(inst, info, 4, types))
+				return NopeInst;
+			if (types[2].data != T_Map) {
+				println("Error compile with map instruction of illegal register.");
+				return NopeInst;
+			}
+			auto found = getRegisterIndex(inst, 0), val = getRegisterIndex(inst, 1), map = getRegisterIndex(inst, 2), key = getRegisterIndex(inst, 3);
+			auto type = getMapType(types[3], types[1]);
+			auto result = dispatchNumericType(types[0], [&](auto tag) -> Runtime::Instruction* {
+				using Found = typename decltype(tag)::Type;
+				if constexpr (std::is_integral<Found>::value)
+					return new Runtime::Insts::MapGet<Found>(found, val, map, key, type);
+				else
+					return nullptr;
+			});
+			if (!result) {
+				println("Error compile with map get of non-integer register.");
+				return NopeInst;
+			}
+			return result;
+		}
+
+		// mnext %pos, %key, %val, %map
+		// pos is a static register of cms#int64, begins with 0, and is set to -1 if no more elements.
+		static Runtime::Instruction* compile_MapNext(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() != 4 || !getStaticRegisterTypes(inst, info, 4, types))
+				return NopeInst;
+			if (types[0].data != T_Int64 || types[3].data != T_Map) {
+				println("Error compile with map instruction of illegal register.");
+				return NopeInst;
+			}
+			return new Runtime::Insts::MapNext(getRegisterIndex(inst, 0), getRegisterIndex(inst, 1), getRegisterIndex(inst, 2), getRegisterIndex(inst, 3), getMapType(types[1], types[2]));
+		}
+
+		// Get the operand of cpyn/tset at i, the register of cms#pointer is indirect (the destination must not be a literal pointer).
+		// The register itself is only for the immediate count, and size must be in the register.
+		// The stack registers (%sp[offset], %sp[offset](...)) are the memory at the offset from %sp,
+		// size must be in the space if it's not the full space.
+		static bool getBulkOperand(const InstStruct::Instruction &inst, const FunctionInfo &info, size_t i, bool immediate, uint64_t size, Runtime::Insts::BulkOperand &result) {
+			if (inst.data[i].type() == InstStruct::ET_Register && InstStruct::is_rt_stack(inst.data[i].get<InstStruct::Register>().registerType)) {
+				auto &reg = inst.data[i].get<InstStruct::Register>();
+				result.stack = true;
+				if (InstStruct::is_rt_stack_pointer(reg.registerType)) {
+					result.offset = std::get<InstStruct::StackPointerRegisterBase>(reg.data).offset.data;
+					return checkLocalStack(reg);
+				}
+				StackSpace space;
+				if (!getStackSpace(reg, space))
+					return false;
+				if (space.release) {
+					println("Error compile with decreasing stack space in bulk instruction.");
+					return false;
+				}
+				if (space.size.data != 0 && (!immediate || size > space.size.data)) {
+					println("Error compile with bulk instruction out of the size of stack space.");
+					return false;
+				}
+				result.offset = space.offset;
+				return true;
+			}
+			if (!getStaticRegister(inst.data[i], info, result.reg)) {
+				println("Error compile with non-static register.");
+				return false;
+			}
+			TypeIndex type = getStvarbType(info, result.reg);
+			result.indirect = type.data == T_Pointer;
+			if (result.indirect && i == 0 && !checkLiteralStore(inst.data[i]))
+				return false;
+			if (!result.indirect && (!immediate || size > _ptypeInfoMap->at(type).size.data)) {
+				println("Error compile with bulk instruction out of the size of register.");
+				return false;
+			}
+			return true;
+		}
+
+		// Get the count of cpyn/tset/salloc/sfree,
+		// a static register of cms#int64 or cms#uint64 (countreg), or an immediate (count).
+		static bool getBulkCount(const InstStruct::Element &elt, const FunctionInfo &info, Config::RegisterIndexType &countreg, uint64_t &count) {
+			countreg = 0;
+			count = 0;
+			if (elt.type() == InstStruct::ET_IntegerData) {
+				bool negative;
+				if (!elt.get<InstStruct::IntegerData>().get_inline(count, negative) || negative) {
+					println("Error compile with bulk instruction of illegal count.");
+					return false;
+				}
+			}
+			else if (!getStaticRegister(elt, info, countreg) || !isIndexType(getStvarbType(info, countreg))) {
+				println("Error compile with bulk instruction of illegal count register.");
+				return false;
+			}
+			return true;
+		}
+
+		// cpyn %dst, %src, %size
+		// tset %dst, %val, %count
+		// The count is a static register of cms#int64 or cms#uint64, or an immediate.
+		// cpyn copies size bytes (dst and src may overlap), tset stores the value of val for count times.
+		static Runtime::Instruction* compile_Bulk(const InstStruct::Instruction &inst, const FunctionInfo &info, bool isfill) {
+			if (inst.data.size() != 3) {
+				println("Error type for inst");
+				return NopeInst;
+			}
+			Config::RegisterIndexType countreg;
+			uint64_t count;
+			if (!getBulkCount(inst.data[2], info, countreg, count))
+				return NopeInst;
+			bool immediate = countreg == 0;
+			Runtime::Insts::BulkOperand dst;
+			if (isfill) {
+				Config::RegisterIndexType val;
+				if (!getStaticRegister(inst.data[1], info, val)) {
+					println("Error compile with non-static register.");
+					return NopeInst;
+				}
+				MemorySize valsize = _ptypeInfoMap->at(getStvarbType(info, val)).size;
+				if (valsize.data == 0) {
+					println("Error compile with tset of zero-sized value.");
+					return NopeInst;
+				}
+				if (immediate && count > std::numeric_limits<uint64_t>::max() / valsize.data) {
+					println("Error compile with bulk instruction out of the size of register.");
+					return NopeInst;
+				}
+				if (!getBulkOperand(inst, info, 0, immediate, count * valsize.data, dst))
+					return NopeInst;
+				return new Runtime::Insts::FillN(dst, val, valsize, countreg, count);
+			}
+			Runtime::Insts::BulkOperand src;
+			if (!getBulkOperand(inst, info, 0, immediate, count, dst) || !getBulkOperand(inst, info, 1, immediate, count, src))
+				return NopeInst;
+			return new Runtime::Insts::CopyN(dst, src, countreg, count);
+		}
+
+		// salloc %size
+		// sfree %size
+		// The size is a static register of cms#int64 or cms#uint64, an immediate, or a type (the size of it).
+		// salloc moves %sp down by size (rounded up to 8 bytes), sfree moves it up.
+		static Runtime::Instruction* compile_StackResize(const InstStruct::Instruction &inst, const FunctionInfo &info, bool isrelease) {
+			if (inst.data.size() != 1) {
+				println("Error compile with illegal format of stack instruction.");
+				return NopeInst;
+			}
+			Config::RegisterIndexType sizereg = 0;
+			uint64_t size = 0;
+			if (inst.data[0].type() == InstStruct::ET_Identifier) {
+				TypeIndex type;
+				if (!_ptypeInfoMap->find(inst.data[0].get<InstStruct::Identifier>().data(), type)) {
+					println("Error compile with stack instruction of undefined type.");
+					return NopeInst;
+				}
+				size = _ptypeInfoMap->at(type).size.data;
+			}
+			else if (!getBulkCount(inst.data[0], info, sizereg, size)) {
+				return NopeInst;
+			}
+			if (isrelease)
+				return new Runtime::Insts::StackResize<true>(sizereg, size);
+			return new Runtime::Insts::StackResize<false>(sizereg, size);
+		}
+
+		// Call func with the TypeTag of the C++ type of the atomic type (the integer types, cms#pointer as void*),
+		// return nullptr if it is not atomic.
+		template <typename Func>
+		static Runtime::Instruction* dispatchAtomicType(TypeIndex type, Func func) {
+			if (type.data == T_Pointer)
+				return func(TypeTag<void*>());
+			if (!isIntegerType(type))
+				return nullptr;
+			return dispatchNumericType(type, func);
+		}
+
+		static bool parseMemoryOrder(const InstStruct::Element &elt, std::memory_order &result) {
+			static const std::map<std::string, std::memory_order> ordermap {
+				{ "relaxed", std::memory_order_relaxed },
+				{ "acquire", std::memory_order_acquire },
+				{ "release", std::memory_order_release },
+				{ "acq_rel", std::memory_order_acq_rel },
+				{ "seq_cst", std::memory_order_seq_cst },
+			};
+			if (elt.type() == InstStruct::ET_Identifier) {
+				auto iter = ordermap.find(_phashStringPool->get(elt.get<InstStruct::Identifier>().data()));
+				if (iter != ordermap.end()) {
+					result = iter->second;
+					return true;
+				}
+			}
+			println("Error compile with illegal memory order.");
+			return false;
+		}
+
+		// aload %dst, %gobj, order
+		// astore %gobj, %src, order
+		// afadd %dst, %gobj, %val, order
+		// acas %ok, %gobj, %expected, %desired, order
+		// The object is a static global register (%g) of an integer type or cms#pointer,
+		// the other registers are static and of the same type, except ok (cms#int64 or cms#uint64).
+		// The order is relaxed, acquire, release, acq_rel or seq_cst,
+		// aload can't be release (or acq_rel), astore can't be acquire (or acq_rel), afadd isn't for cms#pointer.
+		static Runtime::Instruction* compile_Atomic(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			size_t count;
+			size_t objpos = 1;
+			switch (inst.instcode) {
+			case InstStruct::i_aload: count = 2; break;
+			case InstStruct::i_astore: count = 2; objpos = 0; break;
+			case InstStruct::i_afadd: count = 3; break;
+			default: count = 4; break;
+			}
+			std::vector<TypeIndex> types;
+			std::memory_order order;
+			if (inst.data.size() != count + 1 || !getStaticRegisterTypes(inst, info, count, types) || !parseMemoryOrder(inst.data[count], order))
+				return NopeInst;
+			auto obj = getRegisterIndex(inst, objpos);
+			if (!Config::is_global(obj)) {
+				println("Error compile with atomic instruction of non-global register.");
+				return NopeInst;
+			}
+			for (size_t i = inst.instcode == InstStruct::i_acas ? 2 : 0; i != count; ++i) {
+				if (types[i].data != types[objpos].data) {
+					println("Error compile with atomic instruction of different types.");
+					return NopeInst;
+				}
+			}
+			if (inst.instcode == InstStruct::i_acas && !isIndexType(types[0])) {
+				println("Error compile with acas of illegal result register.");
+				return NopeInst;
+			}
+			bool isload = order == std::memory_order_acquire || order == std::memory_order_consume;
+			bool isstore = order == std::memory_order_release;
+			if ((inst.instcode == InstStruct::i_aload && (isstore || order == std::memory_order_acq_rel)) ||
+			    (inst.instcode == InstStruct::i_astore && (isload || order == std::memory_order_acq_rel))) {
+				println("Error compile with illegal memory order of the atomic instruction.");
+				return NopeInst;
+			}
+			auto result = dispatchAtomicType(types[objpos], [&](auto tag) -> Runtime::Instruction* {
+				using T = typename decltype(tag)::Type;
+				if constexpr (std::is_floating_point<T>::value) {
+					return nullptr;
+				}
+				else {
+					switch (inst.instcode) {
+					case InstStruct::i_aload:
+						return new Runtime::Insts::AtomicLoad<T>(getRegisterIndex(inst, 0), obj, order);
+					case InstStruct::i_astore:
+						return new Runtime::Insts::AtomicStore<T>(obj, getRegisterIndex(inst, 1), order);
+					case InstStruct::i_afadd:
+						if constexpr (std::is_pointer<T>::value)
+							return nullptr;
+						else
+							return new Runtime::Insts::AtomicFetchAdd<T>(getRegisterIndex(inst, 0), obj, getRegisterIndex(inst, 2), order);
+					default:
+						return new Runtime::Insts::AtomicCompareExchange<T>(getRegisterIndex(inst, 0), obj, getRegisterIndex(inst, 2), getRegisterIndex(inst, 3), order);
+					}
+				}
+			});
+			if (!result) {
+				println("Error compile with atomic instruction of illegal type.");
+				return NopeInst;
+			}
+			return result;
+		}
+
+		InstStruct::LabelKeyTable *labelkeytable = nullptr;   // TODO
+
+		static Runtime::Instruction* compile_Jump(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			if (check(inst.data, { InstStruct::ET_LineLabel })) {
+				InstStruct::LineLabel label = inst.data[0].get<InstStruct::LineLabel>();
+				size_t line = (*labelkeytable)[label.data()];
+				return new Runtime::Insts::Jump(static_cast<Config::LineCountType>(line));
+			}
+			return NopeInst;
+		}
+
+		static bool getLabelLine(const InstStruct::Element &elt, Config::LineCountType &line) {
+			if (elt.type() != InstStruct::ET_LineLabel) {
+				println("Error compile with illegal label.");
+				return false;
+			}
+			auto iter = labelkeytable->find(elt.get<InstStruct::LineLabel>().data());
+			if (iter == labelkeytable->end()) {
+				println("Error compile with undefined label.");
+				return false;
+			}
+			line = iter->second;
+			return true;
+		}
+
+		// The max size of the jump table of switch.
+		constexpr uint64_t MaxSwitchTableSize = 4096;
+
+		// switch %val, #default, case, #label, ...
+		// val is a static register of an integer type, the cases are the distinct immediates of the type.
+		// The dense cases (at least 1/3 of their range) are compiled to a jump table, the others to a binary search.
+		static Runtime::Instruction* compile_Switch(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+			std::vector<TypeIndex> types;
+			if (inst.data.size() < 2 || inst.data.size() % 2 != 0) {
+				println("Error compile with illegal format of switch.");
+				return NopeInst;
+			}
+			Config::LineCountType defaultline;
+			if (!getStaticRegisterTypes(inst, info, 1, types) || !getLabelLine(inst.data[1], defaultline))
+				return NopeInst;
+			auto val = getRegisterIndex(inst, 0);
+			auto result = dispatchNumericType(types[0], [&](auto tag) -> Runtime::Instruction* {
+				using Int = typename decltype(tag)::Type;
+				if constexpr (std::is_integral<Int>::value) {
+					using Unsigned = std::make_unsigned_t<Int>;
+					std::vector<std::pair<Int, Config::LineCountType>> cases;
+					for (size_t i = 2; i != inst.data.size(); i += 2) {
+						Int key;
+						Config::LineCountType line;
+						if (inst.data[i].type() != InstStruct::ET_IntegerData) {
+							println("Error compile with illegal case of switch.");
+							return NopeInst;
+						}
+						if (!parseIntegerImmediate(inst.data[i], types[0], key) || !getLabelLine(inst.data[i + 1], line))
+							return NopeInst;
+						cases.emplace_back(key, line);
+					}
+					std::sort(cases.begin(), cases.end());
+					for (size_t i = 1; i < cases.size(); ++i) {
+						if (cases[i - 1].first == cases[i].first) {
+							println("Error compile with duplicate case of switch.");
+							return NopeInst;
+						}
+					}
+					if (cases.empty())
+						return new Runtime::Insts::Jump(defaultline);
+
+					Int min = cases.front().first;
+					uint64_t span = static_cast<Unsigned>(static_cast<Unsigned>(cases.back().first) - static_cast<Unsigned>(min));
+					if (span < MaxSwitchTableSize && span + 1 <= cases.size() * 3) {
+						std::vector<Config::LineCountType> table(static_cast<size_t>(span + 1), defaultline);
+						for (auto &c : cases)
+							table[static_cast<Unsigned>(static_cast<Unsigned>(c.first) - static_cast<Unsigned>(min))] = c.second;
+						return new Runtime::Insts::SwitchTable<Int>(val, min, defaultline, std::move(table));
+					}
+					std::vector<Int> keys;
+					std::vector<Config::LineCountType> lines;
+					for (auto &c : cases) {
+						keys.push_back(c.first);
+						lines.push_back(c.second);
+					}
+					return new Runtime::Insts::SwitchSearch<Int>(val, defaultline, std::move(keys), std::move(lines));
+				}
+				else {
+					return nullptr;
+				}
+			});
+			if (!result) {
+				println("Error compile with switch of non-integer register.");
+				return NopeInst;
+			}
+			return result;
+		}
+	}
+
+	Runtime::Instruction* Compiler::compile(const InstStruct::Instruction &inst, const FunctionInfo &info) {
+		using namespace Compile;
+
+		if (inst.instcode == InstStruct::i_nop) {
+			return NopeInst;
+		}
+		else if (inst.instcode == InstStruct::i_mov) {
+			return compile_Move(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_load) {
+			return compile_Load(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_loadp) {
+			return compile_LoadPointer(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ret) {
+			return new Runtime::Insts::Return();
+		}
+		else if (inst.instcode == InstStruct::i_jump) {
+			return compile_Jump(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_switch) {
+			return compile_Switch(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_tset) {
+			return compile_Bulk(inst, info, true);
+		}
+		else if (inst.instcode == InstStruct::i_cpyn) {
+			return compile_Bulk(inst, info, false);
+		}
+		else if (inst.instcode == InstStruct::i_salloc) {
+			return compile_StackResize(inst, info, false);
+		}
+		else if (inst.instcode == InstStruct::i_sfree) {
+			return compile_StackResize(inst, info, true);
+		}
+		else if (inst.instcode == InstStruct::i_aload || inst.instcode == InstStruct::i_astore || inst.instcode == InstStruct::i_afadd || inst.instcode == InstStruct::i_acas) {
+			return compile_Atomic(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_call) {
+			if (auto lowered = lowerOperatorCall(inst, info))
+				return lowered;
+			return compile_Call(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ldf) {
+			return compile_Field(inst, info, false);
+		}
+		else if (inst.instcode == InstStruct::i_stf) {
+			return compile_Field(inst, info, true);
+		}
+		else if (inst.instcode == InstStruct::i_fadd) {
+			return compile_FloatArith<std::plus>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_fsub) {
+			return compile_FloatArith<std::minus>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_fmul) {
+			return compile_FloatArith<std::multiplies>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_fdiv) {
+			return compile_FloatArith<std::divides>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_fneg) {
+			return compile_FloatNeg(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_feq) {
+			return compile_FloatCompare<std::equal_to>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_fne) {
+			return compile_FloatCompare<std::not_equal_to>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_flt) {
+			return compile_FloatCompare<std::less>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_fle) {
+			return compile_FloatCompare<std::less_equal>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_fcvt) {
+			return compile_FloatConvert(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_iadd) {
+			return compile_IntegerBinary<Runtime::Integer::Add>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_isub) {
+			return compile_IntegerBinary<Runtime::Integer::Sub>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_imul) {
+			return compile_IntegerBinary<Runtime::Integer::Mul>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_idiv) {
+			return compile_IntegerBinary<Runtime::Integer::Div>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_irem) {
+			return compile_IntegerBinary<Runtime::Integer::Rem>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_iand) {
+			return compile_IntegerBinary<Runtime::Integer::And>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ior) {
+			return compile_IntegerBinary<Runtime::Integer::Or>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ixor) {
+			return compile_IntegerBinary<Runtime::Integer::Xor>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ishl) {
+			return compile_IntegerBinary<Runtime::Integer::Shl>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ishr) {
+			return compile_IntegerBinary<Runtime::Integer::Shr>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ineg) {
+			return compile_IntegerUnary<Runtime::Integer::Neg>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_iaddc) {
+			return compile_IntegerBinary<Runtime::Integer::CheckedAdd>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_isubc) {
+			return compile_IntegerBinary<Runtime::Integer::CheckedSub>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_imulc) {
+			return compile_IntegerBinary<Runtime::Integer::CheckedMul>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_idivc) {
+			return compile_IntegerBinary<Runtime::Integer::CheckedDiv>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_inegc) {
+			return compile_IntegerUnary<Runtime::Integer::CheckedNeg>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ieq) {
+			return compile_IntegerCompare<std::equal_to>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ine) {
+			return compile_IntegerCompare<std::not_equal_to>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ilt) {
+			return compile_IntegerCompare<std::less>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ile) {
+			return compile_IntegerCompare<std::less_equal>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_igt) {
+			return compile_IntegerCompare<std::greater>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ige) {
+			return compile_IntegerCompare<std::greater_equal>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_vadd) {
+			return compile_VectorBinary(inst, info, Runtime::VectorKernel::vo_add);
+		}
+		else if (inst.instcode == InstStruct::i_vsub) {
+			return compile_VectorBinary(inst, info, Runtime::VectorKernel::vo_sub);
+		}
+		else if (inst.instcode == InstStruct::i_vmul) {
+			return compile_VectorBinary(inst, info, Runtime::VectorKernel::vo_mul);
+		}
+		else if (inst.instcode == InstStruct::i_vmin) {
+			return compile_VectorBinary(inst, info, Runtime::VectorKernel::vo_min);
+		}
+		else if (inst.instcode == InstStruct::i_vmax) {
+			return compile_VectorBinary(inst, info, Runtime::VectorKernel::vo_max);
+		}
+		else if (inst.instcode == InstStruct::i_vcmpeq) {
+			return compile_VectorBinary(inst, info, Runtime::VectorKernel::vo_eq);
+		}
+		else if (inst.instcode == InstStruct::i_vcmplt) {
+			return compile_VectorBinary(inst, info, Runtime::VectorKernel::vo_lt);
+		}
+		else if (inst.instcode == InstStruct::i_vshuf) {
+			return compile_VectorShuffle(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_vradd) {
+			return compile_VectorReduce(inst, info, Runtime::VectorKernel::vo_add);
+		}
+		else if (inst.instcode == InstStruct::i_vrmin) {
+			return compile_VectorReduce(inst, info, Runtime::VectorKernel::vo_min);
+		}
+		else if (inst.instcode == InstStruct::i_vrmax) {
+			return compile_VectorReduce(inst, info, Runtime::VectorKernel::vo_max);
+		}
+		else if (inst.instcode == InstStruct::i_badd) {
+			return compile_BigIntArith<Runtime::BigInt::Add>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_bsub) {
+			return compile_BigIntArith<Runtime::BigInt::Sub>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_bmul) {
+			return compile_BigIntArith<Runtime::BigInt::Mul>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_bdiv) {
+			return compile_BigIntArith<Runtime::BigInt::Div>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_brem) {
+			return compile_BigIntArith<Runtime::BigInt::Rem>(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_bneg) {
+			return compile_BigIntNeg(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_bcmp) {
+			return compile_BigIntCompare(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_bcvt) {
+			return compile_BigIntConvert(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_mkslice) {
+			return compile_MakeSlice(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_slen) {
+			return compile_Length(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ldi) {
+			return compile_ElementAccess(inst, info, false);
+		}
+		else if (inst.instcode == InstStruct::i_sti) {
+			return compile_ElementAccess(inst, info, true);
+		}
+		else if (inst.instcode == InstStruct::i_scat) {
+			return compile_StringConcat(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_scmp) {
+			return compile_StringCompare(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_shash) {
+			return compile_StringHash(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_ssub) {
+			return compile_StringSub(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_sintern) {
+			return compile_StringIntern(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_mkmap) {
+			return compile_MakeMap(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_mput) {
+			return compile_MapUpdate(inst, info, false);
+		}
+		else if (inst.instcode == InstStruct::i_mget) {
+			return compile_MapGet(inst, info);
+		}
+		else if (inst.instcode == InstStruct::i_mdel) {
+			return compile_MapUpdate(inst, info, true);
+		}
+		else if (inst.instcode == InstStruct::i_mnext) {
+			return compile_MapNext(inst, info);
+		}
+		else if (inst.instcode == InstStruct::id_opreg) {
+			return new Runtime::InstsDebug::OutputRegister();
+		}
+		else {
+			println(inst.instcode);
+			return NopeInst;
+		}
+
+		assert(false);
+
+		return NopeInst;
+	}
+}
 
 #include "parser/parse.h"
 #include "inststruct/identkeytable.h"
 
 namespace CVM
 {
-	Runtime::InstFunction Compiler::compile(const InstStruct::Function &func) {
+	Runtime::InstFunction Compiler::compile(Config::FuncIndexType id, const InstStruct::Function &func) {
 		const InstStruct::InstList &src = func.instdata;
 		Runtime::InstFunction::InstList dst;
 		FunctionInfo&info = const_cast<FunctionInfo&>(func.info); // TODO
 
 		CVM::Compile::labelkeytable = (InstStruct::LabelKeyTable*)&func.labelkeytable; // TODO
+		Compile::BoundsCheckFreeSet boundscheckfree = Compile::findBoundsCheckFree(func);
+		CVM::Compile::_pboundscheckfree = &boundscheckfree; // TODO
+		Compile::LiteralRegisterSet literalregisters = Compile::findLiteralRegisters(func);
+		CVM::Compile::_pliteralregisters = &literalregisters; // TODO
 
 		std::transform(src.begin(), src.end(), std::back_inserter(dst), [&](const InstStruct::Instruction *inst) {
 			return compile(*inst, info);
 		});
 
-		return Runtime::InstFunction(std::move(dst), std::move(info));
+		CVM::Compile::_pboundscheckfree = nullptr;
+		CVM::Compile::_pliteralregisters = nullptr;
+
+		return Runtime::InstFunction(std::move(dst), std::move(info), id);
 	}
 
-	bool Compiler::compile(InstStruct::GlobalInfo &globalinfo, const Runtime::PtrFuncMap &pfm, Runtime::FuncTable &functable) {
+	bool Compiler::compile(InstStruct::GlobalInfo &globalinfo, const Runtime::PtrFuncMap &pfm, const Runtime::IntrinsicMap &ifm, Runtime::FuncTable &functable) {
 		InstStruct::IdentKeyTable &ikt = globalinfo.funcTable;
 
 		// Get entry func
@@ -393,13 +2604,19 @@ namespace CVM
 
 		// TODO
 		Compile::_ptypeInfoMap = &globalinfo.typeInfoMap;  // TODO!!
+		Compile::_phashStringPool = &globalinfo.hashStringPool;  // TODO!!
 		Compile::_pfuncTable = &globalinfo.funcTable;  // TODO!!
+		Compile::_pliteralDataPool = &globalinfo.literalDataPool;  // TODO!!
+		Compile::_pintrinsicMap = &ifm;  // TODO!!
+		Compile::_pptrFuncMap = &pfm;  // TODO!!
+		Compile::_pglobalTypeList = &globalinfo.globalTypeList;  // TODO!!
+		Compile::_pthreadTypeList = &globalinfo.threadTypeList;  // TODO!!
 
 		// Compile All Functions
 
 		ikt.each([&](Config::FuncIndexType id, const InstStruct::IdentKeyTable::FuncPtr &f) {
 			if (f) {
-				Runtime::Function *fp = new Runtime::InstFunction(compile(*f));
+				Runtime::Function *fp = new Runtime::InstFunction(compile(id, *f));
 				functable.insert({ id, fp });
 			}});
 
@@ -408,6 +2625,12 @@ namespace CVM
 			functable.insert({ id, new Runtime::PointerFunction(pair.second) });
 		}
 
+		if (Runtime::HeapProfile::IsEnabled()) {
+			ikt.eachKey([&](const HashID &key, Config::FuncIndexType id) {
+				Runtime::HeapProfile::SetFuncName(id, globalinfo.hashStringPool.get(key));
+			});
+		}
+
 		return true;
 	}
 }
@@ -417,38 +2640,56 @@ namespace CVM
 	// TODO : Move these code to other file.
 	namespace Compile
 	{
+		// The static registers are placed in a frame, which is cleared if any of their types needs (e.g. cms#bigint must be valid).
+		static Runtime::DataRegisterSet createDataRegisterSet(Config::RegisterIndexType dycount, const TypeIndex *typelist, Config::RegisterIndexType stcount, const TypeInfoMap &tim) {
+			Runtime::DataRegisterSet::DyDatRegSize dysize(dycount);
+			Runtime::DataRegisterSet::StDatRegSize stsize(stcount);
+
+			Runtime::DataRegisterSetStatic::LayoutList layoutlist(stcount);
+
+			bool needclear = false;
+			for (Config::RegisterIndexType i = 0; i != stcount; ++i) {
+				const TypeInfo &typeinfo = tim.at(typelist[i]);
+				layoutlist[i].size = typeinfo.size;
+				layoutlist[i].align = typeinfo.align;
+				needclear = needclear || typeinfo.needclear;
+			}
+
+			MemorySize size = Runtime::DataRegisterSetStatic::GetFrameSize(layoutlist);
+			MemorySize align = Runtime::DataRegisterSetStatic::GetFrameAlign(layoutlist);
+			Runtime::DataPointer address = Runtime::DataManage::AllocFrame(size, align);
+			if (needclear)
+				Runtime::MemoryKernel::Clear(address.get(), size.data);
+
+			return Runtime::DataRegisterSet(dysize, stsize, address, layoutlist);
+		}
+
 		Runtime::LocalEnvironment* CreateLoaclEnvironment(const Runtime::InstFunction &func, const TypeInfoMap &tim) {
 			const auto &info = func.info();
 
 			// Initialize DataRegisterSet
-			Runtime::DataRegisterSet::DyDatRegSize dysize(info.dyvarb_count());
-			Runtime::DataRegisterSet::StDatRegSize stsize(info.stvarb_count());
-
-			const auto &typelist = info.sttypelist();
-			Runtime::DataRegisterSetStatic::SizeList sizelist(info.stvarb_count());
+			Runtime::DataRegisterSet drs = createDataRegisterSet(info.dyvarb_count(), info.sttypelist(), info.stvarb_count(), tim);
 
-			MemorySize size;
-			for (Config::RegisterIndexType i = 0; i != info.stvarb_count(); ++i) {
-				const TypeIndex& type = typelist[i];
-				MemorySize s = tim.at(type).size;
-				sizelist[i] = s;
-				size += s;
-			}
-
-			Runtime::DataPointer address = Runtime::DataManage::Alloc(size);
+			// Return Environment
+			Runtime::LocalEnvironment *result = new Runtime::LocalEnvironment(drs, func);
+			if (Runtime::HeapProfile::IsEnabled())
+				Runtime::HeapProfile::RecordAlloc(result, sizeof(Runtime::LocalEnvironment), Runtime::HeapProfile::ak_frame);
+			return result;
+		}
 
-			Runtime::DataRegisterSet drs(dysize, stsize, address, sizelist);
+		// The frames of the global and thread registers live as long as the program (they're allocated before the entry).
+		Runtime::GlobalEnvironment* CreateGlobalEnvironment(Config::RegisterIndexType dysize, const std::vector<TypeIndex> &sttypelist, const TypeInfoMap *tim, const LiteralDataPool *datasmap, const Runtime::FuncTable *functable, HashStringPool *hashStringPool) {
+			Runtime::DataRegisterSet drs = createDataRegisterSet(dysize, sttypelist.data(), static_cast<Config::RegisterIndexType>(sttypelist.size()), *tim);
 
 			// Return Environment
-			return new Runtime::LocalEnvironment(drs, func);
+			return new Runtime::GlobalEnvironment(drs, tim, datasmap, functable, hashStringPool);
 		}
 
-		Runtime::GlobalEnvironment* CreateGlobalEnvironment(Config::RegisterIndexType dysize, const TypeInfoMap *tim, const LiteralDataPool *datasmap, const Runtime::FuncTable *functable, HashStringPool *hashStringPool) {
-			Runtime::DataRegisterSet::DyDatRegSize _dysize(dysize);
-			Runtime::DataRegisterSet drs(_dysize);
+		Runtime::ThreadEnvironment* CreateThreadEnvironment(const std::vector<TypeIndex> &sttypelist, const TypeInfoMap &tim) {
+			Runtime::DataRegisterSet drs = createDataRegisterSet(0, sttypelist.data(), static_cast<Config::RegisterIndexType>(sttypelist.size()), tim);
 
 			// Return Environment
-			return new Runtime::GlobalEnvironment(drs, tim, datasmap, functable, hashStringPool);
+			return new Runtime::ThreadEnvironment(drs);
 		}
 	}
 }
@@ -0,0 +1,147 @@
+#include "basic.h"
+#include "compress.h"
+#include <cstring>
+#include <cassert>
+
+namespace CVM
+{
+	namespace Compress
+	{
+		// Sequence:
+		//   token (literal length : 4 | match length - MinMatch : 4)
+		//   [literal length extension] literals
+		//   offset (16 bits, LSB) [match length extension]
+		// The extension is a run of 255 and the last byte less than 255.
+		// The last sequence has only literals.
+
+		constexpr size_t MinMatch = 4;
+		constexpr size_t LastLiterals = 5;
+		constexpr size_t MinCompressSize = 12;
+		constexpr unsigned int HashBits = 12;
+		constexpr uint32_t NoPosition = UINT32_MAX;
+
+		static uint32_t Read32(const uint8_t *p) {
+			uint32_t result;
+			std::memcpy(&result, p, sizeof(result));
+			return result;
+		}
+
+		static uint32_t Hash(uint32_t seq) {
+			return (seq * 2654435761u) >> (32 - HashBits);
+		}
+
+		static uint8_t* WriteLength(uint8_t *op, size_t length) {
+			while (length >= 255) {
+				*op++ = 255;
+				length -= 255;
+			}
+			*op++ = static_cast<uint8_t>(length);
+			return op;
+		}
+
+		static uint8_t* WriteSequence(uint8_t *op, const uint8_t *literal, size_t litlen, size_t offset, size_t matchlen) {
+			uint8_t *token = op++;
+			*token = static_cast<uint8_t>((litlen >= 15 ? 15 : litlen) << 4);
+			if (litlen >= 15)
+				op = WriteLength(op, litlen - 15);
+			if (litlen != 0)
+				std::memcpy(op, literal, litlen);
+			op += litlen;
+			if (matchlen != 0) {
+				*op++ = static_cast<uint8_t>(offset);
+				*op++ = static_cast<uint8_t>(offset >> 8);
+				size_t mlen = matchlen - MinMatch;
+				*token |= static_cast<uint8_t>(mlen >= 15 ? 15 : mlen);
+				if (mlen >= 15)
+					op = WriteLength(op, mlen - 15);
+			}
+			return op;
+		}
+
+		size_t CompressBlock(const uint8_t *src, size_t size, uint8_t *dst) {
+			assert(size <= MaxBlockSize);
+			const uint8_t *ip = src;
+			const uint8_t *anchor = src;
+			const uint8_t *end = src + size;
+			uint8_t *op = dst;
+
+			if (size >= MinCompressSize) {
+				uint32_t table[1 << HashBits];
+				for (auto &pos : table)
+					pos = NoPosition;
+				const uint8_t *limit = end - (MinMatch + LastLiterals);
+				while (ip < limit) {
+					uint32_t seq = Read32(ip);
+					uint32_t &slot = table[Hash(seq)];
+					uint32_t candidate = slot;
+					slot = static_cast<uint32_t>(ip - src);
+					if (candidate != NoPosition && Read32(src + candidate) == seq) {
+						const uint8_t *match = src + candidate;
+						size_t matchlen = MinMatch;
+						while (ip + matchlen < end - LastLiterals && ip[matchlen] == match[matchlen])
+							++matchlen;
+						op = WriteSequence(op, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - match), matchlen);
+						ip += matchlen;
+						anchor = ip;
+					}
+					else {
+						++ip;
+					}
+				}
+			}
+			op = WriteSequence(op, anchor, static_cast<size_t>(end - anchor), 0, 0);
+			return static_cast<size_t>(op - dst);
+		}
+
+		static bool ReadLength(const uint8_t *&ip, const uint8_t *iend, size_t &length) {
+			uint8_t b;
+			do {
+				if (ip >= iend)
+					return false;
+				b = *ip++;
+				length += b;
+			} while (b == 255);
+			return true;
+		}
+
+		bool DecompressBlock(const uint8_t *src, size_t srcsize, uint8_t *dst, size_t dstsize) {
+			const uint8_t *ip = src;
+			const uint8_t *iend = src + srcsize;
+			uint8_t *op = dst;
+			uint8_t *oend = dst + dstsize;
+
+			while (ip < iend) {
+				uint8_t token = *ip++;
+				size_t litlen = token >> 4;
+				if (litlen == 15 && !ReadLength(ip, iend, litlen))
+					return false;
+				if (litlen > static_cast<size_t>(iend - ip) || litlen > static_cast<size_t>(oend - op))
+					return false;
+				if (litlen != 0)
+					std::memcpy(op, ip, litlen);
+				op += litlen;
+				ip += litlen;
+				if (ip == iend)
+					break;
+				if (iend - ip < 2)
+					return false;
+				size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+				ip += 2;
+				if (offset == 0 || offset > static_cast<size_t>(op - dst))
+					return false;
+				size_t matchlen = token & 15;
+				if (matchlen == 15 && !ReadLength(ip, iend, matchlen))
+					return false;
+				matchlen += MinMatch;
+				if (matchlen > static_cast<size_t>(oend - op))
+					return false;
+				// The match may overlap the output, so copy by bytes.
+				const uint8_t *match = op - offset;
+				for (size_t i = 0; i != matchlen; ++i)
+					op[i] = match[i];
+				op += matchlen;
+			}
+			return op == oend;
+		}
+	}
+}
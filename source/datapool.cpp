@@ -0,0 +1,310 @@
+#include "basic.h"
+#include "datapool.h"
+#include "compress.h"
+#include <cstdio>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <unistd.h>
+#endif
+
+namespace CVM
+{
+	static_assert(sizeof(LiteralDataPool::SectionHeader) == 64, "The size of SectionHeader must be 64.");
+
+	static_assert(LiteralDataPool::CompressBlockSize <= Compress::MaxBlockSize, "The compressed block is too large.");
+
+	template <typename T>
+	static T ReadValue(const uint8_t *p) {
+		T result;
+		std::memcpy(&result, p, sizeof(T));
+		return result;
+	}
+
+	template <typename T>
+	static void AppendValue(std::vector<uint8_t> &image, const T &value) {
+		const uint8_t *p = reinterpret_cast<const uint8_t*>(&value);
+		image.insert(image.end(), p, p + sizeof(T));
+	}
+
+	static uint64_t GetBlockCount(uint64_t size) {
+		return (size + LiteralDataPool::CompressBlockSize - 1) / LiteralDataPool::CompressBlockSize;
+	}
+
+	static uint64_t GetBlockRawSize(uint64_t size, uint64_t index) {
+		return std::min(LiteralDataPool::CompressBlockSize, size - index * LiteralDataPool::CompressBlockSize);
+	}
+
+	//---------------------------------------------------------------------------------------------
+	// * LazyLiteral
+	//---------------------------------------------------------------------------------------------
+	void LazyLiteral::decompress() const {
+		uint64_t size = _size.data;
+		_data.reset(new uint8_t[size ? size : 1]);
+		uint64_t blockcount = ReadValue<uint64_t>(_record);
+		const uint8_t *table = _record + sizeof(uint64_t);
+		const uint8_t *block = table + blockcount * sizeof(uint32_t);
+		for (uint64_t i = 0; i != blockcount; ++i) {
+			uint64_t blocksize = ReadValue<uint32_t>(table + i * sizeof(uint32_t));
+			uint64_t rawsize = GetBlockRawSize(size, i);
+			uint8_t *dst = _data.get() + i * LiteralDataPool::CompressBlockSize;
+			if (blocksize == rawsize)
+				std::memcpy(dst, block, static_cast<size_t>(rawsize));
+			else if (!Compress::DecompressBlock(block, static_cast<size_t>(blocksize), dst, static_cast<size_t>(rawsize))) {
+				println("Error in decompress literal data.");
+				exit(-1);
+			}
+			block += blocksize;
+		}
+		assert(block == _record + _recordsize);
+	}
+
+	//---------------------------------------------------------------------------------------------
+	// * LiteralDataPool
+	//---------------------------------------------------------------------------------------------
+	const LazyLiteral* LiteralDataPool::lazy(const FileID &fileid, const DataID &dataid) const {
+		assert(has(fileid, dataid));
+		const SectionEntry &entry = getEntry(fileid, dataid);
+		if (!(entry.offset & CompressedFlag))
+			return nullptr;
+		uint64_t offset = entry.offset & ~CompressedFlag;
+		std::lock_guard<std::mutex> lock(_lazymutex);
+		auto &result = _lazys[offset];
+		if (!result) {
+			const uint8_t *record = _base + offset;
+			uint64_t blockcount = ReadValue<uint64_t>(record);
+			uint64_t recordsize = sizeof(uint64_t) + blockcount * sizeof(uint32_t);
+			for (uint64_t i = 0; i != blockcount; ++i)
+				recordsize += ReadValue<uint32_t>(record + sizeof(uint64_t) + i * sizeof(uint32_t));
+			result.reset(new LazyLiteral(record, recordsize, MemorySize(static_cast<MemorySize::Type>(entry.size))));
+		}
+		return result.get();
+	}
+
+	// Check the record is in the data, and its blocks match the size.
+	bool LiteralDataPool::checkRecord(uint64_t offset, uint64_t size) const {
+		uint64_t dataend = DataOffset + header().datasize;
+		if (offset < DataOffset || offset > dataend || dataend - offset < sizeof(uint64_t))
+			return false;
+		uint64_t blockcount = ReadValue<uint64_t>(_base + offset);
+		if (blockcount != GetBlockCount(size))
+			return false;
+		uint64_t available = dataend - offset - sizeof(uint64_t);
+		if (blockcount > available / sizeof(uint32_t))
+			return false;
+		available -= blockcount * sizeof(uint32_t);
+		for (uint64_t i = 0; i != blockcount; ++i) {
+			uint64_t blocksize = ReadValue<uint32_t>(_base + offset + sizeof(uint64_t) + i * sizeof(uint32_t));
+			if (blocksize == 0 || blocksize > available || blocksize > Compress::CompressBound(static_cast<size_t>(GetBlockRawSize(size, i))))
+				return false;
+			available -= blocksize;
+		}
+		return true;
+	}
+
+	bool LiteralDataPool::save(const std::string &filename, bool compress) const {
+		if (_base == nullptr)
+			return false;
+		std::FILE *fp = std::fopen(filename.c_str(), "wb");
+		if (fp == nullptr)
+			return false;
+		bool result;
+		if (compress) {
+			result = saveCompressed(fp);
+		}
+		else {
+			size_t size = static_cast<size_t>(header().totalsize);
+			result = std::fwrite(_base, 1, size, fp) == size;
+		}
+		return std::fclose(fp) == 0 && result;
+	}
+
+	static void AppendRecord(std::vector<uint8_t> &image, const uint8_t *data, uint64_t size) {
+		uint64_t blockcount = GetBlockCount(size);
+		AppendValue(image, blockcount);
+		size_t tableoffset = image.size();
+		image.resize(tableoffset + static_cast<size_t>(blockcount) * sizeof(uint32_t));
+		std::vector<uint8_t> buffer(Compress::CompressBound(static_cast<size_t>(LiteralDataPool::CompressBlockSize)));
+		for (uint64_t i = 0; i != blockcount; ++i) {
+			const uint8_t *src = data + i * LiteralDataPool::CompressBlockSize;
+			size_t rawsize = static_cast<size_t>(GetBlockRawSize(size, i));
+			size_t blocksize = Compress::CompressBlock(src, rawsize, buffer.data());
+			if (blocksize >= rawsize) {
+				image.insert(image.end(), src, src + rawsize);
+				blocksize = rawsize;
+			}
+			else {
+				image.insert(image.end(), buffer.data(), buffer.data() + blocksize);
+			}
+			uint32_t value = static_cast<uint32_t>(blocksize);
+			std::memcpy(image.data() + tableoffset + i * sizeof(uint32_t), &value, sizeof(value));
+		}
+	}
+
+	// Rebuild the section with the data compressed, the entries of the same data still share one record.
+	bool LiteralDataPool::saveCompressed(std::FILE *fp) const {
+		const SectionHeader &h = header();
+		std::vector<uint8_t> image(DataOffset);
+		std::vector<std::vector<SectionEntry>> files(static_cast<size_t>(h.filecount));
+		std::map<std::pair<uint64_t, uint64_t>, uint64_t> moved;
+
+		for (uint64_t f = 0; f != h.filecount; ++f) {
+			FileID fileid(static_cast<FileID::Type>(f));
+			const SectionFile &file = getFile(fileid);
+			for (uint64_t d = 1; d <= file.entrycount; ++d) {
+				DataID dataid(static_cast<DataID::Type>(d));
+				SectionEntry entry = getEntry(fileid, dataid);
+				if (entry.offset != 0 && !(entry.offset & BlobFlag)) {
+					auto key = std::make_pair(entry.offset, entry.size);
+					auto iter = moved.find(key);
+					if (iter != moved.end()) {
+						entry.offset = iter->second;
+					}
+					else {
+						if (!has(fileid, dataid))
+							return false;
+						const uint8_t *data = at(fileid, dataid).first;
+						if (entry.size >= CompressMinSize) {
+							entry.offset = image.size() | CompressedFlag;
+							AppendRecord(image, data, entry.size);
+						}
+						else {
+							entry.offset = image.size();
+							image.insert(image.end(), data, data + entry.size);
+						}
+						moved.emplace(key, entry.offset);
+					}
+				}
+				files[static_cast<size_t>(f)].push_back(entry);
+			}
+		}
+
+		SectionHeader newheader = h;
+		newheader.datasize = image.size() - DataOffset;
+		image.resize((image.size() + alignof(uint64_t) - 1) / alignof(uint64_t) * alignof(uint64_t));
+
+		newheader.fileoffset = image.size();
+		uint64_t entryoffset = newheader.fileoffset + h.filecount * sizeof(SectionFile);
+		for (auto &entries : files) {
+			AppendValue(image, SectionFile { entryoffset, entries.size() });
+			entryoffset += entries.size() * sizeof(SectionEntry);
+		}
+		for (auto &entries : files)
+			for (auto &entry : entries)
+				AppendValue(image, entry);
+
+		const SectionBlob *blobs = reinterpret_cast<const SectionBlob*>(_base + h.bloboffset);
+		newheader.bloboffset = image.size();
+		uint64_t pathoffset = newheader.bloboffset + h.blobcount * sizeof(SectionBlob);
+		for (uint64_t i = 0; i != h.blobcount; ++i) {
+			AppendValue(image, SectionBlob { pathoffset, blobs[i].pathsize, blobs[i].size });
+			pathoffset += blobs[i].pathsize;
+		}
+		for (uint64_t i = 0; i != h.blobcount; ++i) {
+			const uint8_t *path = _base + blobs[i].pathoffset;
+			image.insert(image.end(), path, path + blobs[i].pathsize);
+		}
+
+		newheader.totalsize = image.size();
+		std::memcpy(image.data(), &newheader, sizeof(newheader));
+		return std::fwrite(image.data(), 1, image.size(), fp) == image.size();
+	}
+
+	bool LiteralDataPool::load(const std::string &filename, bool strictblob) {
+		_lazys.clear();
+		if (!_file.open(filename.c_str()))
+			return false;
+		if (!bind(_file.data(), _file.size()) || !mapBlobs(strictblob)) {
+			_base = nullptr;
+			_blobs.clear();
+			_file.close();
+			return false;
+		}
+		return true;
+	}
+
+	bool LiteralDataPool::isMapped(const void *address) const {
+		if (_file.contains(address))
+			return true;
+		for (auto &blob : _blobs)
+			if (blob->contains(address))
+				return true;
+		return false;
+	}
+
+#if defined(__unix__) || defined(__APPLE__)
+	static const LiteralDataPool *_guardedpool = nullptr;
+
+	static void MappedStoreHandler(int sig, siginfo_t *info, void *context) {
+		if (_guardedpool && _guardedpool->isMapped(info->si_addr)) {
+			static const char message[] = "Error in store to read-only literal data.\n";
+			std::fflush(stdout);
+			ssize_t result = ::write(STDOUT_FILENO, message, sizeof(message) - 1);
+			(void)result;
+			_exit(-1);
+		}
+		// Not a store to the literal data, crash by the default action when the instruction is retried.
+		std::signal(sig, SIG_DFL);
+	}
+
+	void LiteralDataPool::guardMapped() const {
+		_guardedpool = this;
+		struct sigaction action;
+		std::memset(&action, 0, sizeof(action));
+		action.sa_sigaction = MappedStoreHandler;
+		action.sa_flags = SA_SIGINFO;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGSEGV, &action, nullptr);
+		sigaction(SIGBUS, &action, nullptr);
+	}
+#else
+	void LiteralDataPool::guardMapped() const {}
+#endif
+
+	bool LiteralDataPool::mapBlobs(bool strictblob) {
+		const SectionHeader &h = header();
+		const SectionBlob *blobs = reinterpret_cast<const SectionBlob*>(_base + h.bloboffset);
+		_blobs.clear();
+		for (uint64_t i = 0; i != h.blobcount; ++i) {
+			std::string path(reinterpret_cast<const char*>(_base + blobs[i].pathoffset), static_cast<size_t>(blobs[i].pathsize));
+			std::unique_ptr<PageProvider::MappedFile> file(new PageProvider::MappedFile());
+			if (!file->open(path.c_str()) || file->size() != blobs[i].size)
+				return false;
+			if (strictblob && !file->isPageAlignedReadOnly())
+				return false;
+			_blobs.push_back(std::move(file));
+		}
+		return true;
+	}
+
+	// Check the header and the tables, the entries are checked by 'has'.
+	bool LiteralDataPool::bind(const uint8_t *base, size_t size) {
+		if (base == nullptr || size < DataOffset)
+			return false;
+		const SectionHeader &h = *reinterpret_cast<const SectionHeader*>(base);
+		if (std::memcmp(h.magic, Magic, sizeof(Magic)) != 0 || h.version != Version || h.byteorder != ByteOrder)
+			return false;
+		if (h.totalsize > size || h.datasize > h.totalsize - DataOffset)
+			return false;
+		if (h.fileoffset % alignof(SectionFile) != 0 || h.fileoffset > h.totalsize
+			|| h.filecount > (h.totalsize - h.fileoffset) / sizeof(SectionFile))
+			return false;
+		const SectionFile *files = reinterpret_cast<const SectionFile*>(base + h.fileoffset);
+		for (uint64_t i = 0; i != h.filecount; ++i) {
+			const SectionFile &file = files[i];
+			if (file.entryoffset % alignof(SectionEntry) != 0 || file.entryoffset > h.totalsize
+				|| file.entrycount > (h.totalsize - file.entryoffset) / sizeof(SectionEntry))
+				return false;
+		}
+		if (h.bloboffset % alignof(SectionBlob) != 0 || h.bloboffset > h.totalsize
+			|| h.blobcount > (h.totalsize - h.bloboffset) / sizeof(SectionBlob))
+			return false;
+		const SectionBlob *blobs = reinterpret_cast<const SectionBlob*>(base + h.bloboffset);
+		for (uint64_t i = 0; i != h.blobcount; ++i) {
+			if (blobs[i].pathoffset > h.totalsize || blobs[i].pathsize > h.totalsize - blobs[i].pathoffset)
+				return false;
+		}
+		_base = base;
+		return true;
+	}
+}
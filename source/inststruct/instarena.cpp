@@ -0,0 +1,51 @@
+#include "basic.h"
+#include "inststruct/instarena.h"
+#include <cstring>
+#include <new>
+
+namespace CVM::InstStruct
+{
+	Instruction* InstArena::newInstruction(InstCode instcode, const std::vector<Element> &data) {
+		Element *elts = nullptr;
+		if (!data.empty()) {
+			elts = static_cast<Element*>(_arena.alloc(sizeof(Element) * data.size(), alignof(Element)));
+			std::memcpy(static_cast<void*>(elts), data.data(), sizeof(Element) * data.size());
+		}
+		void *inst = _arena.alloc(sizeof(Instruction), alignof(Instruction));
+		return new (inst) Instruction(instcode, ElementList(elts, data.size()));
+	}
+
+	String::Type InstArena::internString(std::string_view str) {
+		return intern(str.data(), str.size());
+	}
+
+	ArrayData::Type InstArena::internArray(const std::vector<uint8_t> &data) {
+		std::string_view blob = intern(data.data(), data.size());
+		return ArrayData::Type(reinterpret_cast<const uint8_t*>(blob.data()), blob.size());
+	}
+
+	const BigInteger* InstArena::newBigInteger(BigInteger &&data) {
+		_bigintegers.push_back(std::move(data));
+		return &_bigintegers.back();
+	}
+
+	void InstArena::clear() {
+		_blobset.clear();
+		_bigintegers.clear();
+		_arena.clear();
+	}
+
+	std::string_view InstArena::intern(const void *data, size_t size) {
+		if (size == 0)
+			return std::string_view();
+		std::string_view key(static_cast<const char*>(data), size);
+		auto iter = _blobset.find(key);
+		if (iter != _blobset.end())
+			return *iter;
+		char *blob = static_cast<char*>(_arena.alloc(size, 1));
+		std::memcpy(blob, data, size);
+		std::string_view result(blob, size);
+		_blobset.insert(result);
+		return result;
+	}
+}
@@ -0,0 +1,92 @@
+#include "basic.h"
+#include "inststruct/instpart.h"
+#include <algorithm>
+
+namespace CVM::InstStruct
+{
+	//---------------------------------------------------------------------------------------------
+	// * IntegerData
+	//    The inline integer behaves the same as BigInteger,
+	//    except that the negative number is written as two's complement.
+	//---------------------------------------------------------------------------------------------
+	static size_t GetDigitCount(uint64_t magnitude, unsigned int base) {
+		size_t count = 1;
+		while (magnitude >= base) {
+			magnitude /= base;
+			++count;
+		}
+		return count;
+	}
+
+	static std::string ToStringMagnitude(uint64_t magnitude, int base) {
+		static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+		if (base <= 1 || base > 36)
+			return "";
+		std::string result;
+		do {
+			result.push_back(digits[magnitude % base]);
+			magnitude /= base;
+		} while (magnitude != 0);
+		std::reverse(result.begin(), result.end());
+		return result;
+	}
+
+	static bool IsLSBSystem() {
+		const uint16_t v = 0x0001;
+		return *reinterpret_cast<const uint8_t*>(&v) == 1;
+	}
+
+	size_t IntegerData::size() const {
+		if (_large)
+			return _large->size();
+		size_t count = GetDigitCount(_magnitude, 16) + (_negative ? 1 : 0);
+		return count / 2 + count % 2;
+	}
+
+	std::string IntegerData::toString(int base) const {
+		if (_large)
+			return _large->toString(base);
+		std::string result = ToStringMagnitude(_magnitude, base);
+		if (_negative && !result.empty())
+			result.insert(result.begin(), '-');
+		return result;
+	}
+
+	std::string IntegerData::toStringUnsigned(int base) const {
+		if (_large)
+			return _large->toStringUnsigned(base);
+		return ToStringMagnitude(_magnitude, base);
+	}
+
+	bool IntegerData::toBuffer(void *buffer, size_t memsize) const {
+		if (_large)
+			return _large->toBuffer(buffer, memsize);
+		if (!toBufferLSB(buffer, memsize))
+			return false;
+		if (!IsLSBSystem()) {
+			uint8_t *p = static_cast<uint8_t*>(buffer);
+			std::reverse(p, p + memsize);
+		}
+		return true;
+	}
+
+	bool IntegerData::toBufferLSB(void *buffer, size_t memsize) const {
+		bool is_large;
+		return toBufferLSB(buffer, memsize, is_large);
+	}
+
+	bool IntegerData::toBufferLSB(void *buffer, size_t memsize, bool &is_large) const {
+		if (_large)
+			return _large->toBufferLSB(buffer, memsize, is_large);
+		is_large = size() > memsize;
+		if (is_large)
+			return false;
+		uint64_t value = _negative ? (~_magnitude + 1) : _magnitude;
+		uint8_t fill = _negative ? 0xff : 0x00;
+		uint8_t *p = static_cast<uint8_t*>(buffer);
+		for (size_t i = 0; i != memsize; ++i) {
+			p[i] = i < sizeof(value) ? static_cast<uint8_t>(value >> (i * 8)) : fill;
+		}
+		return true;
+	}
+}
@@ -1,6 +1,7 @@
 #include "basic.h"
 #include "inststruct/instpart.h"
 #include <cctype>
+#include <cstdio>
 
 #include "parser/parse.h"
 
@@ -211,7 +212,20 @@ namespace CVM::InstStruct
 			result.push_back('-');
 		}
 		result += "0x";
-		result += data.data().toStringUnsigned(16);
+		result += data.toStringUnsigned(16);
+		return result;
+	}
+
+	//---------------------------------------------------------------------------------------------
+	// * FloatData
+	//---------------------------------------------------------------------------------------------
+	template <>
+	std::string ToString<FloatData>(const FloatData &data, GlobalInfo &ginfo) {
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%.17g", data.data());
+		std::string result(buffer);
+		if (result.find_first_of(".en") == std::string::npos)
+			result += ".0";
 		return result;
 	}
 
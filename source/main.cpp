@@ -6,6 +6,13 @@
 #include "runtime/environment.h"
 #include "runtime/datapointer.h"
 #include "runtime/datamanage.h"
+#include "runtime/collector.h"
+#include "runtime/heapprofile.h"
+#include "pageprovider.h"
+#include "runtime/vectorkernel.h"
+#include "runtime/bigint.h"
+#include "runtime/stringvalue.h"
+#include "runtime/textkernel.h"
 
 int add_int(int x, int y) {
 	return x + y;
@@ -41,10 +48,15 @@ namespace CVM
 	}
 
 	void VirtualMachine::Launch() {
+		bool heapprofile = Runtime::HeapProfile::IsEnabled();
 		while (this->_currenv) {
 			auto &env = *this->_currenv;
 			auto &cflow = env.Controlflow();
 			cflow.init();
+			if (heapprofile) {
+				Runtime::HeapProfile::CheckSignal();
+				Runtime::HeapProfile::SetSite(env._func.id(), cflow.getProgramCounter());
+			}
 			cflow.callCurrInst(env);
 			cflow.incProgramCounter();
 
@@ -52,6 +64,10 @@ namespace CVM
 				if (env.PEnv().isLocal()) {
 					auto *oldenv = this->_currenv;
 					this->_currenv = &static_cast<Runtime::LocalEnvironment&>(env.PEnv());
+					if (heapprofile)
+						Runtime::HeapProfile::RecordFree(oldenv);
+					Runtime::DataManage::FreeFrame(oldenv->getDataRegisterSet().staddress());
+					Runtime::VMStack::Leave(oldenv->callerStackBase());
 					this->_currenv->removeSubEnvironment(oldenv);
 				}
 				else {
@@ -60,6 +76,25 @@ namespace CVM
 				}
 			}
 		}
+		if (heapprofile)
+			Runtime::HeapProfile::ClearSite();
+	}
+
+	// The dynamic registers refer to the memory out of the frames.
+	static void MarkDynamicRegisters(Runtime::Environment &env) {
+		auto &drs = env.getDataRegisterSet();
+		for (Config::RegisterIndexType i = 0; i != drs.dysize(); ++i) {
+			const auto &reg = drs.get_dynamic(i + 1);
+			if (reg.data.get())
+				Runtime::Collector::MarkRange(reg.data.get(), reg.data.get<uint8_t>() + env.getType(reg.type).size.data);
+		}
+	}
+
+	void VirtualMachine::MarkRoots() {
+		MarkDynamicRegisters(*this->_genv);
+		MarkDynamicRegisters(*this->_tenv);
+		for (Runtime::Environment *env = this->_currenv; env && env->isLocal(); env = &env->PEnv())
+			MarkDynamicRegisters(*env);
 	}
 }
 
@@ -107,6 +142,17 @@ void _int64_add(CVM::Runtime::PointerFunction::Result &result, CVM::Runtime::Poi
 	*result.get<int64_t>() = x + y;
 }
 
+void _print_bigint(CVM::Runtime::PointerFunction::Result &result, CVM::Runtime::PointerFunction::ArgumentList &arglist)
+{
+	println(CVM::Runtime::BigInt::ToString(*arglist[0].get<CVM::Runtime::BigInt::BigIntValue>()));
+}
+
+void _print_str(CVM::Runtime::PointerFunction::Result &result, CVM::Runtime::PointerFunction::ArgumentList &arglist)
+{
+	const auto &str = *arglist[0].get<CVM::Runtime::String::StringValue>();
+	std::fwrite(CVM::Runtime::String::GetData(str), 1, CVM::Runtime::String::GetLength(str), stdout);
+}
+
 void _system(CVM::Runtime::PointerFunction::Result &result, CVM::Runtime::PointerFunction::ArgumentList &arglist)
 {
 	std::system(*arglist[0].get<const char*>());
@@ -114,12 +160,128 @@ void _system(CVM::Runtime::PointerFunction::Result &result, CVM::Runtime::Pointe
 
 #include "runtime/function.h"
 
+using CVM::Runtime::String::StringValue;
+
+template <typename T>
+static void setIntrinsicResult(CVM::Runtime::DataPointer result, const T &value)
+{
+	if (result.get())
+		std::memcpy(result.get(), &value, sizeof(T));
+}
+
+static int64_t toIndexResult(size_t pos)
+{
+	return pos == CVM::Runtime::TextKernel::NotFound ? -1 : static_cast<int64_t>(pos);
+}
+
+// (cms#string str, cms#uint8 byte) -> cms#int64, the index or -1
+void _text_find_byte(CVM::Runtime::DataPointer result, const CVM::Runtime::DataPointer *args)
+{
+	const auto &str = *args[0].get<StringValue>();
+	char byte = *args[1].get<char>();
+	setIntrinsicResult(result, toIndexResult(CVM::Runtime::TextKernel::FindByte(CVM::Runtime::String::GetData(str), CVM::Runtime::String::GetLength(str), byte)));
+}
+
+// (cms#string str, cms#string needle) -> cms#int64, the index or -1
+void _text_find(CVM::Runtime::DataPointer result, const CVM::Runtime::DataPointer *args)
+{
+	const auto &str = *args[0].get<StringValue>();
+	const auto &needle = *args[1].get<StringValue>();
+	size_t pos = CVM::Runtime::TextKernel::Find(CVM::Runtime::String::GetData(str), CVM::Runtime::String::GetLength(str),
+		CVM::Runtime::String::GetData(needle), CVM::Runtime::String::GetLength(needle));
+	setIntrinsicResult(result, toIndexResult(pos));
+}
+
+// (cms#string str, cms#uint8 byte) -> cms#int64
+void _text_count_byte(CVM::Runtime::DataPointer result, const CVM::Runtime::DataPointer *args)
+{
+	const auto &str = *args[0].get<StringValue>();
+	char byte = *args[1].get<char>();
+	size_t count = CVM::Runtime::TextKernel::CountByte(CVM::Runtime::String::GetData(str), CVM::Runtime::String::GetLength(str), byte);
+	setIntrinsicResult(result, static_cast<int64_t>(count));
+}
+
+// (cms#string str) -> cms#int64, the last line may have no '\n'
+void _text_count_lines(CVM::Runtime::DataPointer result, const CVM::Runtime::DataPointer *args)
+{
+	const auto &str = *args[0].get<StringValue>();
+	const char *data = CVM::Runtime::String::GetData(str);
+	size_t size = CVM::Runtime::String::GetLength(str);
+	size_t count = CVM::Runtime::TextKernel::CountByte(data, size, '\n');
+	if (size != 0 && data[size - 1] != '\n')
+		++count;
+	setIntrinsicResult(result, static_cast<int64_t>(count));
+}
+
+// (cms#string str, cms#uint8 delim, cms#slice fields) -> cms#int64, the count of the fields
+// The fields (substrings of str) are written to the slice of cms#string, as many as it holds.
+void _text_split(CVM::Runtime::DataPointer result, const CVM::Runtime::DataPointer *args)
+{
+	using namespace CVM::Runtime;
+	const auto &str = *args[0].get<StringValue>();
+	char delim = *args[1].get<char>();
+	Slice::SliceValue fields = *args[2].get<Slice::SliceValue>();
+	if (fields.elemtype != CVM::T_String)
+		Slice::ElementTypeMismatch(fields.elemtype, CVM::T_String);
+
+	const char *data = String::GetData(str);
+	size_t size = String::GetLength(str);
+	size_t count = 0;
+	for (size_t begin = 0;; ++count) {
+		size_t pos = TextKernel::FindByte(data + begin, size - begin, delim);
+		size_t end = pos == TextKernel::NotFound ? size : begin + pos;
+		if (count < fields.length) {
+			StringValue field = String::Make(data + begin, end - begin);
+			std::memcpy(fields.data + count * String::ValueSize, &field, String::ValueSize);
+		}
+		if (pos == TextKernel::NotFound)
+			break;
+		begin = end + 1;
+	}
+	setIntrinsicResult(result, static_cast<int64_t>(count + 1));
+}
+
+// (cms#string str) -> cms#string
+template <void (*_fold)(char *, const char *, size_t)>
+void _text_fold_case(CVM::Runtime::DataPointer result, const CVM::Runtime::DataPointer *args)
+{
+	using namespace CVM::Runtime;
+	const auto &src = *args[0].get<StringValue>();
+	size_t length = String::GetLength(src);
+	StringValue dst = src;
+	char *data = dst.bytes;
+	if (!String::IsShort(src)) {
+		data = static_cast<char*>(Collector::Alloc(length));
+		dst = String::Make(data, length);
+	}
+	_fold(data, String::GetData(src), length);
+	setIntrinsicResult(result, dst);
+}
+
+static const CVM::Runtime::IntrinsicMap& getInsideIntrinsicMap(CVM::HashStringPool &hashStringPool)
+{
+	using namespace CVM;
+	static const Runtime::IntrinsicMap ifm {
+		{ hashStringPool.insert("text#find_byte"), { _text_find_byte, T_Int64, 2, { T_String, T_UInt8 } } },
+		{ hashStringPool.insert("text#find"), { _text_find, T_Int64, 2, { T_String, T_String } } },
+		{ hashStringPool.insert("text#count_byte"), { _text_count_byte, T_Int64, 2, { T_String, T_UInt8 } } },
+		{ hashStringPool.insert("text#count_lines"), { _text_count_lines, T_Int64, 1, { T_String } } },
+		{ hashStringPool.insert("text#split"), { _text_split, T_Int64, 3, { T_String, T_UInt8, T_Slice }, 1 << 2 } },
+		{ hashStringPool.insert("text#lower"), { _text_fold_case<Runtime::TextKernel::ToLower>, T_String, 1, { T_String } } },
+		{ hashStringPool.insert("text#upper"), { _text_fold_case<Runtime::TextKernel::ToUpper>, T_String, 1, { T_String } } },
+	};
+
+	return ifm;
+}
+
 static const CVM::Runtime::PtrFuncMap& getInsidePtrFuncMap(CVM::HashStringPool &hashStringPool)
 {
 	static const CVM::Runtime::PtrFuncMap pfm {
 		{ hashStringPool.insert("print_string"), _print_string },
 		{ hashStringPool.insert("print_int64"), _print_int64 },
 		{ hashStringPool.insert("print_int64x"), _print_int64x },
+		{ hashStringPool.insert("print_bigint"), _print_bigint },
+		{ hashStringPool.insert("print_str"), _print_str },
 		{ hashStringPool.insert("cms#int64#+"), _int64_add },
 		{ hashStringPool.insert("system"), _system }
 	};
@@ -136,11 +298,20 @@ void pause() {
 
 #include "inststruct/hashstringpool.h"
 
-CVM::Runtime::LocalEnvironment * createVM(PriLib::TextFile &cmsfile, CVM::VirtualMachine &VM)
+struct DataOptions
+{
+	const char *savedatafile = nullptr;
+	const char *loaddatafile = nullptr;
+	bool strictblob = false;
+	bool compressdata = false;
+};
+
+CVM::Runtime::LocalEnvironment * createVM(PriLib::TextFile &cmsfile, CVM::VirtualMachine &VM, const DataOptions &options)
 {
 	// Init GlobalInfo
 
 	CVM::InstStruct::GlobalInfo *globalinfo = new CVM::InstStruct::GlobalInfo();
+	globalinfo->strictBlob = options.strictblob;
 
 	// Parse File
 
@@ -162,26 +333,48 @@ CVM::Runtime::LocalEnvironment * createVM(PriLib::TextFile &cmsfile, CVM::Virtua
 
 		// Create LiteralDataPool
 		LiteralDataPoolCreator &creator = *globalinfo->literalDataPoolCreator;
-		creator.mergeTo(FileID(0), globalinfo->literalDataPool);
-		globalinfo->literalDataPoolCreator.release();
-		println(globalinfo->literalDataPool.toString());
+		if (options.loaddatafile) {
+			if (!creator.empty()) {
+				println("Literal data is defined both in the program and in '", options.loaddatafile, "'.");
+				exit(-1);
+			}
+			if (!globalinfo->literalDataPool.load(options.loaddatafile, options.strictblob)) {
+				println("Error in load literal data section '", options.loaddatafile, "'.");
+				exit(-1);
+			}
+		}
+		else {
+			creator.mergeTo(FileID(0), globalinfo->literalDataPool);
+		}
+		globalinfo->literalDataPoolCreator.reset();
+		globalinfo->literalDataPool.guardMapped();
+
+		if (options.savedatafile && !globalinfo->literalDataPool.save(options.savedatafile, options.compressdata)) {
+			println("Error in save literal data section '", options.savedatafile, "'.");
+			exit(-1);
+		}
 
 		// Create FuncTable
 		functable = new Runtime::FuncTable();
 
 		// Compile
-		if (!compiler.compile(getGlobalInfo(parseinfo), getInsidePtrFuncMap(globalinfo->hashStringPool), *functable)) {
+		if (!compiler.compile(getGlobalInfo(parseinfo), getInsidePtrFuncMap(globalinfo->hashStringPool), getInsideIntrinsicMap(globalinfo->hashStringPool), *functable)) {
 			println("Compiled Error.");
 			exit(-1);
 		}
+
+		// Release InstStruct
+		releaseInstStruct(parseinfo);
 	}
 
-	VM.addGlobalEnvironment(Compile::CreateGlobalEnvironment(0xff, &globalinfo->typeInfoMap, &globalinfo->literalDataPool, functable, &globalinfo->hashStringPool));
+	VM.addGlobalEnvironment(Compile::CreateGlobalEnvironment(0xff, globalinfo->globalTypeList, &globalinfo->typeInfoMap, &globalinfo->literalDataPool, functable, &globalinfo->hashStringPool));
+	VM.addThreadEnvironment(Compile::CreateThreadEnvironment(globalinfo->threadTypeList, globalinfo->typeInfoMap));
 
 	Config::FuncIndexType entry_id = compiler.getEntryID();
 	Runtime::InstFunction &entry_func = static_cast<Runtime::InstFunction&>(*functable->at(entry_id));
 	Runtime::LocalEnvironment *lenv = Compile::CreateLoaclEnvironment(entry_func, globalinfo->typeInfoMap);
 
+	lenv->SetTEnv(&VM.Tenv());
 	VM.Genv().addSubEnvironment(lenv);
 	pause();
 
@@ -193,7 +386,69 @@ CVM::Runtime::LocalEnvironment * createVM(PriLib::TextFile &cmsfile, CVM::Virtua
 
 int main(int argc, char *argv[])
 {
-	if (argc != 2) {
+	// Parse Arguments
+
+	const char* filename = nullptr;
+	DataOptions dataoptions;
+	bool stats = false;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--stats") {
+			stats = true;
+		}
+		else if (arg.compare(0, 13, "--huge-pages=") == 0) {
+			CVM::PageProvider::PageMode mode;
+			if (!CVM::PageProvider::ParseMode(arg.c_str() + 13, mode)) {
+				println("Unknown huge page mode '", arg.substr(13), "'.");
+				return 0;
+			}
+			CVM::PageProvider::SetMode(mode);
+		}
+		else if (arg.compare(0, 7, "--simd=") == 0) {
+			CVM::Runtime::VectorKernel::VectorLevel level;
+			if (!CVM::Runtime::VectorKernel::ParseLevel(arg.c_str() + 7, level)) {
+				println("Unknown simd level '", arg.substr(7), "'.");
+				return 0;
+			}
+			CVM::Runtime::VectorKernel::SetLevel(level);
+		}
+		else if (arg.compare(0, 13, "--stack-size=") == 0) {
+			uint64_t size = 0;
+			if (!PriLib::Convert::to_integer<uint64_t>(arg.substr(13), size) || size == 0 || size > SIZE_MAX / 1024) {
+				println("Illegal stack size '", arg.substr(13), "'.");
+				return 0;
+			}
+			CVM::Runtime::VMStack::SetSize(static_cast<size_t>(size) * 1024);
+		}
+		else if (arg.compare(0, 12, "--save-data=") == 0) {
+			dataoptions.savedatafile = argv[i] + 12;
+		}
+		else if (arg.compare(0, 12, "--load-data=") == 0) {
+			dataoptions.loaddatafile = argv[i] + 12;
+		}
+		else if (arg == "--strict-blob") {
+			dataoptions.strictblob = true;
+		}
+		else if (arg == "--compress-data") {
+			dataoptions.compressdata = true;
+		}
+		else if (arg == "--heap-profile") {
+			CVM::Runtime::HeapProfile::Enable("cvm.heap");
+		}
+		else if (arg.compare(0, 15, "--heap-profile=") == 0) {
+			CVM::Runtime::HeapProfile::Enable(arg.substr(15));
+		}
+		else if (filename == nullptr) {
+			filename = argv[i];
+		}
+		else {
+			println("Unknown argument '", arg, "'.");
+			return 0;
+		}
+	}
+
+	if (filename == nullptr) {
 		println("No file to open.");
 		return 0;
 	}
@@ -202,24 +457,32 @@ int main(int argc, char *argv[])
 
 	PriLib::TextFile cmsfile;
 
-	const char* filename = argv[1];
-
 	cmsfile.open(filename, PriLib::File::Read);
 
 	if (cmsfile.bad()) {
 		putError((std::string("Error in open file '") + filename + "'.").c_str());
 	}
 
+	if (stats) {
+		CVM::PageProvider::BeginStats();
+	}
+
 	// Run 'main'
 
 	CVM::VirtualMachine VM;
 
-	CVM::Runtime::LocalEnvironment *lenv = createVM(cmsfile, VM);
+	CVM::Runtime::LocalEnvironment *lenv = createVM(cmsfile, VM, dataoptions);
 
 	VM.Call(lenv);
 
+	CVM::Runtime::Collector::Enable([&VM]() { VM.MarkRoots(); });
+
 	VM.Launch();
 
+	if (stats) {
+		CVM::PageProvider::PrintStats();
+	}
+
 	pause();
 
 	return 0;
@@ -0,0 +1,290 @@
+#include "basic.h"
+#include "pageprovider.h"
+#include <cstring>
+#include <cstdio>
+#include <atomic>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define CVM_PAGEPROVIDER_MMAP
+#endif
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#define CVM_PAGEPROVIDER_PERF
+#endif
+
+namespace CVM
+{
+	namespace PageProvider
+	{
+		static PageMode _mode = pm_normal;
+
+		struct PageStats
+		{
+			std::atomic<size_t> normal_bytes { 0 };
+			std::atomic<size_t> madvise_bytes { 0 };
+			std::atomic<size_t> hugetlb_bytes { 0 };
+			std::atomic<size_t> fallback_count { 0 };
+		};
+
+		static PageStats& GetStats() {
+			static PageStats stats;
+			return stats;
+		}
+
+		void SetMode(PageMode mode) {
+			_mode = mode;
+		}
+
+		PageMode GetMode() {
+			return _mode;
+		}
+
+		bool ParseMode(const char *str, PageMode &mode) {
+			if (std::strcmp(str, "off") == 0)
+				mode = pm_normal;
+			else if (std::strcmp(str, "madvise") == 0)
+				mode = pm_madvise;
+			else if (std::strcmp(str, "hugetlb") == 0)
+				mode = pm_hugetlb;
+			else
+				return false;
+			return true;
+		}
+
+		static const char* GetModeName(PageMode mode) {
+			switch (mode) {
+			case pm_normal: return "off";
+			case pm_madvise: return "madvise";
+			case pm_hugetlb: return "hugetlb";
+			default: return "unknown";
+			}
+		}
+
+		static size_t RoundUp(size_t size, size_t unit) {
+			return (size + unit - 1) / unit * unit;
+		}
+
+#if defined(CVM_PAGEPROVIDER_MMAP)
+		size_t GetPageSize() {
+			static size_t pagesize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+			return pagesize;
+		}
+
+		static void* MapPages(size_t size, int extraflags) {
+			void *result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extraflags, -1, 0);
+			return result == MAP_FAILED ? nullptr : result;
+		}
+
+		Pages Allocate(size_t size) {
+			Pages result;
+			if (size == 0)
+				return result;
+			PageStats &stats = GetStats();
+#if defined(MAP_HUGETLB)
+			if (_mode == pm_hugetlb) {
+				size_t hsize = RoundUp(size, HugePageSize);
+				if (void *data = MapPages(hsize, MAP_HUGETLB)) {
+					stats.hugetlb_bytes += hsize;
+					return Pages { data, hsize, pm_hugetlb };
+				}
+				stats.fallback_count += 1;
+			}
+#endif
+			if (_mode == pm_madvise || _mode == pm_hugetlb) {
+				size_t hsize = RoundUp(size, HugePageSize);
+				if (void *data = MapPages(hsize, 0)) {
+#if defined(MADV_HUGEPAGE)
+					if (madvise(data, hsize, MADV_HUGEPAGE) == 0) {
+						stats.madvise_bytes += hsize;
+						return Pages { data, hsize, pm_madvise };
+					}
+#endif
+					stats.fallback_count += 1;
+					stats.normal_bytes += hsize;
+					return Pages { data, hsize, pm_normal };
+				}
+				stats.fallback_count += 1;
+			}
+			size_t nsize = RoundUp(size, GetPageSize());
+			void *data = MapPages(nsize, 0);
+			if (data == nullptr) {
+				std::fprintf(stderr, "Error occur while allocating %zu bytes of pages.\n", nsize);
+				std::exit(1);
+			}
+			stats.normal_bytes += nsize;
+			return Pages { data, nsize, pm_normal };
+		}
+
+		void Release(const Pages &pages) {
+			if (pages.data)
+				munmap(pages.data, pages.size);
+		}
+#else
+		size_t GetPageSize() {
+			return 4096;
+		}
+
+		Pages Allocate(size_t size) {
+			Pages result;
+			if (size == 0)
+				return result;
+			void *data = std::calloc(size, 1);
+			if (data == nullptr) {
+				std::fprintf(stderr, "Error occur while allocating %zu bytes of pages.\n", size);
+				std::exit(1);
+			}
+			if (_mode != pm_normal)
+				GetStats().fallback_count += 1;
+			GetStats().normal_bytes += size;
+			return Pages { data, size, pm_normal };
+		}
+
+		void Release(const Pages &pages) {
+			std::free(pages.data);
+		}
+#endif
+
+		//--------------------------------------
+		// * MappedFile
+		//--------------------------------------
+
+#if defined(CVM_PAGEPROVIDER_MMAP)
+		bool MappedFile::open(const char *filename) {
+			close();
+			int fd = ::open(filename, O_RDONLY);
+			if (fd == -1)
+				return false;
+			struct stat st;
+			if (fstat(fd, &st) != 0) {
+				::close(fd);
+				return false;
+			}
+			size_t size = static_cast<size_t>(st.st_size);
+			if (size != 0) {
+				void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+				if (data == MAP_FAILED) {
+					::close(fd);
+					return false;
+				}
+				_data = data;
+			}
+			_size = size;
+			_writable = (st.st_mode & (S_IWUSR | S_IWGRP | S_IWOTH)) != 0;
+			::close(fd);
+			return true;
+		}
+
+		void MappedFile::close() {
+			if (_data)
+				munmap(_data, _size);
+			_data = nullptr;
+			_size = 0;
+			_writable = true;
+		}
+#else
+		bool MappedFile::open(const char *filename) {
+			close();
+			std::FILE *fp = std::fopen(filename, "rb");
+			if (fp == nullptr)
+				return false;
+			std::fseek(fp, 0, SEEK_END);
+			long size = std::ftell(fp);
+			std::fseek(fp, 0, SEEK_SET);
+			if (size > 0) {
+				_data = std::malloc(static_cast<size_t>(size));
+				if (_data == nullptr || std::fread(_data, 1, static_cast<size_t>(size), fp) != static_cast<size_t>(size)) {
+					std::free(_data);
+					_data = nullptr;
+					std::fclose(fp);
+					return false;
+				}
+			}
+			_size = size > 0 ? static_cast<size_t>(size) : 0;
+			std::fclose(fp);
+			return true;
+		}
+
+		void MappedFile::close() {
+			std::free(_data);
+			_data = nullptr;
+			_size = 0;
+			_writable = true;
+		}
+#endif
+
+		//--------------------------------------
+		// * Stats
+		//--------------------------------------
+
+#if defined(CVM_PAGEPROVIDER_PERF)
+		static int _tlb_counter = -1;
+#endif
+
+		void BeginStats() {
+#if defined(CVM_PAGEPROVIDER_PERF)
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.size = sizeof(attr);
+			attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			_tlb_counter = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+			if (_tlb_counter != -1) {
+				ioctl(_tlb_counter, PERF_EVENT_IOC_RESET, 0);
+				ioctl(_tlb_counter, PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+		}
+
+		// Read 'key: value' from '/proc/self/status' or '/proc/self/smaps_rollup'.
+		static std::string ReadProcValue(const char *filename, const char *key) {
+			std::string result = "unavailable";
+			std::FILE *fp = std::fopen(filename, "r");
+			if (fp == nullptr)
+				return result;
+			char line[256];
+			size_t keylen = std::strlen(key);
+			while (std::fgets(line, sizeof(line), fp)) {
+				if (std::strncmp(line, key, keylen) == 0 && line[keylen] == ':') {
+					const char *p = line + keylen + 1;
+					while (*p == ' ' || *p == '\t')
+						++p;
+					result = p;
+					while (!result.empty() && (result.back() == '\n' || result.back() == ' '))
+						result.pop_back();
+					break;
+				}
+			}
+			std::fclose(fp);
+			return result;
+		}
+
+		void PrintStats() {
+			PageStats &stats = GetStats();
+			println("Page Mode        : ", GetModeName(_mode));
+			println("Pages (hugetlb)  : ", stats.hugetlb_bytes.load(), " bytes");
+			println("Pages (madvise)  : ", stats.madvise_bytes.load(), " bytes");
+			println("Pages (normal)   : ", stats.normal_bytes.load(), " bytes");
+			println("Pages Fallback   : ", stats.fallback_count.load());
+			println("RSS              : ", ReadProcValue("/proc/self/status", "VmRSS"));
+			println("RSS Peak         : ", ReadProcValue("/proc/self/status", "VmHWM"));
+			println("AnonHugePages    : ", ReadProcValue("/proc/self/smaps_rollup", "AnonHugePages"));
+#if defined(CVM_PAGEPROVIDER_PERF)
+			uint64_t count = 0;
+			if (_tlb_counter != -1 && read(_tlb_counter, &count, sizeof(count)) == sizeof(count))
+				println("dTLB Load Misses : ", count);
+			else
+				println("dTLB Load Misses : unavailable");
+#else
+			println("dTLB Load Misses : unavailable");
+#endif
+		}
+	}
+}
@@ -1,7 +1,10 @@
 #include "basic.h"
 #include "parser/parse-inststruct.h"
 #include "parser/parse.h"
+#include "inststruct/instarena.h"
 #include <climits>
+#include <cstdlib>
+#include <cstring>
 
 namespace CVM
 {
@@ -68,6 +71,52 @@ namespace CVM
 			}
 			return false;
 		}
+		// Parse the integer word (in the same way as BigInteger) whose magnitude fits in 64 bits,
+		// return false to fall back to BigInteger.
+		static bool ParseInlineInteger(const std::string &word, uint64_t &magnitude) {
+			const char *pword = word.c_str();
+			if (pword[0] == '+' || pword[0] == '-')
+				++pword;
+			size_t size = std::strlen(pword);
+			unsigned int base = 10;
+			if (pword[0] == '0') {
+				if (size == 1) {
+					magnitude = 0;
+					return true;
+				}
+				else if (size == 2) {
+					pword += 1;
+					base = 8;
+				}
+				else {
+					switch (pword[1]) {
+					case 'b': base = 2; pword += 2; break;
+					case 'o': base = 8; pword += 2; break;
+					case 'd': base = 10; pword += 2; break;
+					case 'x': base = 16; pword += 2; break;
+					default: base = 8; pword += 1; break;
+					}
+				}
+			}
+			if (*pword == '\0')
+				return false;
+			magnitude = 0;
+			for (; *pword; ++pword) {
+				unsigned int digit;
+				if (std::isdigit(*pword))
+					digit = *pword - '0';
+				else if (std::isxdigit(*pword))
+					digit = std::tolower(*pword) - 'a' + 0xa;
+				else
+					return false;
+				if (digit >= base)
+					return false;
+				if (magnitude > (UINT64_MAX - digit) / base)
+					return false;
+				magnitude = magnitude * base + digit;
+			}
+			return true;
+		}
 		static bool ParseString(ParseUnit &parseunit, std::string &result) {
 			const static auto get_escape_char = [](char c) {
 				switch (c) {
@@ -376,7 +425,7 @@ namespace CVM
 		std::optional<String> Parse<String>(ParseUnit &parseunit) {
 			std::string result;
 			if (ParseString(parseunit, result)) {
-				return String(std::move(result));
+				return String(getInstArena(parseunit.parseinfo).internString(result));
 			}
 			return std::nullopt;
 		}
@@ -439,7 +488,7 @@ namespace CVM
 			parseunit.currview = PriLib::CharPtrView(endptr);
 			if (!IsEndChar(parseunit))
 				return std::nullopt;
-			return ArrayData(std::move(data));
+			return ArrayData(getInstArena(parseunit.parseinfo).internArray(data));
 		}
 
 		//---------------------------------------------------------------------------------------------
@@ -477,12 +526,50 @@ namespace CVM
 			parseunit.currview = PriLib::CharPtrView(endptr);
 			if (!IsEndChar(parseunit))
 				return std::nullopt;
+			uint64_t magnitude;
+			if (ParseInlineInteger(word, magnitude)) {
+				return IntegerData(magnitude, word[0] == '-', has_signed_prefix);
+			}
 			BigInteger data;
 			if (has_signed_prefix)
 				data.parse(word);
 			else
 				data.parseu(word);
-			return IntegerData(std::move(data), has_signed_prefix);
+			return IntegerData(getInstArena(parseunit.parseinfo).newBigInteger(std::move(data)), has_signed_prefix);
+		}
+
+		//---------------------------------------------------------------------------------------------
+		// * FloatData
+		//---------------------------------------------------------------------------------------------
+		// The decimal number with '.' is a float, e.g. 1.5, -2.0e-3.
+		static bool IsFloatLiteral(const char *str) {
+			if (*str == '+' || *str == '-')
+				++str;
+			if (str[0] == '0' && (str[1] == 'x' || str[1] == 'd' || str[1] == 'o' || str[1] == 'b'))
+				return false;
+			while (std::isdigit(*str) || *str == '_')
+				++str;
+			return *str == '.';
+		}
+
+		template <>
+		std::optional<FloatData> Parse<FloatData>(ParseUnit &parseunit) {
+			const char *str = parseunit.currview.get();
+			std::string word;
+			const char *endptr = str;
+			while (!isEndChar(parseunit.parseinfo, *endptr)) {
+				if (*endptr != '_')  // Ignore '_' character
+					word.push_back(*endptr);
+				++endptr;
+			}
+			if (word.empty() || word.back() == '.')
+				return std::nullopt;
+			char *parsed = nullptr;
+			double result = std::strtod(word.c_str(), &parsed);
+			if (parsed != word.c_str() + word.size())
+				return std::nullopt;
+			parseunit.currview = PriLib::CharPtrView(endptr);
+			return FloatData(result);
 		}
 
 		//---------------------------------------------------------------------------------------------
@@ -517,6 +604,9 @@ namespace CVM
 				if (parseunit.currview[0] == '0' && parseunit.currview[1] == ':') {
 					return _parseElementBase<ArrayData>(parseunit);
 				}
+				else if (IsFloatLiteral(parseunit.currview.get())) {
+					return _parseElementBase<FloatData>(parseunit);
+				}
 				else {
 					return _parseElementBase<IntegerData>(parseunit);
 				}
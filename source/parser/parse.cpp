@@ -6,6 +6,7 @@
 #include "inststruct/identkeytable.h"
 #include "bignumber.h"
 #include "inststruct/info.h"
+#include "inststruct/instarena.h"
 #include "parser/parse-inststruct.h"
 #include <regex>
 #include <vector>
@@ -88,6 +89,8 @@ namespace CVM
 
 		InstStruct::GlobalInfo &info;
 		LiteralDataPoolCreator &literalDataPoolCreator;
+		InstStruct::InstArena instArena;
+		std::vector<InstStruct::Element> eltbuffer;  // Reused for each line
 		size_t lcount = 0;
 		ParsedIdentifier currtype;
 		int currsection = 0;
@@ -146,6 +149,18 @@ namespace CVM
 		return parseinfo.info;
 	}
 
+	InstStruct::InstArena& getInstArena(ParseInfo &parseinfo) {
+		return parseinfo.instArena;
+	}
+
+	void releaseInstStruct(ParseInfo &parseinfo) {
+		parseinfo.info.funcTable.each([](Config::FuncIndexType, InstStruct::IdentKeyTable::FuncPtr &func) {
+			if (func)
+				func->instdata.clear();
+		});
+		parseinfo.instArena.clear();
+	}
+
 	bool isEndChar(ParseInfo &parseinfo, char c) {
 		return c == '\0' || std::isspace(c) || c == ',';
 	}
@@ -217,11 +232,11 @@ namespace CVM
 			parseinfo.putErrorLine(PEC_NumIsSigned, InstStruct::ToString(elt, parseinfo.info));
 			return 0;
 		}
-		if (integer.data().size() > sizeof(T)) {
+		if (integer.size() > sizeof(T)) {
 			parseinfo.putErrorLine(PEC_NumTooLarge, InstStruct::ToString(elt, parseinfo.info));
 			return 0;
 		}
-		return parseNumber<T>(parseinfo, integer.data().toString(10));  // TODO
+		return parseNumber<T>(parseinfo, integer.toString(10));  // TODO
 	}
 
 	template <typename T>
@@ -260,9 +275,8 @@ namespace CVM
 			parseinfo.putErrorLine(PEC_NumIsSigned, InstStruct::ToString(data, parseinfo.info));
 			return;
 		}
-		const BigInteger &bi = data.data();
 		bool is_large;
-		if (!bi.toBufferLSB(buffer, size, is_large)) {
+		if (!data.toBufferLSB(buffer, size, is_large)) {
 			if (is_large) {
 				parseinfo.putErrorLine(PEC_NumTooLarge, InstStruct::ToString(data, parseinfo.info));
 				parseinfo.putError("The accepted size is " + std::to_string(size) + " byte(s).");
@@ -276,10 +290,9 @@ namespace CVM
 			parseinfo.putErrorLine(PEC_NumIsSigned, InstStruct::ToString(data, parseinfo.info));
 			return false;
 		}
-		const BigInteger &bi = data.data();
-		size_t size = bi.size();
+		size_t size = data.size();
 		uint8_t *buffer = creater(size);
-		if (bi.toBufferLSB(buffer, size)) {
+		if (data.toBufferLSB(buffer, size)) {
 			return true;
 		} else {
 			parseinfo.putErrorLine(PEC_URIntegerData, InstStruct::ToString(data, parseinfo.info));
@@ -435,7 +448,7 @@ namespace CVM
 				success = false;
 			}
 			else {
-				result.emplace_back(std::move(*res));
+				result.push_back(*res);
 			}
 		}
 
@@ -506,6 +519,19 @@ namespace CVM
 		return parseinfo.literalDataPoolCreator.alloc(size);
 	}
 
+	// .gvarb count, type
+	// .tvarb count, type
+	static void parseScopedVarb(ParseInfo &parseinfo, const std::vector<InstStruct::Element> &list, std::vector<TypeIndex> &typelist, const char *name) {
+		if (list.size() == 2) {
+			size_t count = parseNumber<size_t>(parseinfo, list[0]);
+			TypeIndex index = parseType(parseinfo, InstStruct::ToString(list[1], parseinfo.info));
+			typelist.insert(typelist.end(), count, index);
+		}
+		else {
+			parseinfo.putErrorLine(PEC_IllegalFormat, name);
+		}
+	}
+
 	void parseSectionInside(ParseInfo &parseinfo, const std::string &code, const std::vector<std::string> &list) {
 		using ParseInsideProcess = std::function<void(ParseInfo &, const std::vector<InstStruct::Element> &)>;
 		using ParseInsideMap = std::map<std::string, ParseInsideProcess>;
@@ -611,6 +637,18 @@ namespace CVM
 							}
 						}
 					},
+					{
+						"gvarb",
+						[](ParseInfo &parseinfo, const std::vector<InstStruct::Element> &list) {
+							parseScopedVarb(parseinfo, list, parseinfo.info.globalTypeList, "gvarb");
+						}
+					},
+					{
+						"tvarb",
+						[](ParseInfo &parseinfo, const std::vector<InstStruct::Element> &list) {
+							parseScopedVarb(parseinfo, list, parseinfo.info.threadTypeList, "tvarb");
+						}
+					},
 					{
 						"mode",
 						[](ParseInfo &parseinfo, const std::vector<InstStruct::Element> &list) {
@@ -643,13 +681,45 @@ namespace CVM
 							const auto &nameid = parseinfo.currtype;
 							auto &typeinfo = parseinfo.info.typeInfoMap.at(nameid);
 							if (list.size() == 1) {
-								parseNumber(parseinfo, typeinfo.size.data, list[0]);
+								MemorySize size;
+								parseNumber(parseinfo, size.data, list[0]);
+								if (size < typeinfo.size)
+									parseinfo.putErrorLine(PEC_SizeTooSmall, InstStruct::ToString(list[0], parseinfo.info));
+								else
+									typeinfo.size = size;
 							}
 							else {
 								parseinfo.putErrorLine();
 							}
 						}
 					},
+					{
+						"field",
+						[](ParseInfo &parseinfo, const std::vector<InstStruct::Element> &list) {
+							// .field name, offset|auto, type
+							if (list.size() == 3 && list[0].type() == InstStruct::ET_Identifier && list[2].type() == InstStruct::ET_Identifier) {
+								auto &tim = parseinfo.info.typeInfoMap;
+								TypeIndex type = tim.at(parseinfo.currtype).index;
+								TypeIndex fieldtype = parseType(parseinfo, InstStruct::ToString(list[2], parseinfo.info));
+								MemorySize offset;
+								const MemorySize *poffset = nullptr;
+								if (list[1].type() == InstStruct::ET_IntegerData) {
+									parseNumber(parseinfo, offset.data, list[1]);
+									poffset = &offset;
+								}
+								else if (list[1].type() != InstStruct::ET_Identifier || InstStruct::ToString(list[1], parseinfo.info) != "auto") {
+									parseinfo.putErrorLine(PEC_IllegalFormat, "field");
+									return;
+								}
+								const auto &fieldname = getFromElement<InstStruct::Identifier>(list[0]).data();
+								if (!tim.addField(type, fieldname, fieldtype, poffset))
+									parseinfo.putErrorLine(PEC_DUField, InstStruct::ToString(list[0], parseinfo.info));
+							}
+							else {
+								parseinfo.putErrorLine(PEC_IllegalFormat, "field");
+							}
+						}
+					},
 				},
 			},
 			{
@@ -671,13 +741,12 @@ namespace CVM
 										parseDataLarge(parseinfo, dat, buffer, msize);
 									}
 									else {
-										if (!parseDataLarge(parseinfo, dat, [&](size_t size) {
+										parseDataLarge(parseinfo, dat, [&](size_t size) {
 											msize = size;
 											return buffer = createMemory(parseinfo, MemorySize(size));
-										}))
-											delete[] buffer;
+										});
 									}
-									parseinfo.literalDataPoolCreator.insert(DataID(di.data()), std::make_pair(MemorySize(msize), buffer)); // TODO
+									parseinfo.literalDataPoolCreator.insert(DataID(di.data()), MemorySize(msize));
 //									parseinfo.datamap[di.index()] = std::make_pair(buffer, static_cast<uint32_t>(msize));
 								}
 								else {
@@ -699,7 +768,7 @@ namespace CVM
 									auto &vec = data.data();
 									uint8_t *buffer = createMemory(parseinfo, MemorySize(vec.size()));
 									PriLib::Memory::copyTo(buffer, vec.data(), vec.size());
-									parseinfo.literalDataPoolCreator.insert(DataID(di.data()), std::make_pair(MemorySize(static_cast<uint32_t>(vec.size())), buffer)); // TODO
+									parseinfo.literalDataPoolCreator.insert(DataID(di.data()), MemorySize(static_cast<uint32_t>(vec.size())));
 								}
 								else {
 									parseinfo.putErrorLine(PEC_DUDataId);
@@ -718,13 +787,40 @@ namespace CVM
 								const auto &di = getFromElement<InstStruct::DataLabel>(list[0]);
 								if (!parseinfo.literalDataPoolCreator.has(DataID(di.data()))) {
 									const auto &str = getFromElement<InstStruct::String>(list[1]);
-									const std::string &nword = str.data();
+									const auto &nword = str.data();
 									size_t msize = nword.size() + 1;
 									uint8_t *buffer = createMemory(parseinfo, MemorySize(msize));
 									for (size_t i = 0; i < nword.size(); ++i) {
 										buffer[i] = (uint8_t)nword[i];
 									}
-									parseinfo.literalDataPoolCreator.insert(DataID(di.data()), std::make_pair(MemorySize(msize), buffer)); // TODO
+									parseinfo.literalDataPoolCreator.insert(DataID(di.data()), MemorySize(msize));
+								}
+								else {
+									parseinfo.putErrorLine(PEC_DUDataId);
+								}
+							}
+							else {
+								parseinfo.putErrorLine();
+							}
+						}
+					},
+					{
+						"blob",
+						[](ParseInfo &parseinfo, const std::vector<InstStruct::Element> &list) {
+							if (check(list, { InstStruct::ET_DataLabel, InstStruct::ET_String })) {
+								const auto &di = getFromElement<InstStruct::DataLabel>(list[0]);
+								if (!parseinfo.literalDataPoolCreator.has(DataID(di.data()))) {
+									std::string path(getFromElement<InstStruct::String>(list[1]).data());
+									std::unique_ptr<PageProvider::MappedFile> file(new PageProvider::MappedFile());
+									if (!file->open(path.c_str())) {
+										parseinfo.putErrorLine(PEC_URBlobFile, path);
+										return;
+									}
+									if (parseinfo.info.strictBlob && !file->isPageAlignedReadOnly()) {
+										parseinfo.putErrorLine(PEC_BlobNotStrict, path);
+										return;
+									}
+									parseinfo.literalDataPoolCreator.insertBlob(DataID(di.data()), path, std::move(file));
 								}
 								else {
 									parseinfo.putErrorLine(PEC_DUDataId);
@@ -740,7 +836,8 @@ namespace CVM
 		};
 
 		// Convert to InstStruct::Element
-		std::vector<InstStruct::Element> eltlist;
+		auto &eltlist = parseinfo.eltbuffer;
+		eltlist.clear();
 
 		if (!convert(parseinfo, list, eltlist))
 			return;
@@ -772,9 +869,10 @@ namespace CVM
 
 		if (instcodemap.find(code) != instcodemap.end()) {
 			// Convert to InstStruct::Element
-			std::vector<InstStruct::Element> eltlist;
+			auto &eltlist = parseinfo.eltbuffer;
+			eltlist.clear();
 			if (convert(parseinfo, list, eltlist)) {  // Skip fail inst
-				auto inst = new InstStruct::Instruction(instcodemap.at(code), std::move(eltlist));
+				auto inst = parseinfo.instArena.newInstruction(instcodemap.at(code), eltlist);
 				parseinfo.currfunc_creater.get()->instdata.push_back(inst);
 			}
 		}
@@ -0,0 +1,242 @@
+#include "basic.h"
+#include "runtime/bigint.h"
+#include "runtime/collector.h"
+#include <gmpxx.h>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace BigInt
+		{
+			static_assert(sizeof(BigIntValue) == ValueSize, "The size of BigIntValue must be ValueSize.");
+
+			struct LargeData {
+				mp_size_t size;
+				mp_limb_t limbs[1];
+			};
+
+			static_assert(64 % GMP_NUMB_BITS == 0, "The limbs must be able to make up int64.");
+			constexpr size_t Int64LimbCount = 64 / GMP_NUMB_BITS;
+
+			int GetSign(const LargeData &large) {
+				return large.size < 0 ? -1 : 1;
+			}
+
+			[[noreturn]] void DivideByZero() {
+				println("Error in cms#bigint divided by zero.");
+				exit(-1);
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * Operand
+			//    The read-only view of the value as mpz, without allocation.
+			//---------------------------------------------------------------------------------------------
+			class Operand
+			{
+			public:
+				explicit Operand(const BigIntValue &value) {
+					if (value.large) {
+						_ptr = mpz_roinit_n(_view, value.large->limbs, value.large->size);
+					}
+					else {
+						uint64_t magnitude = value.small < 0 ? 0 - static_cast<uint64_t>(value.small) : static_cast<uint64_t>(value.small);
+						mp_size_t count = 0;
+						while (magnitude != 0) {
+							_limbs[count++] = static_cast<mp_limb_t>(magnitude);
+							magnitude = GMP_NUMB_BITS == 64 ? 0 : magnitude >> (GMP_NUMB_BITS % 64);
+						}
+						_ptr = mpz_roinit_n(_view, _limbs, value.small < 0 ? -count : count);
+					}
+				}
+				Operand(const Operand &) = delete;
+				Operand& operator=(const Operand &) = delete;
+
+				mpz_srcptr get() const {
+					return _ptr;
+				}
+
+			private:
+				mp_limb_t _limbs[Int64LimbCount];
+				mpz_t _view;
+				mpz_srcptr _ptr;
+			};
+
+			// The result of the large path is computed here (per thread),
+			// so that GMP allocates only when it grows.
+			static mpz_ptr GetScratch() {
+				static thread_local mpz_class scratch;
+				return scratch.get_mpz_t();
+			}
+
+			static bool GetMagnitude64(mpz_srcptr value, uint64_t &result) {
+				size_t count = mpz_size(value);
+				if (count > Int64LimbCount)
+					return false;
+				result = 0;
+				for (size_t i = 0; i != count; ++i)
+					result |= static_cast<uint64_t>(mpz_getlimbn(value, static_cast<mp_size_t>(i))) << (i * GMP_NUMB_BITS);
+				return true;
+			}
+
+			static size_t GetLargeSize(size_t count) {
+				return sizeof(LargeData) + (count - 1) * sizeof(mp_limb_t);
+			}
+
+			// Store the integer as int64 if possible, otherwise copy the limbs to a new LargeData.
+			static void Store(BigIntValue &dst, mpz_srcptr value) {
+				uint64_t magnitude;
+				if (GetMagnitude64(value, magnitude)) {
+					if (mpz_sgn(value) >= 0 && magnitude <= static_cast<uint64_t>(INT64_MAX)) {
+						dst = BigIntValue { static_cast<int64_t>(magnitude), nullptr };
+						return;
+					}
+					if (mpz_sgn(value) < 0 && magnitude <= static_cast<uint64_t>(INT64_MAX) + 1) {
+						dst = BigIntValue { static_cast<int64_t>(0 - magnitude), nullptr };
+						return;
+					}
+				}
+				size_t count = mpz_size(value);
+				LargeData *large = static_cast<LargeData*>(Collector::Alloc(GetLargeSize(count)));
+				large->size = mpz_sgn(value) < 0 ? -static_cast<mp_size_t>(count) : static_cast<mp_size_t>(count);
+				std::memcpy(large->limbs, mpz_limbs_read(value), count * sizeof(mp_limb_t));
+				dst = BigIntValue { 0, large };
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * Large Path
+			//---------------------------------------------------------------------------------------------
+			void AddLarge(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs) {
+				Operand a(lhs), b(rhs);
+				mpz_ptr result = GetScratch();
+				mpz_add(result, a.get(), b.get());
+				Store(dst, result);
+			}
+
+			void SubLarge(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs) {
+				Operand a(lhs), b(rhs);
+				mpz_ptr result = GetScratch();
+				mpz_sub(result, a.get(), b.get());
+				Store(dst, result);
+			}
+
+			void MulLarge(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs) {
+				Operand a(lhs), b(rhs);
+				mpz_ptr result = GetScratch();
+				mpz_mul(result, a.get(), b.get());
+				Store(dst, result);
+			}
+
+			void DivLarge(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs) {
+				Operand a(lhs), b(rhs);
+				mpz_ptr result = GetScratch();
+				mpz_tdiv_q(result, a.get(), b.get());
+				Store(dst, result);
+			}
+
+			void RemLarge(BigIntValue &dst, const BigIntValue &lhs, const BigIntValue &rhs) {
+				Operand a(lhs), b(rhs);
+				mpz_ptr result = GetScratch();
+				mpz_tdiv_r(result, a.get(), b.get());
+				Store(dst, result);
+			}
+
+			void NegLarge(BigIntValue &dst, const BigIntValue &src) {
+				Operand a(src);
+				mpz_ptr result = GetScratch();
+				mpz_neg(result, a.get());
+				Store(dst, result);
+			}
+
+			int CompareLarge(const BigIntValue &lhs, const BigIntValue &rhs) {
+				Operand a(lhs), b(rhs);
+				int result = mpz_cmp(a.get(), b.get());
+				return result < 0 ? -1 : (result > 0 ? 1 : 0);
+			}
+
+			BigIntValue FromUInt64Large(uint64_t value) {
+				mpz_ptr result = GetScratch();
+				mpz_import(result, 1, -1, sizeof(value), 0, 0, &value);
+				BigIntValue dst;
+				Store(dst, result);
+				return dst;
+			}
+
+			bool ToUInt64Large(const BigIntValue &src, uint64_t &result) {
+				Operand a(src);
+				return mpz_sgn(a.get()) >= 0 && GetMagnitude64(a.get(), result);
+			}
+
+			bool Parse(const std::string &word, int base, BigIntValue &result) {
+				mpz_ptr value = GetScratch();
+				if (mpz_set_str(value, word.c_str(), base) != 0)
+					return false;
+				Store(result, value);
+				return true;
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * IntegerTable
+			//    The interned integers (and their large data), which live as long as the program.
+			//---------------------------------------------------------------------------------------------
+			class IntegerTable
+			{
+			public:
+				// The key is the bytes of int64, or the bytes of LargeData (longer).
+				const BigIntValue& intern(const BigIntValue &value) {
+					std::string key;
+					if (value.large) {
+						size_t count = static_cast<size_t>(value.large->size < 0 ? -value.large->size : value.large->size);
+						key.assign(reinterpret_cast<const char*>(value.large), GetLargeSize(count));
+					}
+					else {
+						key.assign(reinterpret_cast<const char*>(&value.small), sizeof(value.small));
+					}
+					std::lock_guard<std::mutex> lock(_mutex);
+					auto &entry = _table[key];
+					if (!entry) {
+						entry.reset(new Entry());
+						entry->value = value;
+						if (value.large) {
+							entry->data.reset(new mp_limb_t[(key.size() + sizeof(mp_limb_t) - 1) / sizeof(mp_limb_t)]);
+							std::memcpy(entry->data.get(), key.data(), key.size());
+							entry->value.large = reinterpret_cast<const LargeData*>(entry->data.get());
+						}
+					}
+					return entry->value;
+				}
+
+			private:
+				struct Entry
+				{
+					BigIntValue value;
+					std::unique_ptr<mp_limb_t[]> data;
+				};
+
+				std::unordered_map<std::string, std::unique_ptr<Entry>> _table;
+				std::mutex _mutex;
+			};
+
+			static IntegerTable& GetIntegerTable() {
+				static IntegerTable table;
+				return table;
+			}
+
+			const BigIntValue& Intern(const BigIntValue &value) {
+				return GetIntegerTable().intern(value);
+			}
+
+			std::string ToString(const BigIntValue &src, int base) {
+				Operand a(src);
+				std::string result(mpz_sizeinbase(a.get(), base) + 2, '\0');
+				mpz_get_str(&result[0], base, a.get());
+				result.resize(std::strlen(result.c_str()));
+				return result;
+			}
+		}
+	}
+}
@@ -0,0 +1,140 @@
+#include "basic.h"
+#include "runtime/collector.h"
+#include "runtime/datamanage.h"
+#include "runtime/vmstack.h"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace Collector
+		{
+			// Collect when the bytes allocated after the last collection are over both of it
+			// and the live bytes after the last collection.
+			constexpr size_t MinThreshold = 4 * 1024 * 1024;
+
+			struct Object
+			{
+				size_t size;
+				ObjectKind kind;
+				bool marked;
+			};
+
+			struct CollectorData
+			{
+				// Ordered by the address, so that the object of an interior reference is found.
+				std::map<uintptr_t, Object> objects;
+				std::map<const void*, size_t> roots;
+				// The ok_scanned objects marked but not scanned.
+				std::vector<std::pair<uintptr_t, size_t>> worklist;
+				uintptr_t lowest = UINTPTR_MAX;
+				uintptr_t highest = 0;
+				size_t livebytes = 0;
+				size_t allocated = 0;
+				size_t threshold = MinThreshold;
+				RootScanner scanner;
+			};
+
+			static CollectorData& GetData() {
+				static CollectorData data;
+				return data;
+			}
+
+			void Enable(const RootScanner &scanner) {
+				GetData().scanner = scanner;
+			}
+
+			void* Alloc(size_t size, ObjectKind kind) {
+				CollectorData &data = GetData();
+				size = std::max<size_t>(size, 1);
+				if (data.scanner && data.allocated >= data.threshold)
+					Collect();
+				void *result = DataManage::Alloc(MemorySize(static_cast<Config::MemorySizeType>(size))).get();
+				uintptr_t address = reinterpret_cast<uintptr_t>(result);
+				data.objects.emplace(address, Object { size, kind, false });
+				data.lowest = std::min(data.lowest, address);
+				data.highest = std::max(data.highest, address + size);
+				data.livebytes += size;
+				data.allocated += size;
+				return result;
+			}
+
+			void Free(void *object) {
+				CollectorData &data = GetData();
+				auto iter = data.objects.find(reinterpret_cast<uintptr_t>(object));
+				assert(iter != data.objects.end());
+				data.livebytes -= iter->second.size;
+				data.objects.erase(iter);
+				DataManage::Free(DataPointer(object));
+			}
+
+			void AddRoot(const void *begin, size_t size) {
+				GetData().roots[begin] = size;
+			}
+
+			void RemoveRoot(const void *begin) {
+				GetData().roots.erase(begin);
+			}
+
+			void MarkRange(const void *begin, const void *end) {
+				CollectorData &data = GetData();
+				constexpr uintptr_t Align = sizeof(uintptr_t);
+				uintptr_t p = (reinterpret_cast<uintptr_t>(begin) + (Align - 1)) & ~(Align - 1);
+				uintptr_t last = reinterpret_cast<uintptr_t>(end);
+				for (; p + Align <= last; p += Align) {
+					uintptr_t word = *reinterpret_cast<const uintptr_t*>(p);
+					if (word < data.lowest || word >= data.highest)
+						continue;
+					auto iter = data.objects.upper_bound(word);
+					if (iter == data.objects.begin())
+						continue;
+					--iter;
+					Object &object = iter->second;
+					if (word - iter->first < object.size && !object.marked) {
+						object.marked = true;
+						if (object.kind == ok_scanned)
+							data.worklist.emplace_back(iter->first, object.size);
+					}
+				}
+			}
+
+			void Collect() {
+				CollectorData &data = GetData();
+
+				// Mark
+				DataManage::ScanFrames(MarkRange);
+				const VMStack::StackState &stack = VMStack::CurrentStack;
+				if (stack.begin)
+					MarkRange(stack.top, stack.end);
+				for (auto &root : data.roots)
+					MarkRange(root.first, static_cast<const uint8_t*>(root.first) + root.second);
+				if (data.scanner)
+					data.scanner();
+				while (!data.worklist.empty()) {
+					auto object = data.worklist.back();
+					data.worklist.pop_back();
+					MarkRange(reinterpret_cast<const void*>(object.first), reinterpret_cast<const void*>(object.first + object.second));
+				}
+
+				// Sweep
+				for (auto iter = data.objects.begin(); iter != data.objects.end();) {
+					if (iter->second.marked) {
+						iter->second.marked = false;
+						++iter;
+					}
+					else {
+						data.livebytes -= iter->second.size;
+						DataManage::Free(DataPointer(reinterpret_cast<void*>(iter->first)));
+						iter = data.objects.erase(iter);
+					}
+				}
+				data.allocated = 0;
+				data.threshold = std::max(MinThreshold, data.livebytes);
+			}
+		}
+	}
+}
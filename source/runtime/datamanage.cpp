@@ -1,6 +1,9 @@
 #include "basic.h"
 #include "runtime/datamanage.h"
 #include "compiler/compile.h"
+#include "runtime/heapprofile.h"
+#include "pageprovider.h"
+#include <algorithm>
 
 namespace CVM
 {
@@ -34,7 +37,7 @@ namespace CVM
 	{
 		namespace DataManage {
 			static void CopyTo(DataPointer dst, ConstDataPointer src, MemorySize size) {
-				PriLib::Memory::copyTo(dst.get(), src.get(), size.data);
+				MemoryKernel::Copy(dst.get(), src.get(), size.data);
 			}
 
 			static MemorySize GetSize(Environment &env, const TypeIndex &type) {
@@ -42,17 +45,45 @@ namespace CVM
 			}
 
 			static void Clear(DataPointer dst, MemorySize size) {
-				PriLib::Memory::clear(dst.get(), size.data);
+				MemoryKernel::Clear(dst.get(), size.data);
+			}
+
+			// The single allocation point of the data, recorded after the memory is allocated (and cleared).
+			static DataPointer AllocData(MemorySize size, bool clear) {
+				void *result = clear ? calloc(size.data, 1) : malloc(size.data);
+				if (HeapProfile::IsEnabled())
+					HeapProfile::RecordAlloc(result, size.data, HeapProfile::ak_data);
+				return DataPointer(result);
 			}
 
 			DataPointer Alloc(MemorySize size) {
-				return DataPointer(malloc(size.data));
+				return AllocData(size, false);
 			}
 
 			DataPointer AllocClear(MemorySize size) {
-				return DataPointer(calloc(size.data, 1));
+				return AllocData(size, true);
+			}
+			static PageProvider::PageArena& GetFrameArena() {
+				static PageProvider::PageArena arena;
+				return arena;
+			}
+			DataPointer AllocFrame(MemorySize size, MemorySize align) {
+				DataPointer result(GetFrameArena().alloc(size.data, std::max<size_t>(align.data, 16)));
+				if (HeapProfile::IsEnabled())
+					HeapProfile::RecordAlloc(result.get(), size.data, HeapProfile::ak_frame);
+				return result;
+			}
+			void FreeFrame(DataPointer dp) {
+				if (HeapProfile::IsEnabled())
+					HeapProfile::RecordFree(dp.get());
+				GetFrameArena().free(dp.get());
+			}
+			void ScanFrames(void (*scan)(const void *begin, const void *end)) {
+				GetFrameArena().forEachUsed(scan);
 			}
 			void Free(DataPointer dp) {
+				if (HeapProfile::IsEnabled())
+					HeapProfile::RecordFree(dp.get());
 				std::free(dp.get());
 			}
 
@@ -85,8 +116,8 @@ namespace CVM
 				dst.data = src.data;
 				dst.type = srctype;
 			}
-			void MoveRegisterDsDs(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src, TypeIndex srctype) {
-				CopyTo(dst.data, src.data, GetSize(env, srctype));
+			void MoveRegisterDsDs(Environment &env, DataRegisterStatic &dst, const DataRegisterStatic &src, MemorySize srcsize) {
+				CopyTo(dst.data, src.data, srcsize);
 			}
 
 			template <typename FTy1, typename FTy2>
@@ -105,60 +136,67 @@ namespace CVM
 					[&](DataRegisterDynamic &res) { MoveRegisterDdDd(env, res, src); },
 					[&](DataRegisterStatic &res) { MoveRegisterDsDd(env, res, src); });
 			}
-			void MoveRegisterResDs(Environment &env, const DataRegisterStatic &src, TypeIndex srctype) {
+			void MoveRegisterResDs(Environment &env, const DataRegisterStatic &src, TypeIndex srctype, MemorySize srcsize) {
 				DoResultRegister(env,
 					[&](DataRegisterDynamic &res) { MoveRegisterDdDs(env, res, src, srctype); },
-					[&](DataRegisterStatic &res) { MoveRegisterDsDs(env, res, src, srctype); });
+					[&](DataRegisterStatic &res) { MoveRegisterDsDs(env, res, src, srcsize); });
 			}
 			void MoveRegisterDdRes(Environment &env, DataRegisterDynamic &dst, TypeIndex restype) {
 				DoResultRegister(env,
 					[&](DataRegisterDynamic &res) { MoveRegisterDdDd(env, dst, res); },
 					[&](DataRegisterStatic &res) { MoveRegisterDdDs(env, dst, res, restype); });
 			}
-			void MoveRegisterDsRes(Environment &env, DataRegisterStatic &dst, TypeIndex restype) {
+			void MoveRegisterDsRes(Environment &env, DataRegisterStatic &dst, TypeIndex restype, MemorySize ressize) {
 				DoResultRegister(env,
 					[&](DataRegisterDynamic &res) { MoveRegisterDsDd(env, dst, res); },
-					[&](DataRegisterStatic &res) { MoveRegisterDsDs(env, dst, res, restype); });
+					[&](DataRegisterStatic &res) { MoveRegisterDsDs(env, dst, res, ressize); });
 			}
 
 
-			void LoadDataDd(Environment &env, DataRegisterDynamic &dst, TypeIndex expecttype, ConstDataPointer src, MemorySize srcsize) {
+			void LoadDataDd(Environment &env, DataRegisterDynamic &dst, TypeIndex expecttype, MemorySize expectsize, ConstDataPointer src, MemorySize srcsize) {
 				//Free(dst.data); // TODO : Use LCMM
-				dst.data = AllocClear(GetSize(env, expecttype));  // TODO
-				CopyTo(dst.data, src, MemorySize(std::min(GetSize(env, expecttype).data, srcsize.data)));
+				dst.data = AllocClear(expectsize);  // TODO
+				CopyTo(dst.data, src, MemorySize(std::min(expectsize.data, srcsize.data)));
 				dst.type = expecttype;
 				// TODO!
 			}
-			void LoadDataDs(Environment &env, DataRegisterStatic &dst, TypeIndex dsttype, ConstDataPointer src, MemorySize srcsize) {
-				Clear(dst.data, GetSize(env, dsttype));
-				CopyTo(dst.data, src, MemorySize(std::min(GetSize(env, dsttype).data, srcsize.data)));
+			void LoadDataDs(Environment &env, DataRegisterStatic &dst, MemorySize dstsize, ConstDataPointer src, MemorySize srcsize) {
+				Clear(dst.data, dstsize);
+				CopyTo(dst.data, src, MemorySize(std::min(dstsize.data, srcsize.data)));
 			}
-			void LoadDataRes(Environment &env, TypeIndex restype, ConstDataPointer src, MemorySize srcsize) {
+			void LoadDataRes(Environment &env, TypeIndex restype, MemorySize ressize, ConstDataPointer src, MemorySize srcsize) {
 				DoResultRegister(env,
-					[&](DataRegisterDynamic &res) { LoadDataDd(env, res, restype, src, srcsize); },
-					[&](DataRegisterStatic &res) { LoadDataDs(env, res, restype, src, srcsize); });
+					[&](DataRegisterDynamic &res) { LoadDataDd(env, res, restype, ressize, src, srcsize); },
+					[&](DataRegisterStatic &res) { LoadDataDs(env, res, ressize, src, srcsize); });
 			}
 			void LoadDataPointerDd(Environment &env, DataRegisterDynamic &dst, ConstDataPointer src) {
 				// Only copy pointer
 				//Free(dst.data); // TODO : Use LCMM
 				dst.data = AllocClear(DataPointer::Size); // TODO
 				auto p = src.get();
-				CopyTo(dst.data, ConstDataPointer(&p), DataPointer::Size);
+				MemoryKernel::CopyFixed<sizeof(p)>(dst.data.get(), &p);
 				// TODO : Sign with const data!!!
 			}
-			void LoadDataPointerDs(Environment &env, DataRegisterStatic &dst, TypeIndex dsttype, ConstDataPointer src) {
+			void LoadDataPointerDs(Environment &env, DataRegisterStatic &dst, MemorySize dstsize, ConstDataPointer src) {
 				// Only copy pointer
-				assert(GetSize(env, dsttype) >= DataPointer::Size);
-				Clear(dst.data, GetSize(env, dsttype));
+				assert(dstsize >= DataPointer::Size);
+				Clear(dst.data, dstsize);
 				auto p = src.get();
-				CopyTo(dst.data, ConstDataPointer(&p), DataPointer::Size);
+				MemoryKernel::CopyFixed<sizeof(p)>(dst.data.get(), &p);
 				// TODO : Sign with const data!!!
 			}
-			void LoadDataPointerRes(Environment &env, TypeIndex restype, ConstDataPointer src) {
+			void LoadDataPointerRes(Environment &env, MemorySize ressize, ConstDataPointer src) {
 				// Only copy pointer
 				DoResultRegister(env,
 					[&](DataRegisterDynamic &res) { LoadDataPointerDd(env, res, src); },
-					[&](DataRegisterStatic &res) { LoadDataPointerDs(env, res, restype, src); });
+					[&](DataRegisterStatic &res) { LoadDataPointerDs(env, res, ressize, src); });
+			}
+
+			void LoadField(Environment &env, DataRegisterStatic &dst, ConstDataPointer field, MemorySize size) {
+				CopyTo(dst.data, field, size);
+			}
+			void StoreField(Environment &env, DataPointer field, const DataRegisterStatic &src, MemorySize size) {
+				CopyTo(field, src.data, size);
 			}
 
 			void Debug_PrintRegisterD(Environment &env, const DataRegisterDynamic &src) {
@@ -258,7 +296,7 @@ namespace CVM
 						MoveRegisterDdDs(env, senv->get_dyvarb(arg), env.get_stvarb(*argp), ((Runtime::LocalEnvironment&)env)._func.info().get_stvarb_type(*argp));
 					}
 					else if (senv->is_stvarb(arg) && env.is_stvarb(*argp)) {
-						MoveRegisterDsDs(env, senv->get_stvarb(arg), env.get_stvarb(*argp), ((Runtime::LocalEnvironment&)env)._func.info().get_stvarb_type(*argp));
+						MoveRegisterDsDs(env, senv->get_stvarb(arg), env.get_stvarb(*argp), GetSize(env, ((Runtime::LocalEnvironment&)env)._func.info().get_stvarb_type(*argp)));
 					}
 					else {
 						assert(false);
@@ -277,9 +315,14 @@ namespace CVM
 					aplist_creater.push_back(GetDataPointer(convert(env, arg)));
 				}
 				PointerFunction::ArgumentList aplist = aplist_creater.data();
+				if (HeapProfile::IsEnabled())
+					HeapProfile::RecordAlloc(aplist.get(), aplist.size() * sizeof(DataPointer), HeapProfile::ak_arglist);
 
 				PointerFunction::Result xdst = GetDataPointer(env, GetDstData(dst));
 				fp(xdst, aplist);
+
+				if (HeapProfile::IsEnabled())
+					HeapProfile::RecordFree(aplist.get());
 			}
 
 			void Call(Environment &env, const Runtime::Function &func, const ResultData &dst, const PriLib::lightlist<Config::RegisterIndexType> &arglist) {
@@ -329,6 +372,11 @@ namespace CVM
 				CallBase(env, res, fid, arglist);
 			}
 
+			void BulkSizeOverflow(uint64_t count, MemorySize valsize) {
+				println("Error in bulk instruction of count ", count, " overflow (value size ", valsize.data, ").");
+				exit(-1);
+			}
+
 			void Debug_PrintRegister(Environment &env, const DataRegisterDynamic &src) {
 				PriLib::Output::println(ToStringData(src.data, GetSize(env, src.type)));
 			}
@@ -0,0 +1,275 @@
+#include "basic.h"
+#include "runtime/hashmap.h"
+#include "runtime/collector.h"
+#include "runtime/datamanage.h"
+#include "runtime/stringvalue.h"
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace HashMap
+		{
+			// The control byte is the low 7 bits of the hash if the slot is full,
+			// otherwise Empty or Deleted (with the sign bit set).
+			using Control = int8_t;
+			constexpr Control Empty = -128;
+			constexpr Control Deleted = -2;
+			constexpr size_t GroupWidth = 16;
+			constexpr size_t MinCapacity = GroupWidth;
+
+			struct MapData {
+				MapType type;
+				size_t valoffset;     // The offset of the value in the slot.
+				size_t slotsize;
+				size_t capacity;      // The count of the slots, the power of 2 (at least GroupWidth).
+				size_t size;
+				size_t growthleft;    // The count of Empty slots can be filled before growing.
+				Control *ctrl;
+				uint8_t *slots;
+			};
+
+			static size_t AlignUp(size_t value, size_t align) {
+				return (value + align - 1) / align * align;
+			}
+
+			// Keep the load factor at most 7/8.
+			static size_t GetMaxLoad(size_t capacity) {
+				return capacity - capacity / 8;
+			}
+
+			static size_t GetCapacity(uint64_t count) {
+				size_t capacity = MinCapacity;
+				while (GetMaxLoad(capacity) < count)
+					capacity *= 2;
+				return capacity;
+			}
+
+			[[noreturn]] static void MapError(const char *msg) {
+				println("Error in cms#map ", msg, ".");
+				exit(-1);
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * Group
+			//    The bit i of the mask is set if the control byte i of the group matches.
+			//---------------------------------------------------------------------------------------------
+#if defined(__SSE2__)
+			static uint32_t MatchByte(const Control *group, Control byte) {
+				__m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+				return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(byte))));
+			}
+			// Empty or Deleted.
+			static uint32_t MatchFree(const Control *group) {
+				return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+			}
+#else
+			static uint32_t MatchByte(const Control *group, Control byte) {
+				uint32_t mask = 0;
+				for (size_t i = 0; i != GroupWidth; ++i)
+					mask |= static_cast<uint32_t>(group[i] == byte) << i;
+				return mask;
+			}
+			static uint32_t MatchFree(const Control *group) {
+				uint32_t mask = 0;
+				for (size_t i = 0; i != GroupWidth; ++i)
+					mask |= static_cast<uint32_t>(group[i] < 0) << i;
+				return mask;
+			}
+#endif
+
+			static unsigned int CountTrailingZero(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+				return static_cast<unsigned int>(__builtin_ctz(mask));
+#else
+				unsigned int result = 0;
+				while (!(mask & 1)) {
+					mask >>= 1;
+					++result;
+				}
+				return result;
+#endif
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * Key
+			//---------------------------------------------------------------------------------------------
+			static uint64_t Mix(uint64_t value) {
+				value ^= value >> 33;
+				value *= 0xFF51AFD7ED558CCDull;
+				value ^= value >> 33;
+				value *= 0xC4CEB9FE1A85EC53ull;
+				value ^= value >> 33;
+				return value;
+			}
+
+			static uint64_t HashKey(const MapType &type, const void *key) {
+				if (type.stringkey)
+					return Mix(String::Hash(*static_cast<const String::StringValue*>(key)));
+				const uint8_t *p = static_cast<const uint8_t*>(key);
+				uint64_t result = type.keysize;
+				for (size_t i = 0; i < type.keysize; i += sizeof(uint64_t)) {
+					uint64_t word = 0;
+					std::memcpy(&word, p + i, std::min(sizeof(uint64_t), type.keysize - i));
+					result = Mix(result ^ word);
+				}
+				return result;
+			}
+
+			static bool EqualKey(const MapType &type, const void *lhs, const void *rhs) {
+				if (type.stringkey)
+					return String::Compare(*static_cast<const String::StringValue*>(lhs), *static_cast<const String::StringValue*>(rhs)) == 0;
+				return std::memcmp(lhs, rhs, type.keysize) == 0;
+			}
+
+			static Control GetH2(uint64_t hash) {
+				return static_cast<Control>(hash & 0x7F);
+			}
+
+			static uint8_t* GetSlot(const MapData &map, size_t index) {
+				return map.slots + index * map.slotsize;
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * Table
+			//    The groups are probed in the triangular sequence, which visits all of them.
+			//---------------------------------------------------------------------------------------------
+			static void AllocTable(MapData &map, size_t capacity) {
+				size_t slotoffset = AlignUp(capacity, GroupWidth);
+				// The slots may refer to the other objects (e.g. cms#bigint).
+				uint8_t *table = static_cast<uint8_t*>(Collector::Alloc(slotoffset + capacity * map.slotsize, Collector::ok_scanned));
+				map.ctrl = reinterpret_cast<Control*>(table);
+				map.slots = table + slotoffset;
+				map.capacity = capacity;
+				std::memset(map.ctrl, static_cast<uint8_t>(Empty), capacity);
+				map.growthleft = GetMaxLoad(capacity);
+			}
+
+			// Return the index of the first free slot for the hash.
+			static size_t FindFree(const MapData &map, uint64_t hash) {
+				size_t groupmask = map.capacity / GroupWidth - 1;
+				size_t group = (hash >> 7) & groupmask;
+				for (size_t step = 1;; ++step) {
+					if (uint32_t mask = MatchFree(map.ctrl + group * GroupWidth))
+						return group * GroupWidth + CountTrailingZero(mask);
+					group = (group + step) & groupmask;
+				}
+			}
+
+			static size_t FindIndex(const MapData &map, const void *key, uint64_t hash) {
+				size_t groupmask = map.capacity / GroupWidth - 1;
+				size_t group = (hash >> 7) & groupmask;
+				Control h2 = GetH2(hash);
+				for (size_t step = 1; step <= groupmask + 1; ++step) {
+					const Control *ctrl = map.ctrl + group * GroupWidth;
+					for (uint32_t mask = MatchByte(ctrl, h2); mask; mask &= mask - 1) {
+						size_t index = group * GroupWidth + CountTrailingZero(mask);
+						if (EqualKey(map.type, GetSlot(map, index), key))
+							return index;
+					}
+					if (MatchByte(ctrl, Empty))
+						break;
+					group = (group + step) & groupmask;
+				}
+				return NotFound;
+			}
+
+			// Move the elements to the new table, the Deleted slots are dropped.
+			static void Rehash(MapData &map, size_t capacity) {
+				Control *oldctrl = map.ctrl;
+				uint8_t *oldslots = map.slots;
+				size_t oldcapacity = map.capacity;
+				AllocTable(map, capacity);
+				for (size_t i = 0; i != oldcapacity; ++i) {
+					if (oldctrl[i] < 0)
+						continue;
+					const uint8_t *slot = oldslots + i * map.slotsize;
+					size_t index = FindFree(map, HashKey(map.type, slot));
+					map.ctrl[index] = oldctrl[i];
+					std::memcpy(GetSlot(map, index), slot, map.slotsize);
+					--map.growthleft;
+				}
+				Collector::Free(oldctrl);
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * Map
+			//---------------------------------------------------------------------------------------------
+			MapData* Create(const MapType &type, uint64_t capacity) {
+				if (capacity > (SIZE_MAX >> 4) / (type.keysize + type.valsize + type.valalign))
+					MapError("capacity out of range");
+				MapData *map = static_cast<MapData*>(Collector::Alloc(sizeof(MapData), Collector::ok_scanned));
+				map->type = type;
+				map->valoffset = AlignUp(type.keysize, type.valalign);
+				map->slotsize = std::max<size_t>(AlignUp(map->valoffset + type.valsize, std::max<size_t>(type.valalign, 1)), 1);
+				map->size = 0;
+				// The map is not in any register until returned, so it's kept by the root while the table is allocated.
+				Collector::AddRoot(&map, sizeof(map));
+				AllocTable(*map, GetCapacity(capacity));
+				Collector::RemoveRoot(&map);
+				return map;
+			}
+
+			void Check(const MapData *map, Config::TypeIndexType keytype, Config::TypeIndexType valtype) {
+				if (!map)
+					MapError("not created");
+				if (map->type.keytype != keytype || (valtype != T_Void && map->type.valtype != valtype))
+					MapError("type mismatch");
+			}
+
+			void* Find(const MapData &map, const void *key) {
+				size_t index = FindIndex(map, key, HashKey(map.type, key));
+				return index == NotFound ? nullptr : GetSlot(map, index) + map.valoffset;
+			}
+
+			void* FindOrInsert(MapData &map, const void *key) {
+				uint64_t hash = HashKey(map.type, key);
+				size_t index = FindIndex(map, key, hash);
+				if (index != NotFound)
+					return GetSlot(map, index) + map.valoffset;
+				if (map.growthleft == 0) {
+					// Drop the Deleted slots if they take much of the table, otherwise grow.
+					Rehash(map, map.size < GetMaxLoad(map.capacity) / 2 ? map.capacity : map.capacity * 2);
+				}
+				index = FindFree(map, hash);
+				if (map.ctrl[index] == Empty)
+					--map.growthleft;
+				map.ctrl[index] = GetH2(hash);
+				++map.size;
+				uint8_t *slot = GetSlot(map, index);
+				std::memcpy(slot, key, map.type.keysize);
+				std::memset(slot + map.valoffset, 0, map.type.valsize);
+				return slot + map.valoffset;
+			}
+
+			bool Erase(MapData &map, const void *key) {
+				size_t index = FindIndex(map, key, HashKey(map.type, key));
+				if (index == NotFound)
+					return false;
+				map.ctrl[index] = Deleted;
+				--map.size;
+				return true;
+			}
+
+			uint64_t Size(const MapData &map) {
+				return map.size;
+			}
+
+			uint64_t Next(const MapData &map, uint64_t pos, const void *&key, const void *&value) {
+				for (; pos < map.capacity; ++pos) {
+					if (map.ctrl[pos] >= 0) {
+						const uint8_t *slot = GetSlot(map, static_cast<size_t>(pos));
+						key = slot;
+						value = slot + map.valoffset;
+						return pos;
+					}
+				}
+				return NotFound;
+			}
+		}
+	}
+}
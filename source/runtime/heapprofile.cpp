@@ -0,0 +1,212 @@
+#include "basic.h"
+#include "runtime/heapprofile.h"
+#include <csignal>
+#include <cstdio>
+#include <cinttypes>
+#include <mutex>
+#include <tuple>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace HeapProfile
+		{
+			bool Enabled = false;
+			Site CurrentSite;
+
+			struct SiteKey
+			{
+				Config::FuncIndexType func;
+				Config::LineCountType line;
+				AllocKind kind;
+
+				bool operator<(const SiteKey &other) const {
+					return std::tie(func, line, kind) < std::tie(other.func, other.line, other.kind);
+				}
+			};
+
+			struct SiteStat
+			{
+				uint64_t live_count = 0;
+				uint64_t live_bytes = 0;
+				uint64_t total_count = 0;
+				uint64_t total_bytes = 0;
+			};
+
+			struct ProfileData
+			{
+				std::string filename;
+				std::map<Config::FuncIndexType, std::string> funcnames;
+				std::map<SiteKey, SiteStat> stats;
+				std::map<const void*, std::pair<SiteKey, Config::MemorySizeType>> live;
+				unsigned int dumpcount = 0;
+				std::mutex mutex;
+			};
+
+			static volatile std::sig_atomic_t _signal_received = 0;
+
+			static ProfileData& GetData() {
+				static ProfileData data;
+				return data;
+			}
+
+			static void DumpTo(ProfileData &data, const std::string &filename);
+
+			static void SignalHandler(int) {
+				_signal_received = 1;
+			}
+
+			static void DumpAtExit() {
+				Dump();
+			}
+
+			void Enable(const std::string &filename) {
+				GetData().filename = filename;
+				Enabled = true;
+				std::atexit(DumpAtExit);
+#if defined(SIGUSR1)
+				std::signal(SIGUSR1, SignalHandler);
+#endif
+			}
+
+			void SetFuncName(Config::FuncIndexType func, const std::string &name) {
+				ProfileData &data = GetData();
+				std::lock_guard<std::mutex> lock(data.mutex);
+				data.funcnames[func] = name;
+			}
+
+			void RecordAlloc(void *ptr, Config::MemorySizeType size, AllocKind kind) {
+				if (!Enabled || ptr == nullptr)
+					return;
+				ProfileData &data = GetData();
+				std::lock_guard<std::mutex> lock(data.mutex);
+				SiteKey key { CurrentSite.func, CurrentSite.line, kind };
+				SiteStat &stat = data.stats[key];
+				stat.live_count += 1;
+				stat.live_bytes += size;
+				stat.total_count += 1;
+				stat.total_bytes += size;
+				data.live[ptr] = std::make_pair(key, size);
+			}
+
+			void RecordFree(const void *ptr) {
+				if (!Enabled || ptr == nullptr)
+					return;
+				ProfileData &data = GetData();
+				std::lock_guard<std::mutex> lock(data.mutex);
+				auto iter = data.live.find(ptr);
+				if (iter != data.live.end()) {
+					SiteStat &stat = data.stats[iter->second.first];
+					stat.live_count -= 1;
+					stat.live_bytes -= iter->second.second;
+					data.live.erase(iter);
+				}
+			}
+
+			void CheckSignal() {
+				if (_signal_received) {
+					_signal_received = 0;
+					ProfileData &data = GetData();
+					std::lock_guard<std::mutex> lock(data.mutex);
+					DumpTo(data, data.filename + "." + std::to_string(++data.dumpcount));
+				}
+			}
+
+			// Fake addresses for pprof:
+			//   kind        : 0x1 + kind
+			//   function    : (func + 1) << 32
+			//   instruction : ((func + 1) << 32) | (line + 1)
+			//   no function : 0x100
+			static uint64_t GetKindAddress(AllocKind kind) {
+				return 0x1 + static_cast<uint64_t>(kind);
+			}
+			static uint64_t GetFuncAddress(Config::FuncIndexType func) {
+				if (func == Site::NoFunc)
+					return 0x100;
+				return (static_cast<uint64_t>(func) + 1) << 32;
+			}
+			static uint64_t GetInstAddress(Config::FuncIndexType func, Config::LineCountType line) {
+				if (func == Site::NoFunc)
+					return 0x100;
+				return GetFuncAddress(func) | (static_cast<uint64_t>(line) + 1);
+			}
+
+			static const char* GetKindName(AllocKind kind) {
+				switch (kind) {
+				case ak_data: return "alloc:data";
+				case ak_frame: return "alloc:frame";
+				case ak_arglist: return "alloc:arglist";
+				default: return "alloc:unknown";
+				}
+			}
+			static std::string GetFuncName(const ProfileData &data, Config::FuncIndexType func) {
+				if (func == Site::NoFunc)
+					return "<vm>";
+				auto iter = data.funcnames.find(func);
+				if (iter != data.funcnames.end())
+					return iter->second;
+				return "<func " + std::to_string(func) + ">";
+			}
+
+			static void WriteReport(ProfileData &data, std::FILE *fp) {
+				// Symbol Section
+				std::map<uint64_t, std::string> symbols;
+				for (auto &pair : data.stats) {
+					const SiteKey &key = pair.first;
+					std::string funcname = GetFuncName(data, key.func);
+					symbols[GetKindAddress(key.kind)] = GetKindName(key.kind);
+					symbols[GetFuncAddress(key.func)] = funcname;
+					if (key.func != Site::NoFunc)
+						symbols[GetInstAddress(key.func, key.line)] = funcname + "#" + std::to_string(key.line);
+				}
+				std::fprintf(fp, "--- symbol\n");
+				std::fprintf(fp, "binary=cvm\n");
+				for (auto &pair : symbols) {
+					std::fprintf(fp, "0x%016" PRIx64 " %s\n", pair.first, pair.second.c_str());
+				}
+				std::fprintf(fp, "---\n");
+
+				// Heap Section
+				SiteStat total;
+				for (auto &pair : data.stats) {
+					total.live_count += pair.second.live_count;
+					total.live_bytes += pair.second.live_bytes;
+					total.total_count += pair.second.total_count;
+					total.total_bytes += pair.second.total_bytes;
+				}
+				std::fprintf(fp, "--- heap\n");
+				std::fprintf(fp, "heap profile: %" PRIu64 ": %" PRIu64 " [%" PRIu64 ": %" PRIu64 "] @ heapprofile\n",
+					total.live_count, total.live_bytes, total.total_count, total.total_bytes);
+				for (auto &pair : data.stats) {
+					const SiteKey &key = pair.first;
+					const SiteStat &stat = pair.second;
+					std::fprintf(fp, "%" PRIu64 ": %" PRIu64 " [%" PRIu64 ": %" PRIu64 "] @",
+						stat.live_count, stat.live_bytes, stat.total_count, stat.total_bytes);
+					std::fprintf(fp, " 0x%016" PRIx64, GetKindAddress(key.kind));
+					if (key.func != Site::NoFunc)
+						std::fprintf(fp, " 0x%016" PRIx64, GetInstAddress(key.func, key.line));
+					std::fprintf(fp, " 0x%016" PRIx64 "\n", GetFuncAddress(key.func));
+				}
+			}
+
+			static void DumpTo(ProfileData &data, const std::string &filename) {
+				std::FILE *fp = std::fopen(filename.c_str(), "w");
+				if (fp == nullptr) {
+					std::fprintf(stderr, "Error in open file '%s' for heap profile.\n", filename.c_str());
+					return;
+				}
+				WriteReport(data, fp);
+				std::fclose(fp);
+			}
+
+			void Dump() {
+				if (!Enabled)
+					return;
+				ProfileData &data = GetData();
+				std::lock_guard<std::mutex> lock(data.mutex);
+				DumpTo(data, data.filename);
+			}
+		}
+	}
+}
@@ -0,0 +1,18 @@
+#include "basic.h"
+#include "runtime/instruction.h"
+#include "pageprovider.h"
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		static PageProvider::PageArena& GetCodeArena() {
+			static PageProvider::PageArena arena;
+			return arena;
+		}
+
+		void* Instruction::operator new(std::size_t size) {
+			return GetCodeArena().alloc(size, alignof(std::max_align_t));
+		}
+	}
+}
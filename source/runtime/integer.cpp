@@ -0,0 +1,21 @@
+#include "basic.h"
+#include "runtime/integer.h"
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace Integer
+		{
+			void Overflow(const char *op) {
+				println("Error in integer ", op, " overflow.");
+				exit(-1);
+			}
+
+			void DivideByZero() {
+				println("Error in integer divided by zero.");
+				exit(-1);
+			}
+		}
+	}
+}
@@ -0,0 +1,162 @@
+#include "runtime/memorykernel.h"
+#include <cstring>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace MemoryKernel
+		{
+			constexpr SizeType SmallSize = 32;
+			constexpr SizeType RepMovsbThreshold = 2048;
+
+			//---------------------------------------------------------------------------------------------
+			// * Chunk
+			//---------------------------------------------------------------------------------------------
+#if defined(__AVX2__)
+			constexpr SizeType ChunkSize = 32;
+			using Chunk = __m256i;
+			static Chunk LoadChunk(const uint8_t *p) {
+				return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			}
+			static void StoreChunk(uint8_t *p, Chunk v) {
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+			}
+#elif defined(__SSE2__) || defined(_M_X64)
+			constexpr SizeType ChunkSize = 16;
+			using Chunk = __m128i;
+			static Chunk LoadChunk(const uint8_t *p) {
+				return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			}
+			static void StoreChunk(uint8_t *p, Chunk v) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+			}
+#else
+			constexpr SizeType ChunkSize = 16;
+			struct Chunk { uint8_t data[ChunkSize]; };
+			static Chunk LoadChunk(const uint8_t *p) {
+				Chunk v;
+				std::memcpy(v.data, p, ChunkSize);
+				return v;
+			}
+			static void StoreChunk(uint8_t *p, Chunk v) {
+				std::memcpy(p, v.data, ChunkSize);
+			}
+#endif
+
+			static_assert(ChunkSize <= SmallSize, "The large size must be at least one chunk.");
+
+			//---------------------------------------------------------------------------------------------
+			// * Move
+			//---------------------------------------------------------------------------------------------
+
+			// All the loads are done before the stores, so it's overlap-safe.
+			template <SizeType _size>
+			static void MoveHeadTail(uint8_t *dp, const uint8_t *sp, SizeType size) {
+				uint8_t head[_size], tail[_size];
+				std::memcpy(head, sp, _size);
+				std::memcpy(tail, sp + size - _size, _size);
+				std::memcpy(dp, head, _size);
+				std::memcpy(dp + size - _size, tail, _size);
+			}
+
+			static void MoveSmall(uint8_t *dp, const uint8_t *sp, SizeType size) {
+				if (size >= 16)
+					MoveHeadTail<16>(dp, sp, size);
+				else if (size >= 8)
+					MoveHeadTail<8>(dp, sp, size);
+				else if (size >= 4)
+					MoveHeadTail<4>(dp, sp, size);
+				else if (size >= 2)
+					MoveHeadTail<2>(dp, sp, size);
+				else if (size == 1)
+					*dp = *sp;
+			}
+
+			// Safe if dst is before src. Each chunk is loaded before it's stored,
+			// and the stores only overwrite the bytes of src already loaded.
+			static void MoveForward(uint8_t *dp, const uint8_t *sp, SizeType size) {
+				Chunk tail = LoadChunk(sp + size - ChunkSize);
+				for (SizeType i = 0; i + ChunkSize < size; i += ChunkSize)
+					StoreChunk(dp + i, LoadChunk(sp + i));
+				StoreChunk(dp + size - ChunkSize, tail);
+			}
+
+			// Safe if dst is after src.
+			static void MoveBackward(uint8_t *dp, const uint8_t *sp, SizeType size) {
+				Chunk head = LoadChunk(sp);
+				for (SizeType end = size; end > ChunkSize; end -= ChunkSize)
+					StoreChunk(dp + end - ChunkSize, LoadChunk(sp + end - ChunkSize));
+				StoreChunk(dp, head);
+			}
+
+			// Return false if not supported.
+			static bool MoveRepMovsb(uint8_t *dp, const uint8_t *sp, SizeType size) {
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+				size_t count = size;
+				asm volatile("rep movsb" : "+D"(dp), "+S"(sp), "+c"(count) : : "memory");
+				return true;
+#else
+				return false;
+#endif
+			}
+
+			void Move(void *dst, const void *src, SizeType size) {
+				uint8_t *dp = static_cast<uint8_t*>(dst);
+				const uint8_t *sp = static_cast<const uint8_t*>(src);
+				uintptr_t d = reinterpret_cast<uintptr_t>(dp), s = reinterpret_cast<uintptr_t>(sp);
+				if (d == s)
+					return;
+				if (size <= SmallSize) {
+					MoveSmall(dp, sp, size);
+					return;
+				}
+				if (d < s || d - s >= size) {
+					bool disjoint = d < s ? s - d >= size : true;
+					if (disjoint && size >= RepMovsbThreshold && MoveRepMovsb(dp, sp, size))
+						return;
+					MoveForward(dp, sp, size);
+				}
+				else {
+					MoveBackward(dp, sp, size);
+				}
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * Fill
+			//---------------------------------------------------------------------------------------------
+
+			void Fill(void *dst, const void *value, SizeType valsize, uint64_t count) {
+				uint8_t *dp = static_cast<uint8_t*>(dst);
+				if (valsize == 0 || count == 0)
+					return;
+				uint64_t total = valsize * count;
+				if (ChunkSize % valsize == 0 && total >= ChunkSize) {
+					// The chunk of the repeated value, the offsets of the stores are multiples of valsize.
+					uint8_t pattern[ChunkSize];
+					for (SizeType i = 0; i != ChunkSize; i += valsize)
+						std::memcpy(pattern + i, value, valsize);
+					Chunk v = LoadChunk(pattern);
+					uint64_t i = 0;
+					for (; i + ChunkSize <= total; i += ChunkSize)
+						StoreChunk(dp + i, v);
+					if (i != total)
+						StoreChunk(dp + total - ChunkSize, v);
+					return;
+				}
+				if (total <= SmallSize) {
+					for (uint64_t i = 0; i != count; ++i)
+						Copy(dp + i * valsize, value, valsize);
+					return;
+				}
+				// Copy the filled part to the rest, doubling the size each time.
+				Copy(dp, value, valsize);
+				for (uint64_t filled = valsize; filled < total; ) {
+					uint64_t size = filled < total - filled ? filled : total - filled;
+					Copy(dp + filled, dp, static_cast<SizeType>(size));
+					filled += size;
+				}
+			}
+		}
+	}
+}
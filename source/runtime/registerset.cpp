@@ -1,5 +1,6 @@
 #include "basic.h"
 #include "runtime/registerset.h"
+#include <algorithm>
 
 namespace CVM
 {
@@ -13,20 +14,43 @@ namespace CVM
 			}
 		}
 
-		void DataRegisterSetStatic::initialize(DataPointer address, const SizeList& sizelist) {
-			assert(size() == sizelist.size());
+		static Config::MemorySizeType AlignUp(Config::MemorySizeType value, Config::MemorySizeType align) {
+			return (value + align - 1) / align * align;
+		}
+
+		MemorySize DataRegisterSetStatic::GetFrameSize(const LayoutList &layoutlist) {
+			Config::MemorySizeType offset = 0;
+			for (const auto &layout : layoutlist) {
+				offset = AlignUp(offset, layout.align.data);
+				MemorySize end(offset);
+				end += layout.size;
+				offset = end.data;
+			}
+			return MemorySize(offset);
+		}
+
+		MemorySize DataRegisterSetStatic::GetFrameAlign(const LayoutList &layoutlist) {
+			MemorySize result(1);
+			for (const auto &layout : layoutlist)
+				result = std::max(result, layout.align);
+			return result;
+		}
+
+		void DataRegisterSetStatic::initialize(DataPointer address, const LayoutList &layoutlist) {
+			assert(size() == layoutlist.size());
+			assert(reinterpret_cast<uintptr_t>(address.get()) % GetFrameAlign(layoutlist).data == 0);
 			auto diter = _data.begin();
-			auto siter = sizelist.begin();
-			DataPointer start = address;
+			auto liter = layoutlist.begin();
+			Config::MemorySizeType offset = 0;
+			_address = address;
 			while (diter != _data.end()) {
-				*diter = DataRegisterStatic(address);
-				address = address.offset(siter->data);
+				offset = AlignUp(offset, liter->align.data);
+				*diter = DataRegisterStatic(address.offset(offset));
+				offset += liter->size.data;
 				++diter;
-				++siter;
+				++liter;
 			}
-			auto offset = address.get<byte>() - start.get<byte>();
-			assert(offset <= UINT32_MAX);
-			_memsize = MemorySize(static_cast<uint32_t>(offset));
+			_memsize = MemorySize(offset);
 		}
 	}
 }
@@ -0,0 +1,26 @@
+#include "basic.h"
+#include "runtime/slice.h"
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace Slice
+		{
+			void IndexOutOfRange(uint64_t index, Config::MemoryCountType length) {
+				println("Error in cms#slice index ", index, " out of range (length ", length, ").");
+				exit(-1);
+			}
+
+			void LengthOutOfRange(uint64_t length) {
+				println("Error in cms#slice length ", length, " out of range.");
+				exit(-1);
+			}
+
+			void ElementTypeMismatch(Config::TypeIndexType elemtype, Config::TypeIndexType expecttype) {
+				println("Error in cms#slice element type mismatch (", elemtype, " accessed as ", expecttype, ").");
+				exit(-1);
+			}
+		}
+	}
+}
@@ -0,0 +1,149 @@
+#include "basic.h"
+#include "runtime/stringvalue.h"
+#include "runtime/collector.h"
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace String
+		{
+			static StringValue MakeShort(const char *data, size_t length) {
+				assert(length <= ShortCapacity);
+				StringValue result {};
+				if (length != 0)
+					std::memcpy(result.bytes, data, length);
+				result.bytes[TagOffset] = static_cast<char>(length);
+				return result;
+			}
+
+			static StringValue MakeLong(const char *data, size_t length) {
+				if (length > std::numeric_limits<Config::MemoryCountType>::max()) {
+					println("Error in cms#string length ", length, " out of range.");
+					exit(-1);
+				}
+				Config::MemoryCountType count = static_cast<Config::MemoryCountType>(length);
+				StringValue result {};
+				std::memcpy(result.bytes, &data, sizeof(data));
+				std::memcpy(result.bytes + sizeof(data), &count, sizeof(count));
+				result.bytes[TagOffset] = static_cast<char>(LongTag);
+				return result;
+			}
+
+			StringValue Make(const char *data, size_t length) {
+				if (length <= ShortCapacity)
+					return MakeShort(data, length);
+				return MakeLong(data, length);
+			}
+
+			StringValue FromLiteral(const uint8_t *data, size_t size) {
+				const void *end = std::memchr(data, '\0', size);
+				size_t length = end ? static_cast<const uint8_t*>(end) - data : size;
+				return Make(reinterpret_cast<const char*>(data), length);
+			}
+
+			void Concat(StringValue &dst, const StringValue &lhs, const StringValue &rhs) {
+				size_t lhslength = GetLength(lhs), rhslength = GetLength(rhs);
+				if (rhslength == 0) {
+					dst = lhs;
+					return;
+				}
+				if (lhslength == 0) {
+					dst = rhs;
+					return;
+				}
+				size_t length = lhslength + rhslength;
+				char *data;
+				StringValue result {};
+				if (length <= ShortCapacity) {
+					result.bytes[TagOffset] = static_cast<char>(length);
+					data = result.bytes;
+				}
+				else {
+					data = static_cast<char*>(Collector::Alloc(length));
+					result = MakeLong(data, length);
+				}
+				std::memcpy(data, GetData(lhs), lhslength);
+				std::memcpy(data + lhslength, GetData(rhs), rhslength);
+				dst = result;
+			}
+
+			int Compare(const StringValue &lhs, const StringValue &rhs) {
+				size_t lhslength = GetLength(lhs), rhslength = GetLength(rhs);
+				const char *lhsdata = GetData(lhs), *rhsdata = GetData(rhs);
+				if (lhsdata == rhsdata && lhslength == rhslength)
+					return 0;
+				int result = std::memcmp(lhsdata, rhsdata, std::min(lhslength, rhslength));
+				if (result == 0)
+					return lhslength < rhslength ? -1 : (lhslength > rhslength ? 1 : 0);
+				return result < 0 ? -1 : 1;
+			}
+
+			uint64_t Hash(const StringValue &value) {
+				const uint8_t *data = reinterpret_cast<const uint8_t*>(GetData(value));
+				size_t length = GetLength(value);
+				uint64_t result = 14695981039346656037ull;
+				for (size_t i = 0; i != length; ++i) {
+					result ^= data[i];
+					result *= 1099511628211ull;
+				}
+				return result;
+			}
+
+			void RangeError(uint64_t start, uint64_t length, size_t srclength) {
+				println("Error in cms#string substring (", start, ", ", length, ") out of range (length ", srclength, ").");
+				exit(-1);
+			}
+
+			void Substring(StringValue &dst, const StringValue &src, uint64_t start, uint64_t length) {
+				size_t srclength = GetLength(src);
+				if (start > srclength || length > srclength - start)
+					RangeError(start, length, srclength);
+				// The long substring shares the characters of src.
+				dst = Make(GetData(src) + start, static_cast<size_t>(length));
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * StringTable
+			//    The characters of the interned long strings, which live as long as the program.
+			//---------------------------------------------------------------------------------------------
+			class StringTable
+			{
+			public:
+				const char* intern(std::string_view str) {
+					std::lock_guard<std::mutex> lock(_mutex);
+					auto iter = _table.find(str);
+					if (iter != _table.end())
+						return iter->data();
+					char *data = new char[str.size()];
+					std::memcpy(data, str.data(), str.size());
+					_storage.emplace_back(data);
+					_table.insert(std::string_view(data, str.size()));
+					return data;
+				}
+
+			private:
+				std::unordered_set<std::string_view> _table;
+				std::vector<std::unique_ptr<char[]>> _storage;
+				std::mutex _mutex;
+			};
+
+			static StringTable& GetStringTable() {
+				static StringTable table;
+				return table;
+			}
+
+			StringValue Intern(const StringValue &value) {
+				if (IsShort(value))
+					return value;
+				size_t length = GetLength(value);
+				return MakeLong(GetStringTable().intern(std::string_view(GetData(value), length)), length);
+			}
+		}
+	}
+}
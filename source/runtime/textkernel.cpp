@@ -0,0 +1,233 @@
+#include "basic.h"
+#include "runtime/textkernel.h"
+#include "runtime/vectorkernel.h"
+#include "runtime/simdtarget.h"
+#include <cstring>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace TextKernel
+		{
+			// The vector kernels compare a block of bytes at once, and scan the bits of the mask (by movemask).
+			// The bytes less than a block at the end are done by the scalar kernels.
+
+			//---------------------------------------------------------------------------------------------
+			// * Scalar
+			//---------------------------------------------------------------------------------------------
+			static size_t ScalarFindByte(const char *data, size_t begin, size_t size, char byte) {
+				for (size_t i = begin; i != size; ++i)
+					if (data[i] == byte)
+						return i;
+				return NotFound;
+			}
+
+			static size_t ScalarFind(const char *data, size_t begin, size_t size, const char *needle, size_t needlesize) {
+				for (size_t i = begin; i + needlesize <= size; ++i)
+					if (data[i] == needle[0] && std::memcmp(data + i, needle, needlesize) == 0)
+						return i;
+				return NotFound;
+			}
+
+			static size_t ScalarCountByte(const char *data, size_t begin, size_t size, char byte) {
+				size_t count = 0;
+				for (size_t i = begin; i != size; ++i)
+					count += data[i] == byte;
+				return count;
+			}
+
+			template <char _first>
+			static void ScalarFoldCase(char *dst, const char *src, size_t begin, size_t size) {
+				for (size_t i = begin; i != size; ++i) {
+					char c = src[i];
+					dst[i] = static_cast<unsigned char>(c - _first) < 26 ? static_cast<char>(c ^ 0x20) : c;
+				}
+			}
+
+#if defined(CVM_SIMD_X86)
+			static unsigned int CountTrailingZero(uint32_t mask) {
+				return static_cast<unsigned int>(__builtin_ctz(mask));
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * SSE2
+			//---------------------------------------------------------------------------------------------
+			CVM_TARGET_SSE2 static uint32_t Sse2Match(const char *p, __m128i byte) {
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, byte)));
+			}
+
+			CVM_TARGET_SSE2 static size_t Sse2FindByte(const char *data, size_t size, char byte) {
+				__m128i b = _mm_set1_epi8(byte);
+				size_t i = 0;
+				for (; i + 16 <= size; i += 16) {
+					if (uint32_t mask = Sse2Match(data + i, b))
+						return i + CountTrailingZero(mask);
+				}
+				return ScalarFindByte(data, i, size, byte);
+			}
+
+			// Filter the positions by the first and the last bytes of the needle, then compare them.
+			CVM_TARGET_SSE2 static size_t Sse2Find(const char *data, size_t size, const char *needle, size_t needlesize) {
+				__m128i first = _mm_set1_epi8(needle[0]);
+				__m128i last = _mm_set1_epi8(needle[needlesize - 1]);
+				size_t i = 0;
+				for (; i + needlesize - 1 + 16 <= size; i += 16) {
+					uint32_t mask = Sse2Match(data + i, first) & Sse2Match(data + i + needlesize - 1, last);
+					while (mask) {
+						size_t pos = i + CountTrailingZero(mask);
+						if (std::memcmp(data + pos, needle, needlesize) == 0)
+							return pos;
+						mask &= mask - 1;
+					}
+				}
+				return ScalarFind(data, i, size, needle, needlesize);
+			}
+
+			CVM_TARGET_SSE2 static size_t Sse2CountByte(const char *data, size_t size, char byte) {
+				__m128i b = _mm_set1_epi8(byte);
+				size_t count = 0;
+				size_t i = 0;
+				for (; i + 16 <= size; i += 16)
+					count += static_cast<size_t>(__builtin_popcount(Sse2Match(data + i, b)));
+				return count + ScalarCountByte(data, i, size, byte);
+			}
+
+			// The letter is in [_first, _first + 26), moved to [-128, -102) to be compared as signed.
+			template <char _first>
+			CVM_TARGET_SSE2 static void Sse2FoldCase(char *dst, const char *src, size_t size) {
+				__m128i offset = _mm_set1_epi8(static_cast<char>(-128 - _first));
+				__m128i limit = _mm_set1_epi8(-128 + 26);
+				__m128i flip = _mm_set1_epi8(0x20);
+				size_t i = 0;
+				for (; i + 16 <= size; i += 16) {
+					__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+					__m128i isletter = _mm_cmplt_epi8(_mm_add_epi8(block, offset), limit);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(block, _mm_and_si128(isletter, flip)));
+				}
+				ScalarFoldCase<_first>(dst, src, i, size);
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * AVX2
+			//---------------------------------------------------------------------------------------------
+			CVM_TARGET_AVX2 static uint32_t Avx2Match(const char *p, __m256i byte) {
+				__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, byte)));
+			}
+
+			CVM_TARGET_AVX2 static size_t Avx2FindByte(const char *data, size_t size, char byte) {
+				__m256i b = _mm256_set1_epi8(byte);
+				size_t i = 0;
+				for (; i + 32 <= size; i += 32) {
+					if (uint32_t mask = Avx2Match(data + i, b))
+						return i + CountTrailingZero(mask);
+				}
+				return ScalarFindByte(data, i, size, byte);
+			}
+
+			CVM_TARGET_AVX2 static size_t Avx2Find(const char *data, size_t size, const char *needle, size_t needlesize) {
+				__m256i first = _mm256_set1_epi8(needle[0]);
+				__m256i last = _mm256_set1_epi8(needle[needlesize - 1]);
+				size_t i = 0;
+				for (; i + needlesize - 1 + 32 <= size; i += 32) {
+					uint32_t mask = Avx2Match(data + i, first) & Avx2Match(data + i + needlesize - 1, last);
+					while (mask) {
+						size_t pos = i + CountTrailingZero(mask);
+						if (std::memcmp(data + pos, needle, needlesize) == 0)
+							return pos;
+						mask &= mask - 1;
+					}
+				}
+				return ScalarFind(data, i, size, needle, needlesize);
+			}
+
+			CVM_TARGET_AVX2 static size_t Avx2CountByte(const char *data, size_t size, char byte) {
+				__m256i b = _mm256_set1_epi8(byte);
+				size_t count = 0;
+				size_t i = 0;
+				for (; i + 32 <= size; i += 32)
+					count += static_cast<size_t>(__builtin_popcount(Avx2Match(data + i, b)));
+				return count + ScalarCountByte(data, i, size, byte);
+			}
+
+			template <char _first>
+			CVM_TARGET_AVX2 static void Avx2FoldCase(char *dst, const char *src, size_t size) {
+				__m256i offset = _mm256_set1_epi8(static_cast<char>(-128 - _first));
+				__m256i limit = _mm256_set1_epi8(-128 + 26);
+				__m256i flip = _mm256_set1_epi8(0x20);
+				size_t i = 0;
+				for (; i + 32 <= size; i += 32) {
+					__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+					__m256i isletter = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(block, offset));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(block, _mm256_and_si256(isletter, flip)));
+				}
+				ScalarFoldCase<_first>(dst, src, i, size);
+			}
+#endif
+
+			//---------------------------------------------------------------------------------------------
+			// * Dispatch
+			//---------------------------------------------------------------------------------------------
+			size_t FindByte(const char *data, size_t size, char byte) {
+#if defined(CVM_SIMD_X86)
+				switch (VectorKernel::GetLevel()) {
+				case VectorKernel::vl_avx2: return Avx2FindByte(data, size, byte);
+				case VectorKernel::vl_sse2: return Sse2FindByte(data, size, byte);
+				default: break;
+				}
+#endif
+				return ScalarFindByte(data, 0, size, byte);
+			}
+
+			size_t Find(const char *data, size_t size, const char *needle, size_t needlesize) {
+				if (needlesize == 0)
+					return 0;
+				if (needlesize > size)
+					return NotFound;
+				if (needlesize == 1)
+					return FindByte(data, size, needle[0]);
+#if defined(CVM_SIMD_X86)
+				switch (VectorKernel::GetLevel()) {
+				case VectorKernel::vl_avx2: return Avx2Find(data, size, needle, needlesize);
+				case VectorKernel::vl_sse2: return Sse2Find(data, size, needle, needlesize);
+				default: break;
+				}
+#endif
+				return ScalarFind(data, 0, size, needle, needlesize);
+			}
+
+			size_t CountByte(const char *data, size_t size, char byte) {
+#if defined(CVM_SIMD_X86)
+				switch (VectorKernel::GetLevel()) {
+				case VectorKernel::vl_avx2: return Avx2CountByte(data, size, byte);
+				case VectorKernel::vl_sse2: return Sse2CountByte(data, size, byte);
+				default: break;
+				}
+#endif
+				return ScalarCountByte(data, 0, size, byte);
+			}
+
+			template <char _first>
+			static void FoldCase(char *dst, const char *src, size_t size) {
+#if defined(CVM_SIMD_X86)
+				switch (VectorKernel::GetLevel()) {
+				case VectorKernel::vl_avx2: return Avx2FoldCase<_first>(dst, src, size);
+				case VectorKernel::vl_sse2: return Sse2FoldCase<_first>(dst, src, size);
+				default: break;
+				}
+#endif
+				ScalarFoldCase<_first>(dst, src, 0, size);
+			}
+
+			void ToLower(char *dst, const char *src, size_t size) {
+				FoldCase<'A'>(dst, src, size);
+			}
+
+			void ToUpper(char *dst, const char *src, size_t size) {
+				FoldCase<'a'>(dst, src, size);
+			}
+		}
+	}
+}
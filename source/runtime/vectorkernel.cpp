@@ -0,0 +1,429 @@
+#include "basic.h"
+#include "runtime/vectorkernel.h"
+#include "runtime/simdtarget.h"
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace VectorKernel
+		{
+			//---------------------------------------------------------------------------------------------
+			// * Level
+			//---------------------------------------------------------------------------------------------
+			static VectorLevel DetectLevel() {
+#if defined(CVM_SIMD_X86)
+				__builtin_cpu_init();
+				if (__builtin_cpu_supports("avx2"))
+					return vl_avx2;
+				if (__builtin_cpu_supports("sse2"))
+					return vl_sse2;
+#endif
+				return vl_scalar;
+			}
+
+			VectorLevel GetDetectedLevel() {
+				static const VectorLevel level = DetectLevel();
+				return level;
+			}
+
+			static VectorLevel _level = GetDetectedLevel();
+
+			void SetLevel(VectorLevel level) {
+				_level = level < GetDetectedLevel() ? level : GetDetectedLevel();
+			}
+
+			VectorLevel GetLevel() {
+				return _level;
+			}
+
+			bool ParseLevel(const char *str, VectorLevel &level) {
+				if (std::strcmp(str, "scalar") == 0)
+					level = vl_scalar;
+				else if (std::strcmp(str, "sse2") == 0)
+					level = vl_sse2;
+				else if (std::strcmp(str, "avx2") == 0)
+					level = vl_avx2;
+				else
+					return false;
+				return true;
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * Scalar
+			//    The integer lanes are computed as unsigned (wrapping).
+			//---------------------------------------------------------------------------------------------
+			template <size_t _size> struct UIntOfSize;
+			template <> struct UIntOfSize<1> { using Type = uint8_t; };
+			template <> struct UIntOfSize<2> { using Type = uint16_t; };
+			template <> struct UIntOfSize<4> { using Type = uint32_t; };
+			template <> struct UIntOfSize<8> { using Type = uint64_t; };
+
+			template <typename T>
+			using WideUnsigned = std::conditional_t<(sizeof(T) < sizeof(unsigned int)), unsigned int, typename UIntOfSize<sizeof(T)>::Type>;
+
+			template <typename T>
+			static T LoadLane(const void *p, size_t index) {
+				T result;
+				std::memcpy(&result, static_cast<const uint8_t*>(p) + index * sizeof(T), sizeof(T));
+				return result;
+			}
+			template <typename T>
+			static void StoreLane(void *p, size_t index, T value) {
+				std::memcpy(static_cast<uint8_t*>(p) + index * sizeof(T), &value, sizeof(T));
+			}
+
+			template <typename T>
+			static T Mask(bool value) {
+				T result;
+				std::memset(&result, value ? 0xff : 0x00, sizeof(T));
+				return result;
+			}
+
+			template <VectorOp _op, typename T>
+			static T ScalarApply(T a, T b) {
+				if constexpr (std::is_integral<T>::value && (_op == vo_add || _op == vo_sub || _op == vo_mul)) {
+					using U = WideUnsigned<T>;
+					if constexpr (_op == vo_add)
+						return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+					else if constexpr (_op == vo_sub)
+						return static_cast<T>(static_cast<U>(a) - static_cast<U>(b));
+					else
+						return static_cast<T>(static_cast<U>(a) * static_cast<U>(b));
+				}
+				else if constexpr (_op == vo_add)
+					return a + b;
+				else if constexpr (_op == vo_sub)
+					return a - b;
+				else if constexpr (_op == vo_mul)
+					return a * b;
+				// The same as minps/maxps, the second one is returned if unordered.
+				else if constexpr (_op == vo_min)
+					return a < b ? a : b;
+				else if constexpr (_op == vo_max)
+					return a > b ? a : b;
+				else if constexpr (_op == vo_eq)
+					return Mask<T>(a == b);
+				else
+					return Mask<T>(a < b);
+			}
+
+			template <VectorOp _op, typename T, SizeType _size>
+			static void ScalarBinary(void *dst, const void *lhs, const void *rhs) {
+				for (size_t i = 0; i != _size / sizeof(T); ++i)
+					StoreLane<T>(dst, i, ScalarApply<_op, T>(LoadLane<T>(lhs, i), LoadLane<T>(rhs, i)));
+			}
+
+			template <typename T, SizeType _size>
+			static void ScalarShuffle(void *dst, const void *src, const void *idx) {
+				using Index = typename UIntOfSize<sizeof(T)>::Type;
+				constexpr size_t count = _size / sizeof(T);
+				T result[count];
+				for (size_t i = 0; i != count; ++i) {
+					Index index = LoadLane<Index>(idx, i);
+					result[i] = index < count ? LoadLane<T>(src, static_cast<size_t>(index)) : Mask<T>(false);
+				}
+				std::memcpy(dst, result, _size);
+			}
+
+			template <VectorOp _op, typename T, SizeType _size>
+			static void ScalarReduce(void *dst, const void *src) {
+				T lanes[_size / sizeof(T)];
+				std::memcpy(lanes, src, _size);
+				for (size_t n = _size / sizeof(T); n > 1; n /= 2) {
+					for (size_t i = 0; i != n / 2; ++i)
+						lanes[i] = ScalarApply<_op, T>(lanes[i], lanes[i + n / 2]);
+				}
+				std::memcpy(dst, &lanes[0], sizeof(T));
+			}
+
+#if defined(CVM_SIMD_X86)
+			//---------------------------------------------------------------------------------------------
+			// * SSE2
+			//    A v256 is done as two v128.
+			//---------------------------------------------------------------------------------------------
+			template <VectorOp _op, typename T>
+			constexpr bool HasSse2() {
+				constexpr bool is_float = std::is_floating_point<T>::value;
+				constexpr bool is_signed = std::is_signed<T>::value;
+				switch (_op) {
+				case vo_add: case vo_sub:
+					return true;
+				case vo_mul:
+					return is_float || sizeof(T) == 2;
+				case vo_min: case vo_max:
+					return is_float || (sizeof(T) == 1 && !is_signed) || (sizeof(T) == 2 && is_signed);
+				case vo_eq:
+					return is_float || sizeof(T) <= 4;
+				case vo_lt:
+					return is_float || (is_signed && sizeof(T) <= 4);
+				default:
+					return false;
+				}
+			}
+
+			template <VectorOp _op, typename T>
+			CVM_TARGET_SSE2 static inline __m128i Sse2Apply(__m128i a, __m128i b) {
+				if constexpr (std::is_same<T, float>::value) {
+					__m128 x = _mm_castsi128_ps(a), y = _mm_castsi128_ps(b);
+					if constexpr (_op == vo_add) return _mm_castps_si128(_mm_add_ps(x, y));
+					else if constexpr (_op == vo_sub) return _mm_castps_si128(_mm_sub_ps(x, y));
+					else if constexpr (_op == vo_mul) return _mm_castps_si128(_mm_mul_ps(x, y));
+					else if constexpr (_op == vo_min) return _mm_castps_si128(_mm_min_ps(x, y));
+					else if constexpr (_op == vo_max) return _mm_castps_si128(_mm_max_ps(x, y));
+					else if constexpr (_op == vo_eq) return _mm_castps_si128(_mm_cmpeq_ps(x, y));
+					else return _mm_castps_si128(_mm_cmplt_ps(x, y));
+				}
+				else if constexpr (std::is_same<T, double>::value) {
+					__m128d x = _mm_castsi128_pd(a), y = _mm_castsi128_pd(b);
+					if constexpr (_op == vo_add) return _mm_castpd_si128(_mm_add_pd(x, y));
+					else if constexpr (_op == vo_sub) return _mm_castpd_si128(_mm_sub_pd(x, y));
+					else if constexpr (_op == vo_mul) return _mm_castpd_si128(_mm_mul_pd(x, y));
+					else if constexpr (_op == vo_min) return _mm_castpd_si128(_mm_min_pd(x, y));
+					else if constexpr (_op == vo_max) return _mm_castpd_si128(_mm_max_pd(x, y));
+					else if constexpr (_op == vo_eq) return _mm_castpd_si128(_mm_cmpeq_pd(x, y));
+					else return _mm_castpd_si128(_mm_cmplt_pd(x, y));
+				}
+				else if constexpr (_op == vo_add) {
+					if constexpr (sizeof(T) == 1) return _mm_add_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) return _mm_add_epi16(a, b);
+					else if constexpr (sizeof(T) == 4) return _mm_add_epi32(a, b);
+					else return _mm_add_epi64(a, b);
+				}
+				else if constexpr (_op == vo_sub) {
+					if constexpr (sizeof(T) == 1) return _mm_sub_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) return _mm_sub_epi16(a, b);
+					else if constexpr (sizeof(T) == 4) return _mm_sub_epi32(a, b);
+					else return _mm_sub_epi64(a, b);
+				}
+				else if constexpr (_op == vo_mul) {
+					return _mm_mullo_epi16(a, b);
+				}
+				else if constexpr (_op == vo_min) {
+					if constexpr (sizeof(T) == 1) return _mm_min_epu8(a, b);
+					else return _mm_min_epi16(a, b);
+				}
+				else if constexpr (_op == vo_max) {
+					if constexpr (sizeof(T) == 1) return _mm_max_epu8(a, b);
+					else return _mm_max_epi16(a, b);
+				}
+				else if constexpr (_op == vo_eq) {
+					if constexpr (sizeof(T) == 1) return _mm_cmpeq_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) return _mm_cmpeq_epi16(a, b);
+					else return _mm_cmpeq_epi32(a, b);
+				}
+				else {
+					if constexpr (sizeof(T) == 1) return _mm_cmplt_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) return _mm_cmplt_epi16(a, b);
+					else return _mm_cmplt_epi32(a, b);
+				}
+			}
+
+			template <VectorOp _op, typename T, SizeType _size>
+			CVM_TARGET_SSE2 static void Sse2Binary(void *dst, const void *lhs, const void *rhs) {
+				for (SizeType i = 0; i != _size; i += 16) {
+					__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(static_cast<const uint8_t*>(lhs) + i));
+					__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(static_cast<const uint8_t*>(rhs) + i));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(static_cast<uint8_t*>(dst) + i), Sse2Apply<_op, T>(a, b));
+				}
+			}
+
+			//---------------------------------------------------------------------------------------------
+			// * AVX2
+			//    Only for v256, a v128 is done by SSE2.
+			//---------------------------------------------------------------------------------------------
+			template <VectorOp _op, typename T>
+			constexpr bool HasAvx2() {
+				constexpr bool is_float = std::is_floating_point<T>::value;
+				constexpr bool is_signed = std::is_signed<T>::value;
+				switch (_op) {
+				case vo_add: case vo_sub: case vo_eq:
+					return true;
+				case vo_mul:
+					return is_float || sizeof(T) == 2 || sizeof(T) == 4;
+				case vo_min: case vo_max:
+					return is_float || sizeof(T) <= 4;
+				case vo_lt:
+					return is_float || is_signed;
+				default:
+					return false;
+				}
+			}
+
+			template <VectorOp _op, typename T>
+			CVM_TARGET_AVX2 static inline __m256i Avx2Apply(__m256i a, __m256i b) {
+				if constexpr (std::is_same<T, float>::value) {
+					__m256 x = _mm256_castsi256_ps(a), y = _mm256_castsi256_ps(b);
+					if constexpr (_op == vo_add) return _mm256_castps_si256(_mm256_add_ps(x, y));
+					else if constexpr (_op == vo_sub) return _mm256_castps_si256(_mm256_sub_ps(x, y));
+					else if constexpr (_op == vo_mul) return _mm256_castps_si256(_mm256_mul_ps(x, y));
+					else if constexpr (_op == vo_min) return _mm256_castps_si256(_mm256_min_ps(x, y));
+					else if constexpr (_op == vo_max) return _mm256_castps_si256(_mm256_max_ps(x, y));
+					else if constexpr (_op == vo_eq) return _mm256_castps_si256(_mm256_cmp_ps(x, y, _CMP_EQ_OQ));
+					else return _mm256_castps_si256(_mm256_cmp_ps(x, y, _CMP_LT_OQ));
+				}
+				else if constexpr (std::is_same<T, double>::value) {
+					__m256d x = _mm256_castsi256_pd(a), y = _mm256_castsi256_pd(b);
+					if constexpr (_op == vo_add) return _mm256_castpd_si256(_mm256_add_pd(x, y));
+					else if constexpr (_op == vo_sub) return _mm256_castpd_si256(_mm256_sub_pd(x, y));
+					else if constexpr (_op == vo_mul) return _mm256_castpd_si256(_mm256_mul_pd(x, y));
+					else if constexpr (_op == vo_min) return _mm256_castpd_si256(_mm256_min_pd(x, y));
+					else if constexpr (_op == vo_max) return _mm256_castpd_si256(_mm256_max_pd(x, y));
+					else if constexpr (_op == vo_eq) return _mm256_castpd_si256(_mm256_cmp_pd(x, y, _CMP_EQ_OQ));
+					else return _mm256_castpd_si256(_mm256_cmp_pd(x, y, _CMP_LT_OQ));
+				}
+				else if constexpr (_op == vo_add) {
+					if constexpr (sizeof(T) == 1) return _mm256_add_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) return _mm256_add_epi16(a, b);
+					else if constexpr (sizeof(T) == 4) return _mm256_add_epi32(a, b);
+					else return _mm256_add_epi64(a, b);
+				}
+				else if constexpr (_op == vo_sub) {
+					if constexpr (sizeof(T) == 1) return _mm256_sub_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) return _mm256_sub_epi16(a, b);
+					else if constexpr (sizeof(T) == 4) return _mm256_sub_epi32(a, b);
+					else return _mm256_sub_epi64(a, b);
+				}
+				else if constexpr (_op == vo_mul) {
+					if constexpr (sizeof(T) == 2) return _mm256_mullo_epi16(a, b);
+					else return _mm256_mullo_epi32(a, b);
+				}
+				else if constexpr (_op == vo_min) {
+					if constexpr (std::is_signed<T>::value) {
+						if constexpr (sizeof(T) == 1) return _mm256_min_epi8(a, b);
+						else if constexpr (sizeof(T) == 2) return _mm256_min_epi16(a, b);
+						else return _mm256_min_epi32(a, b);
+					}
+					else {
+						if constexpr (sizeof(T) == 1) return _mm256_min_epu8(a, b);
+						else if constexpr (sizeof(T) == 2) return _mm256_min_epu16(a, b);
+						else return _mm256_min_epu32(a, b);
+					}
+				}
+				else if constexpr (_op == vo_max) {
+					if constexpr (std::is_signed<T>::value) {
+						if constexpr (sizeof(T) == 1) return _mm256_max_epi8(a, b);
+						else if constexpr (sizeof(T) == 2) return _mm256_max_epi16(a, b);
+						else return _mm256_max_epi32(a, b);
+					}
+					else {
+						if constexpr (sizeof(T) == 1) return _mm256_max_epu8(a, b);
+						else if constexpr (sizeof(T) == 2) return _mm256_max_epu16(a, b);
+						else return _mm256_max_epu32(a, b);
+					}
+				}
+				else if constexpr (_op == vo_eq) {
+					if constexpr (sizeof(T) == 1) return _mm256_cmpeq_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) return _mm256_cmpeq_epi16(a, b);
+					else if constexpr (sizeof(T) == 4) return _mm256_cmpeq_epi32(a, b);
+					else return _mm256_cmpeq_epi64(a, b);
+				}
+				else {
+					if constexpr (sizeof(T) == 1) return _mm256_cmpgt_epi8(b, a);
+					else if constexpr (sizeof(T) == 2) return _mm256_cmpgt_epi16(b, a);
+					else if constexpr (sizeof(T) == 4) return _mm256_cmpgt_epi32(b, a);
+					else return _mm256_cmpgt_epi64(b, a);
+				}
+			}
+
+			template <VectorOp _op, typename T>
+			CVM_TARGET_AVX2 static void Avx2Binary(void *dst, const void *lhs, const void *rhs) {
+				__m256i a = _mm256_loadu_si256(static_cast<const __m256i*>(lhs));
+				__m256i b = _mm256_loadu_si256(static_cast<const __m256i*>(rhs));
+				_mm256_storeu_si256(static_cast<__m256i*>(dst), Avx2Apply<_op, T>(a, b));
+			}
+
+			// The shuffle of 32-bit lanes, the lane of an index out of range is cleared.
+			CVM_TARGET_AVX2 static void Avx2Shuffle32(void *dst, const void *src, const void *idx) {
+				__m256i s = _mm256_loadu_si256(static_cast<const __m256i*>(src));
+				__m256i i = _mm256_loadu_si256(static_cast<const __m256i*>(idx));
+				__m256i inrange = _mm256_cmpeq_epi32(_mm256_min_epu32(i, _mm256_set1_epi32(7)), i);
+				_mm256_storeu_si256(static_cast<__m256i*>(dst), _mm256_and_si256(_mm256_permutevar8x32_epi32(s, i), inrange));
+			}
+#endif
+
+			//---------------------------------------------------------------------------------------------
+			// * Select
+			//---------------------------------------------------------------------------------------------
+			template <typename T>
+			struct LaneTag { using Type = T; };
+
+			template <typename Func>
+			static auto DispatchLane(LaneType lane, Func func) {
+				switch (lane) {
+				case lt_int8: return func(LaneTag<int8_t>());
+				case lt_int16: return func(LaneTag<int16_t>());
+				case lt_int32: return func(LaneTag<int32_t>());
+				case lt_int64: return func(LaneTag<int64_t>());
+				case lt_uint8: return func(LaneTag<uint8_t>());
+				case lt_uint16: return func(LaneTag<uint16_t>());
+				case lt_uint32: return func(LaneTag<uint32_t>());
+				case lt_uint64: return func(LaneTag<uint64_t>());
+				case lt_float32: return func(LaneTag<float>());
+				case lt_float64: return func(LaneTag<double>());
+				default: return decltype(func(LaneTag<int8_t>()))(nullptr);
+				}
+			}
+
+			template <VectorOp _op, typename T>
+			static BinaryKernel SelectBinary(SizeType size) {
+#if defined(CVM_SIMD_X86)
+				if constexpr (HasAvx2<_op, T>()) {
+					if (GetLevel() >= vl_avx2 && size == 32)
+						return &Avx2Binary<_op, T>;
+				}
+				if constexpr (HasSse2<_op, T>()) {
+					if (GetLevel() >= vl_sse2)
+						return size == 16 ? &Sse2Binary<_op, T, 16> : &Sse2Binary<_op, T, 32>;
+				}
+#endif
+				return size == 16 ? &ScalarBinary<_op, T, 16> : &ScalarBinary<_op, T, 32>;
+			}
+
+			BinaryKernel GetBinaryKernel(VectorOp op, LaneType lane, SizeType size) {
+				assert(size == 16 || size == 32);
+				return DispatchLane(lane, [=](auto tag) -> BinaryKernel {
+					using T = typename decltype(tag)::Type;
+					switch (op) {
+					case vo_add: return SelectBinary<vo_add, T>(size);
+					case vo_sub: return SelectBinary<vo_sub, T>(size);
+					case vo_mul: return SelectBinary<vo_mul, T>(size);
+					case vo_min: return SelectBinary<vo_min, T>(size);
+					case vo_max: return SelectBinary<vo_max, T>(size);
+					case vo_eq: return SelectBinary<vo_eq, T>(size);
+					case vo_lt: return SelectBinary<vo_lt, T>(size);
+					default: return nullptr;
+					}
+				});
+			}
+
+			ShuffleKernel GetShuffleKernel(LaneType lane, SizeType size) {
+				assert(size == 16 || size == 32);
+				return DispatchLane(lane, [=](auto tag) -> ShuffleKernel {
+					using T = typename decltype(tag)::Type;
+#if defined(CVM_SIMD_X86)
+					if (sizeof(T) == 4 && size == 32 && GetLevel() >= vl_avx2)
+						return &Avx2Shuffle32;
+#endif
+					return size == 16 ? &ScalarShuffle<T, 16> : &ScalarShuffle<T, 32>;
+				});
+			}
+
+			ReduceKernel GetReduceKernel(VectorOp op, LaneType lane, SizeType size) {
+				assert(size == 16 || size == 32);
+				return DispatchLane(lane, [=](auto tag) -> ReduceKernel {
+					using T = typename decltype(tag)::Type;
+					switch (op) {
+					case vo_add: return size == 16 ? &ScalarReduce<vo_add, T, 16> : &ScalarReduce<vo_add, T, 32>;
+					case vo_min: return size == 16 ? &ScalarReduce<vo_min, T, 16> : &ScalarReduce<vo_min, T, 32>;
+					case vo_max: return size == 16 ? &ScalarReduce<vo_max, T, 16> : &ScalarReduce<vo_max, T, 32>;
+					default: return nullptr;
+					}
+				});
+			}
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#include "basic.h"
+#include "runtime/vmstack.h"
+#include "pageprovider.h"
+
+namespace CVM
+{
+	namespace Runtime
+	{
+		namespace VMStack
+		{
+			thread_local StackState CurrentStack;
+
+			static size_t _stacksize = DefaultSize;
+			static thread_local PageProvider::PageBuffer _stackbuffer;
+
+			void SetSize(size_t size) {
+				_stacksize = AlignSize(size);
+			}
+
+			size_t GetSize() {
+				return _stacksize;
+			}
+
+			void Overflow(size_t size) {
+				println("Error in VM stack overflow, allocate ", size, " bytes with ", CurrentStack.top - CurrentStack.begin, " bytes left.");
+				exit(-1);
+			}
+
+			void Underflow(size_t size) {
+				println("Error in VM stack underflow, release ", size, " bytes with ", CurrentStack.base - CurrentStack.top, " bytes allocated by the function.");
+				exit(-1);
+			}
+
+			uint8_t* Enter() {
+				StackState &stack = CurrentStack;
+				if (stack.begin == nullptr) {
+					_stackbuffer.allocate(_stacksize);
+					stack.begin = _stackbuffer.get();
+					stack.end = stack.begin + _stacksize;
+					stack.top = stack.end;
+					stack.base = stack.top;
+				}
+				uint8_t *callerbase = stack.base;
+				stack.base = stack.top;
+				return callerbase;
+			}
+		}
+	}
+}
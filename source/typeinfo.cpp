@@ -5,46 +5,97 @@
 
 namespace CVM
 {
-	static void InsertTypeInside(TypeInfoMap &tim, HashStringPool &hashStringPool);
+	static_assert(sizeof(Runtime::DataPointer) == PointerTypeSize, "The size of builtin pointer types must be the same as DataPointer.");
 
-	TypeInfoMap::TypeInfoMap(HashStringPool &hashStringPool) {
-		InsertTypeInside(*this, hashStringPool);
+	TypeInfoMap::TypeInfoMap(HashStringPool &hashStringPool)
+		: _slots(MinSlotCount, EmptySlot) {
+		_data.reserve(BuiltinTypeCount);
+		for (auto &bt : BuiltinTypes) {
+			TypeInfo info { TypeIndex(bt.index), MemorySize(bt.size) };
+			info.align = MemorySize(bt.size ? bt.size : 1);
+			info.needclear = bt.index == T_BigInt || bt.index == T_Slice || bt.index == T_String || bt.index == T_Map;
+			bool result = insert(hashStringPool.insert(bt.name), info);
+			assert(result);
+		}
 	}
 
 	bool TypeInfoMap::insert(const HashID &nameid, const TypeInfo &info) {
+		TypeIndex id;
+		if (find(nameid, id))
+			return false;
+		assert(_data.size() < EmptySlot);
 		TypeInfo ninfo(info);
-		assert(_data.size() < std::numeric_limits<Config::TypeIndexType>::max());
 		ninfo.index.data = static_cast<Config::TypeIndexType>(_data.size());
 		ninfo.name = nameid;
-		// Insert
-		if (_keymap.find(nameid) != _keymap.end()) {
+		_data.push_back(ninfo);
+		// Keep the load factor not greater than 1/2.
+		if (_data.size() * 2 > _slots.size())
+			rehash(_slots.size() * 2);
+		else
+			place(ninfo.index.data);
+		return true;
+	}
+
+	static Config::MemorySizeType AlignUp(Config::MemorySizeType value, Config::MemorySizeType align) {
+		return (value + align - 1) / align * align;
+	}
+
+	bool TypeInfoMap::addField(TypeIndex type, const HashID &fieldname, TypeIndex fieldtype, const MemorySize *offset) {
+		FieldInfo field;
+		if (findField(type, fieldname, field))
 			return false;
+		TypeInfo &info = _data.at(type.data);
+		const TypeInfo &finfo = _data.at(fieldtype.data);
+		if (info.fieldcount == 0)
+			info.fieldbegin = static_cast<Config::TypeIndexType>(_fields.size());
+		assert(info.fieldbegin + info.fieldcount == _fields.size());
+
+		field.name = fieldname;
+		field.type = fieldtype;
+		if (offset) {
+			field.offset = *offset;
 		}
 		else {
-			_keymap.insert({ nameid, ninfo.index.data });
-			_data.push_back(ninfo);
-			return true;
+			Config::MemorySizeType last = 0;
+			if (info.fieldcount != 0) {
+				const FieldInfo &lastfield = _fields.back();
+				last = lastfield.offset.data + _data[lastfield.type.data].size.data;
+			}
+			field.offset = MemorySize(AlignUp(last, finfo.align.data));
 		}
+		_fields.push_back(field);
+		++info.fieldcount;
+
+		info.align = std::max(info.align, finfo.align);
+		info.needclear = info.needclear || finfo.needclear;
+		MemorySize end = MemorySize(AlignUp(field.offset.data + finfo.size.data, info.align.data));
+		info.size = std::max(info.size, end);
+		return true;
 	}
 
-	static void InsertTypeInside(TypeInfoMap &tim, HashStringPool &hashStringPool) {
-		static TypeInfo tis[] {
-			TypeInfo { TypeIndex(T_Void), MemorySize(0), TypeNameID(hashStringPool.insert("cms#void")) },
-			TypeInfo { TypeIndex(T_Int8), MemorySize(1), TypeNameID(hashStringPool.insert("cms#int8")) },
-			TypeInfo { TypeIndex(T_Int16), MemorySize(2), TypeNameID(hashStringPool.insert("cms#int16")) },
-			TypeInfo { TypeIndex(T_Int32), MemorySize(4), TypeNameID(hashStringPool.insert("cms#int32")) },
-			TypeInfo { TypeIndex(T_Int64), MemorySize(8), TypeNameID(hashStringPool.insert("cms#int64")) },
-			TypeInfo { TypeIndex(T_UInt8), MemorySize(1), TypeNameID(hashStringPool.insert("cms#uint8")) },
-			TypeInfo { TypeIndex(T_UInt16), MemorySize(2), TypeNameID(hashStringPool.insert("cms#uint16")) },
-			TypeInfo { TypeIndex(T_UInt32), MemorySize(4), TypeNameID(hashStringPool.insert("cms#uint32")) },
-			TypeInfo { TypeIndex(T_UInt64), MemorySize(8), TypeNameID(hashStringPool.insert("cms#uint64")) },
-			TypeInfo { TypeIndex(T_Pointer), Runtime::DataPointer::Size, TypeNameID(hashStringPool.insert("cms#pointer")) },
-			TypeInfo { TypeIndex(T_Environment), Runtime::DataPointer::Size, TypeNameID(hashStringPool.insert("cms#environment")) },
-			TypeInfo { TypeIndex(T_VirtualMachine), Runtime::DataPointer::Size, TypeNameID(hashStringPool.insert("cms#virtualmachine")) },
-		};
-
-		for (auto &ti : tis) {
-			tim.insert(ti.name, ti);
+	bool TypeInfoMap::findField(TypeIndex type, const HashID &fieldname, FieldInfo &result) const {
+		const TypeInfo &info = at(type);
+		for (Config::TypeIndexType i = 0; i != info.fieldcount; ++i) {
+			const FieldInfo &field = _fields[info.fieldbegin + i];
+			if (field.name == fieldname) {
+				result = field;
+				return true;
+			}
 		}
+		return false;
+	}
+
+	void TypeInfoMap::place(Config::TypeIndexType index) {
+		size_t mask = _slots.size() - 1;
+		size_t i = Hash(_data[index].name) & mask;
+		while (_slots[i] != EmptySlot)
+			i = (i + 1) & mask;
+		_slots[i] = index;
+	}
+
+	void TypeInfoMap::rehash(size_t slotcount) {
+		_slots.assign(slotcount, EmptySlot);
+		for (size_t i = 0; i != _data.size(); ++i)
+			place(static_cast<Config::TypeIndexType>(i));
 	}
 }